@@ -0,0 +1,453 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+// Measures the performance of the graphics module using a set of standard
+// scenes. The results can be written as JSON to track them across versions.
+//
+// Each measurement is repeated and the fastest run is reported. Codec
+// throughput refers to the size of the uncompressed RGBA8 pixels, which
+// makes the codecs comparable.
+
+// Local includes
+#include "AstUtilsConfig.h"
+#include "AstuGraphics.h"
+#include "Graphics/BmpCodec.h"
+#include "Graphics/PngCodec.h"
+#include "Graphics/QoiCodec.h"
+#include "Graphics/Pattern.h"
+#include "Graphics/PatternRenderer.h"
+#include "Graphics/Quadtree.h"
+
+// C++ Standard Library includes
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace astu;
+
+/** The seed of the random numbers used to create the scenes. */
+#define SCENE_SEED 4711
+
+/////////////////////////////////////////////////
+/////// Results
+/////////////////////////////////////////////////
+
+struct Result {
+    string group;
+    string name;
+    vector<pair<string, double>> metrics;
+};
+
+static vector<Result> results;
+
+/** Whether results are printed as table to standard output. */
+static bool printTable = true;
+
+static void AddResult(const string & group, const string & name,
+    vector<pair<string, double>> metrics)
+{
+    results.push_back({group, name, std::move(metrics)});
+    if (!printTable) {
+        return;
+    }
+
+    cout << left << setw(12) << group << setw(24) << name;
+    for (const auto & m : results.back().metrics) {
+        cout << "  " << m.first << "=" << setprecision(4) << m.second;
+    }
+    cout << endl;
+}
+
+static void WriteNumber(ostream & os, double x)
+{
+    if (std::isfinite(x)) {
+        os << setprecision(9) << x;
+    } else {
+        os << "null";
+    }
+}
+
+/////////////////////////////////////////////////
+/////// Options
+/////////////////////////////////////////////////
+
+struct Options {
+    int width = 1280;
+    int height = 720;
+    int repeat = 3;
+    size_t numThreads = 0;
+    double shapeScale = 1.0;
+    string jsonFile;
+};
+
+static void WriteJson(ostream & os, const Options & options)
+{
+    os << "{" << endl
+       << "  \"version\": \"" << ASTU_VERSION_STRING << "\"," << endl
+       << "  \"width\": " << options.width << "," << endl
+       << "  \"height\": " << options.height << "," << endl
+       << "  \"threads\": " << options.numThreads << "," << endl
+       << "  \"repeat\": " << options.repeat << "," << endl
+       << "  \"shape_scale\": " << options.shapeScale << "," << endl
+       << "  \"results\": [";
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto & r = results[i];
+        os << (i ? "," : "") << endl
+           << "    {\"group\": \"" << r.group << "\", \"name\": \"" << r.name << "\"";
+        for (const auto & m : r.metrics) {
+            os << ", \"" << m.first << "\": ";
+            WriteNumber(os, m.second);
+        }
+        os << "}";
+    }
+    os << endl << "  ]" << endl << "}" << endl;
+}
+
+/////////////////////////////////////////////////
+/////// Helper functions
+/////////////////////////////////////////////////
+
+/**
+ * Runs a function several times and returns the fastest duration in seconds.
+ */
+static double Measure(int repeat, const function<void()> & func)
+{
+    double best = numeric_limits<double>::infinity();
+    for (int i = 0; i < repeat; ++i) {
+        const auto start = chrono::steady_clock::now();
+        func();
+        const chrono::duration<double> d = chrono::steady_clock::now() - start;
+        best = std::min(best, d.count());
+    }
+    return best;
+}
+
+enum class Scene { Lines, Circles, Mixed };
+
+static void DrawScene(ImageRenderer & renderer, Scene scene, size_t n, int width, int height)
+{
+    mt19937 rng(SCENE_SEED);
+    uniform_real_distribution<double> rx(0, width);
+    uniform_real_distribution<double> ry(0, height);
+    uniform_real_distribution<double> rc(0, 1);
+    uniform_real_distribution<double> rs(1, 8);
+
+    auto randomColor = [&]() { return Color4d(rc(rng), rc(rng), rc(rng), 1); };
+    auto drawLine = [&]() {
+        renderer.SetDrawColor(randomColor());
+        const double x = rx(rng), y = ry(rng);
+        renderer.DrawLine(x, y, x + rs(rng) * 8 - 32, y + rs(rng) * 8 - 32, rs(rng) * 0.5);
+    };
+    auto drawCircle = [&]() {
+        renderer.SetDrawColor(randomColor());
+        renderer.DrawCircle(rx(rng), ry(rng), rs(rng));
+    };
+    auto drawRectangle = [&]() {
+        renderer.SetDrawColor(randomColor());
+        renderer.DrawRectangle(rx(rng), ry(rng), rs(rng) * 2, rs(rng) * 2, rc(rng) * 90);
+    };
+
+    switch (scene) {
+    case Scene::Lines:
+        for (size_t i = 0; i < n; ++i) {
+            drawLine();
+        }
+        break;
+
+    case Scene::Circles:
+        for (size_t i = 0; i < n; ++i) {
+            drawCircle();
+        }
+        break;
+
+    case Scene::Mixed:
+        for (size_t i = 0; i < n; ++i) {
+            switch (i % 3) {
+            case 0: drawLine(); break;
+            case 1: drawCircle(); break;
+            default: drawRectangle(); break;
+            }
+        }
+        break;
+    }
+}
+
+static unsigned int SamplesPerPixel(RenderQuality quality)
+{
+    switch (quality) {
+    case RenderQuality::Fast: return 1;
+    case RenderQuality::Simple: return 3 * 3;
+    case RenderQuality::Good: return 5 * 5;
+    case RenderQuality::Beautiful: return 7 * 7;
+    case RenderQuality::Insane: return 9 * 9;
+    }
+    return 1;
+}
+
+/////////////////////////////////////////////////
+/////// Benchmarks
+/////////////////////////////////////////////////
+
+static void BenchmarkScene(const Options & opt, const string & name, Scene scene,
+    size_t n, RenderMethod method, RenderQuality quality)
+{
+    ImageRenderer renderer;
+    renderer.SetNumThreads(opt.numThreads);
+    renderer.SetRenderMethod(method);
+    renderer.SetRenderQuality(quality);
+    Image image(opt.width, opt.height);
+
+    const double tDraw = Measure(1, [&]() { DrawScene(renderer, scene, n, opt.width, opt.height); });
+    const double tFirst = Measure(1, [&]() { renderer.Render(image); });
+    const double tRender = Measure(opt.repeat, [&]() { renderer.Render(image); });
+
+    const double pixels = static_cast<double>(opt.width) * opt.height;
+    vector<pair<string, double>> metrics = {
+        {"shapes", static_cast<double>(n)},
+        {"draw_s", tDraw},
+        {"first_render_s", tFirst},
+        {"render_s", tRender},
+        {"ns_per_pixel", tRender * 1e9 / pixels},
+    };
+    if (method == RenderMethod::Sampling) {
+        metrics.push_back({"samples_per_s", pixels * SamplesPerPixel(quality) / tRender});
+    }
+    AddResult("render", name, std::move(metrics));
+}
+
+static void BenchmarkQuadtree(const Options & opt, size_t n)
+{
+    mt19937 rng(SCENE_SEED);
+    uniform_real_distribution<double> rx(0, opt.width);
+    uniform_real_distribution<double> ry(0, opt.height);
+    uniform_real_distribution<double> rs(1, 8);
+
+    vector<shared_ptr<Pattern>> circles;
+    circles.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto circle = make_shared<CirclePattern>(rs(rng));
+        circle->SetPattern(make_shared<UnicolorPattern>(Color4d(0, 0, 0, 1)));
+        circle->Translate(rx(rng), ry(rng));
+        circles.push_back(circle);
+    }
+
+    Quadtree tree(5, 10);
+    const double tBuild = Measure(opt.repeat, [&]() {
+        tree.Clear();
+        for (auto & circle : circles) {
+            tree.Add(circle);
+        }
+        tree.BuildTree();
+    });
+
+    SimplePatternRenderer renderer;
+    renderer.SetNumThreads(opt.numThreads);
+    Image image(opt.width, opt.height);
+    const double tRender = Measure(opt.repeat, [&]() { renderer.Render(tree, image); });
+
+    const double pixels = static_cast<double>(opt.width) * opt.height;
+    AddResult("quadtree", "circles", {
+        {"shapes", static_cast<double>(n)},
+        {"build_s", tBuild},
+        {"nodes", static_cast<double>(tree.NumberOfNodes())},
+        {"references", static_cast<double>(tree.NumberOfReferences())},
+        {"render_s", tRender},
+        {"ns_per_pixel", tRender * 1e9 / pixels},
+        {"samples_per_s", pixels / tRender},
+    });
+}
+
+template <typename Encoder, typename Decoder>
+static void BenchmarkCodec(const Options & opt, const string & name,
+    const Image & image, const ImageRgba8 & image8, const Encoder & encoder, const Decoder & decoder)
+{
+    const double mb = image.GetWidth() * image.GetHeight() * 4 * 1e-6;
+
+    string encoded;
+    const double tEncode = Measure(opt.repeat, [&]() {
+        ostringstream os;
+        encoder.Encode(image, os);
+        encoded = os.str();
+    });
+    const double tDecode = Measure(opt.repeat, [&]() {
+        istringstream is(encoded);
+        decoder.Decode(is);
+    });
+    const double tEncode8 = Measure(opt.repeat, [&]() {
+        ostringstream os;
+        encoder.Encode(image8, os);
+    });
+    const double tDecode8 = Measure(opt.repeat, [&]() {
+        istringstream is(encoded);
+        decoder.DecodeRgba8(is);
+    });
+
+    AddResult("codec", name, {
+        {"encoded_bytes", static_cast<double>(encoded.size())},
+        {"encode_mb_per_s", mb / tEncode},
+        {"decode_mb_per_s", mb / tDecode},
+        {"encode_rgba8_mb_per_s", mb / tEncode8},
+        {"decode_rgba8_mb_per_s", mb / tDecode8},
+    });
+}
+
+static void BenchmarkCodecs(const Options & opt)
+{
+    ImageRenderer renderer;
+    renderer.SetNumThreads(opt.numThreads);
+    DrawScene(renderer, Scene::Mixed, static_cast<size_t>(3000 * opt.shapeScale), opt.width, opt.height);
+    Image image(opt.width, opt.height);
+    renderer.Render(image);
+    ImageRgba8 image8(opt.width, opt.height);
+    ConvertImage(image, image8);
+
+    BenchmarkCodec(opt, "bmp", image, image8, BmpEncoder(), BmpDecoder());
+    BenchmarkCodec(opt, "png", image, image8, PngEncoder(), PngDecoder());
+    BenchmarkCodec(opt, "qoi", image, image8, QoiEncoder(), QoiDecoder());
+}
+
+static void BenchmarkPalette(const Options & opt, size_t n)
+{
+    Palette palette(WebColors::Black, WebColors::White);
+    palette.AddColor(WebColors::Red, 0.25);
+    palette.AddColor(WebColors::Orange, 0.4);
+    palette.AddColor(WebColors::Yellow, 0.55);
+    palette.AddColor(WebColors::Green, 0.7);
+    palette.AddColor(WebColors::Blue, 0.85);
+    const BakedPalette baked = palette.Bake(1024);
+
+    mt19937 rng(SCENE_SEED);
+    uniform_real_distribution<double> rt(0, 1);
+    vector<double> ts(n);
+    for (auto & t : ts) {
+        t = rt(rng);
+    }
+    vector<Color4d> colors(n);
+
+    const double tSingle = Measure(opt.repeat, [&]() {
+        for (size_t i = 0; i < n; ++i) {
+            colors[i] = palette.GetColor(ts[i]);
+        }
+    });
+    const double tBatch = Measure(opt.repeat, [&]() {
+        palette.GetColors(ts.data(), colors.data(), n);
+    });
+    const double tBaked = Measure(opt.repeat, [&]() {
+        baked.GetColors(ts.data(), colors.data(), n);
+    });
+
+    AddResult("palette", "lookup", {
+        {"lookups", static_cast<double>(n)},
+        {"get_color_ns", tSingle * 1e9 / n},
+        {"get_colors_ns", tBatch * 1e9 / n},
+        {"baked_ns", tBaked * 1e9 / n},
+    });
+}
+
+/////////////////////////////////////////////////
+/////// Main
+/////////////////////////////////////////////////
+
+static void PrintUsage(const char* program)
+{
+    cerr << "Usage: " << program << " [options]" << endl
+         << "Options:" << endl
+         << "  -s <w>x<h>   image size (default 1280x720)" << endl
+         << "  -r <n>       number of repetitions per measurement (default 3)" << endl
+         << "  -j <n>       number of threads, 0 for all cores (default 0)" << endl
+         << "  -q           quick run with a tenth of the shapes" << endl
+         << "  -o <file>    writes the results as JSON, '-' for standard output" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    Options opt;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const bool hasValue = i + 1 < argc;
+            if (strcmp(argv[i], "-q") == 0) {
+                opt.shapeScale = 0.1;
+            } else if (strcmp(argv[i], "-s") == 0 && hasValue) {
+                const string size = argv[++i];
+                const auto x = size.find('x');
+                if (x == string::npos) {
+                    PrintUsage(argv[0]);
+                    return 1;
+                }
+                opt.width = stoi(size.substr(0, x));
+                opt.height = stoi(size.substr(x + 1));
+            } else if (strcmp(argv[i], "-r") == 0 && hasValue) {
+                opt.repeat = std::max(1, stoi(argv[++i]));
+            } else if (strcmp(argv[i], "-j") == 0 && hasValue) {
+                opt.numThreads = stoul(argv[++i]);
+            } else if (strcmp(argv[i], "-o") == 0 && hasValue) {
+                opt.jsonFile = argv[++i];
+            } else {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+        }
+
+        // Keep the table off standard output in case it receives the JSON.
+        printTable = opt.jsonFile != "-";
+
+        const auto scaled = [&opt](size_t n) { return static_cast<size_t>(n * opt.shapeScale); };
+
+        BenchmarkScene(opt, "lines_10k", Scene::Lines, scaled(10000), RenderMethod::Sampling, RenderQuality::Good);
+        BenchmarkScene(opt, "lines_10k_coverage", Scene::Lines, scaled(10000), RenderMethod::Coverage, RenderQuality::Good);
+        BenchmarkScene(opt, "circles_100k", Scene::Circles, scaled(100000), RenderMethod::Sampling, RenderQuality::Good);
+        BenchmarkScene(opt, "circles_100k_coverage", Scene::Circles, scaled(100000), RenderMethod::Coverage, RenderQuality::Good);
+        BenchmarkScene(opt, "mixed_3k", Scene::Mixed, scaled(3000), RenderMethod::Sampling, RenderQuality::Good);
+        BenchmarkScene(opt, "mixed_3k_coverage", Scene::Mixed, scaled(3000), RenderMethod::Coverage, RenderQuality::Good);
+
+        const pair<RenderQuality, const char*> qualities[] = {
+            {RenderQuality::Fast, "quality_fast"},
+            {RenderQuality::Simple, "quality_simple"},
+            {RenderQuality::Good, "quality_good"},
+            {RenderQuality::Beautiful, "quality_beautiful"},
+            {RenderQuality::Insane, "quality_insane"},
+        };
+        for (const auto & q : qualities) {
+            BenchmarkScene(opt, q.second, Scene::Mixed, scaled(3000), RenderMethod::Sampling, q.first);
+        }
+
+        BenchmarkQuadtree(opt, scaled(100000));
+        BenchmarkCodecs(opt);
+        BenchmarkPalette(opt, 1000000);
+
+        if (opt.jsonFile == "-") {
+            WriteJson(cout, opt);
+        } else if (!opt.jsonFile.empty()) {
+            ofstream ofs(opt.jsonFile);
+            if (!ofs) {
+                cerr << "Unable to open file '" << opt.jsonFile << "'" << endl;
+                return 1;
+            }
+            WriteJson(ofs, opt);
+        }
+    } catch (const std::exception & e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
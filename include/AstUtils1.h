@@ -16,6 +16,31 @@ namespace astu1 {
     using astu::Image;
     using astu::Color;
 
+    /**
+     * Describes the memory of a locked image, see LockImage().
+     * 
+     * The color components of the pixels are stored as 64-bit 
+     * floating-point values in the order red, green, blue and alpha.
+     * The component `c` of the pixel at `(x, y)` is located at
+     * `data[y * rowStride + x * pixelStride + c]`.
+     */
+    struct ImageView {
+        /** The address of the red component of the upper left pixel. */
+        double* data;
+
+        /** The width of the image in pixels. */
+        int width;
+
+        /** The height of the image in pixels. */
+        int height;
+
+        /** The distance between adjacent pixels, in components. */
+        int pixelStride;
+
+        /** The distance between adjacent rows, in components. */
+        int rowStride;
+    };
+
     /**
      * Reads an image file.
      * 
@@ -33,7 +58,10 @@ namespace astu1 {
     const char* GetLastErrorX();
 
     /**
-     * Loads a BMP image from a file.
+     * Loads an image from a file.
+     * 
+     * PNG and QOI files are recognized by their extension, all other 
+     * files are loaded as BMP files.
      * 
      * @param filename  the filename including the path
      * @return the handle to the image, or 0 if the operation failed
@@ -43,6 +71,9 @@ namespace astu1 {
     /**
      * Stores an image to a file.
      * 
+     * The extensions `.png` and `.qoi` select the PNG or QOI format, all
+     * other files are stored as BMP files.
+     * 
      * @param filename  the filename including the path
      * @return returns 0 on success or a negative error code on failure
      */
@@ -100,6 +131,29 @@ namespace astu1 {
      */
     int ImportRgbFloats(int hImg, float* ptr);
 
+    /**
+     * Provides direct access to the pixels of an image.
+     * 
+     * The view refers to the memory of the image itself, no pixels are 
+     * copied. Changes made through the view become visible immediately.
+     * The view remains valid until the image gets unlocked. Locked 
+     * images cannot be destroyed. An image can be locked several times,
+     * each lock must be released by a call to UnlockImage().
+     * 
+     * @param hImg  the handle of the image
+     * @param view  receives the description of the image memory
+     * @return returns 0 on success or a negative error code on failure
+     */
+    int LockImage(int hImg, ImageView* view);
+
+    /**
+     * Releases a lock acquired by LockImage().
+     * 
+     * @param hImg  the handle of the image
+     * @return returns 0 on success or a negative error code on failure
+     */
+    int UnlockImage(int hImg);
+
     /**
      * Frees the memory allocated by 32-bit floating point RGB values.
      * 
@@ -28,7 +28,11 @@
 #include "Graphics/RalColors.h"
 #include "Graphics/Palette.h"
 #include "Graphics/Image.h"
+#include "Graphics/PixelImage.h"
+#include "Graphics/AccumulationBuffer.h"
 #include "Graphics/ImageRenderer.h"
+#include "Graphics/ImageProcessor.h"
+#include "Graphics/BatchConverter.h"
 
 namespace astu {
 
@@ -39,16 +43,27 @@ namespace astu {
      */
 
     /**
-     * Stores an image as BMP file.
+     * Stores an image to a file.
      * 
-     * @param image     the the image to be stored
-     * @param filename  the filename including the path
+     * The file format is selected by the extension of the filename, which
+     * is not case-sensitive: `.png` stores a PNG file, `.qoi` a QOI file.
+     * All other extensions store an uncompressed 24-bit BMP file.
+     * 
+     * @param image             the the image to be stored
+     * @param filename          the filename including the path
+     * @param compressionLevel  the compression level within the range
+     *                          [0, 9], only used for PNG files
      * @throws std::runtime_error in case of an I/O error
+     * @throws std::domain_error in case the compression level is invalid
      */
-    void StoreImage(const Image &image, const std::string &filename);
+    void StoreImage(const Image &image, const std::string &filename, int compressionLevel = 6);
 
     /**
-     * Loads an BMP image from file.
+     * Loads an image from file.
+     * 
+     * The file format is selected by the extension of the filename, which
+     * is not case-sensitive: `.png` loads a PNG file, `.qoi` a QOI file. 
+     * All other extensions load a BMP file.
      * 
      * @param filename  the filename including the path
      * @return the loaded image
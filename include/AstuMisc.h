@@ -21,6 +21,7 @@
 #include "Util/Pooled.h"
 #include "Util/VersionInfo.h"
 #include "Util/StringUtils.h"
+#include "Util/ThreadPool.h"
 
 namespace astu {
 
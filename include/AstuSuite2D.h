@@ -16,6 +16,7 @@
 #include "Graphics/WebColors.h"
 #include "Suite2D/PolygonVertexBuffer.h"
 #include "Suite2D/Scene.h"
+#include "Suite2D/ImageSceneRenderer2D.h"
 #include "Suite2D/CPose.h"
 #include "Suite2D/CScene.h"
 #include "Suite2D/CameraService.h"
@@ -53,6 +54,8 @@ namespace astu {
      * - astu::suite2d::LineRenderer
      * - astu::suite2d::SceneGraph
      * - astu::suite2d::SceneRenderer2D
+     * - astu::suite2d::ImageSceneRenderer2D
+     * - astu::suite2d::ImageVertexBufferBuilderService2D
      * - astu::suite2d::Spatial
      * - astu::suite2d::Node
      * - astu::suite2d::NodeBuilder
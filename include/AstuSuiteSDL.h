@@ -20,6 +20,7 @@
 #include "SuiteSDL/SdlRenderService.h"
 #include "SuiteSDL/SdlTimeService.h"
 #include "SuiteSDL/SdlLineRenderer.h"
+#include "SuiteSDL/SdlImageLayer.h"
 #include "SuiteSDL/SdlSceneGraph2D.h"
 #include "SuiteSDL/SdlApplication.h"
 
@@ -0,0 +1,151 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+#pragma once
+
+// Local includes
+#include "Graphics/Image.h"
+#include "Graphics/PixelImage.h"
+
+// C++ Standard Library includes
+#include <vector>
+
+namespace astu {
+
+    /**
+     * Averages a sequence of images, e.g., to compose motion blur from
+     * several subframes.
+     *
+     * The images are summed up in a buffer of single-precision components
+     * and divided by the number of accumulated images when the result is
+     * resolved. The cost of accumulating an image is proportional to the
+     * number of pixels, regardless of the image content.
+     *
+     * **Example**
+     *
+     * ```
+     * AccumulationBuffer accu(width, height);
+     * for (const auto & subframe : subframes) {
+     *     // ... render subframe into image
+     *     accu.Add(image);
+     * }
+     * accu.Resolve(result);
+     * ```
+     *
+     * @ingroup gfx_group
+     */
+    class AccumulationBuffer final {
+    public:
+
+        /**
+         * Constructor.
+         *
+         * @param w the width of the buffer in pixels
+         * @param h the height of the buffer in pixels
+         * @throws std::domain_error in case the width or height is invalid
+         */
+        AccumulationBuffer(int w, int h);
+
+        /**
+         * Returns the width of this buffer.
+         *
+         * @return the width in pixels
+         */
+        int GetWidth() const {
+            return width;
+        }
+
+        /**
+         * Returns the height of this buffer.
+         *
+         * @return the height in pixels
+         */
+        int GetHeight() const {
+            return height;
+        }
+
+        /**
+         * Returns the number of images accumulated since the last clear.
+         *
+         * @return the number of accumulated images
+         */
+        int NumberOfImages() const {
+            return numImages;
+        }
+
+        /**
+         * Discards all accumulated images.
+         */
+        void Clear();
+
+        /**
+         * Adds an image to this buffer.
+         *
+         * @param image the image to add
+         * @throws std::domain_error in case the dimensions do not match
+         */
+        void Add(const Image & image);
+
+        /**
+         * Adds an 8-bit image to this buffer.
+         *
+         * @param image the image to add
+         * @throws std::domain_error in case the dimensions do not match
+         */
+        void Add(const ImageRgba8 & image);
+
+        /**
+         * Stores the average of the accumulated images.
+         *
+         * @param result    receives the average
+         * @throws std::domain_error in case the dimensions do not match or
+         *      no image has been accumulated
+         */
+        void Resolve(Image & result) const;
+
+        /**
+         * Stores the average of the accumulated images as 8-bit image.
+         *
+         * @param result    receives the average
+         * @throws std::domain_error in case the dimensions do not match or
+         *      no image has been accumulated
+         */
+        void Resolve(ImageRgba8 & result) const;
+
+    private:
+        /** The width of the buffer in pixel. */
+        int width;
+
+        /** The height of the buffer in pixel. */
+        int height;
+
+        /** The number of accumulated images. */
+        int numImages;
+
+        /** The sums of the color components, four per pixel. */
+        std::vector<float> sums;
+
+        /**
+         * Validates the dimensions of an image.
+         *
+         * @param w the width of the image
+         * @param h the height of the image
+         * @throws std::domain_error in case the dimensions do not match
+         */
+        void ValidateDimensions(int w, int h) const;
+
+        /**
+         * Validates that the buffer is ready to be resolved.
+         *
+         * @param w the width of the result image
+         * @param h the height of the result image
+         * @throws std::domain_error in case the buffer cannot be resolved
+         */
+        void ValidateResolve(int w, int h) const;
+    };
+
+} // end of namespace
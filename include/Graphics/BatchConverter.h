@@ -0,0 +1,234 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+#pragma once
+
+// Local includes
+#include "Graphics/Image.h"
+
+// C++ Standard Library includes
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace astu {
+
+    // Forward declaration
+    class ThreadPool;
+
+    /**
+     * Summarizes the conversion of a batch of image files.
+     *
+     * @ingroup gfx_group
+     */
+    struct BatchStatistics {
+        /** The number of successfully converted files. */
+        size_t numFrames = 0;
+
+        /** The number of files which could not be converted. */
+        size_t numFailed = 0;
+
+        /** The number of bytes read from successfully converted files. */
+        uint64_t bytesRead = 0;
+
+        /** The number of bytes written. */
+        uint64_t bytesWritten = 0;
+
+        /** The duration of the conversion in seconds. */
+        double seconds = 0;
+
+        /** The error messages of failed files, prefixed by the filename. */
+        std::vector<std::string> errors;
+
+        /**
+         * Returns the throughput of the conversion based on the bytes read.
+         *
+         * @return the throughput in megabytes (10^6 bytes) per second
+         */
+        double MegabytesPerSecond() const {
+            return seconds > 0 ? bytesRead / seconds * 1e-6 : 0;
+        }
+
+        /**
+         * Returns the number of converted frames per second.
+         *
+         * @return the frames per second
+         */
+        double FramesPerSecond() const {
+            return seconds > 0 ? numFrames / seconds : 0;
+        }
+    };
+
+    /**
+     * Converts a batch of image files concurrently, e.g., frames recorded
+     * by a renderer.
+     *
+     * Each worker thread decodes one file at a time, applies the optional
+     * transformation and encodes the result to the output directory. The
+     * number of images held in memory is therefore limited to the number
+     * of workers. Every worker uses its own set of encoders and decoders
+     * for all of its files. The file formats are selected by the file
+     * extension, like LoadImage() and StoreImage() do.
+     *
+     * **Example**
+     *
+     * ```
+     * BatchConverter converter;
+     * converter.SetOutputExtension("png");
+     * converter.SetTransform([](Image & image) {
+     *     ImageProcessor proc(1);
+     *     proc.ApplyGamma(image, image, 2.2);
+     * });
+     *
+     * auto stats = converter.ConvertDirectory("frames", "converted");
+     * std::cout << stats.FramesPerSecond() << " frames/s" << std::endl;
+     * ```
+     *
+     * @ingroup gfx_group
+     */
+    class BatchConverter final {
+    public:
+
+        /**
+         * Type alias for image transformations.
+         *
+         * Transformations are called concurrently by the worker threads.
+         */
+        using Transform = std::function<void(Image &)>;
+
+        /**
+         * Constructor.
+         *
+         * @param numThreads    the number of worker threads, zero selects
+         *                      the number of hardware threads
+         */
+        BatchConverter(size_t numThreads = 0);
+
+        /**
+         * Destructor.
+         */
+        ~BatchConverter();
+
+        /**
+         * Sets the number of worker threads.
+         *
+         * @param n the number of threads, zero selects the number of
+         *          hardware threads, one converts on the calling thread
+         */
+        void SetNumThreads(size_t n);
+
+        /**
+         * Returns the number of worker threads.
+         *
+         * @return the number of threads, zero means hardware threads
+         */
+        size_t GetNumThreads() const {
+            return numThreads;
+        }
+
+        /**
+         * Sets the file extension of the converted files, which selects
+         * the output format.
+         *
+         * @param extension the file extension without dot, either "bmp",
+         *                  "png" or "qoi", case is ignored
+         * @throws std::domain_error in case the extension is not supported
+         */
+        void SetOutputExtension(const std::string & extension);
+
+        /**
+         * Returns the file extension of the converted files.
+         *
+         * @return the lower-case file extension without dot
+         */
+        const std::string & GetOutputExtension() const {
+            return outputExtension;
+        }
+
+        /**
+         * Sets the compression level used for PNG files.
+         *
+         * @param level the compression level within the range [0, 9]
+         * @throws std::domain_error in case the level is invalid
+         */
+        void SetCompressionLevel(int level);
+
+        /**
+         * Returns the compression level used for PNG files.
+         *
+         * @return the compression level
+         */
+        int GetCompressionLevel() const {
+            return compressionLevel;
+        }
+
+        /**
+         * Sets the transformation applied to each image before it gets
+         * encoded.
+         *
+         * @param transform the transformation or `nullptr`
+         */
+        void SetTransform(Transform transform) {
+            this->transform = transform;
+        }
+
+        /**
+         * Converts a list of image files.
+         *
+         * The converted files have the same names as the input files
+         * with the output extension. Files which cannot be converted are
+         * reported by the returned statistics. This includes files whose
+         * names differ only in the extension from a preceding file, which
+         * would overwrite its output.
+         *
+         * @param filenames         the files to convert
+         * @param outputDirectory   the directory receiving the converted
+         *                          files, created if necessary
+         * @return the statistics of the conversion
+         * @throws std::runtime_error in case the output directory cannot
+         *      be created
+         */
+        BatchStatistics Convert(
+            const std::vector<std::string> & filenames, const std::string & outputDirectory);
+
+        /**
+         * Converts all BMP, PNG and QOI files of a directory.
+         *
+         * The files are processed in alphabetical order.
+         *
+         * @param inputDirectory    the directory containing the files
+         * @param outputDirectory   the directory receiving the converted files
+         * @return the statistics of the conversion
+         * @throws std::runtime_error in case the input directory cannot be
+         *      read or the output directory cannot be created
+         */
+        BatchStatistics ConvertDirectory(
+            const std::string & inputDirectory, const std::string & outputDirectory);
+
+    private:
+        /** Holds the encoders and decoders of one worker thread. */
+        struct Worker;
+
+        /** The number of worker threads, zero means hardware threads. */
+        size_t numThreads;
+
+        /** The thread pool running the workers, created on demand. */
+        std::unique_ptr<ThreadPool> threadPool;
+
+        /** The file extension of the converted files. */
+        std::string outputExtension;
+
+        /** The compression level used for PNG files. */
+        int compressionLevel;
+
+        /** The optional transformation applied to each image. */
+        Transform transform;
+    };
+
+} // end of namespace
@@ -114,6 +114,26 @@ namespace astu {
          */
         size_t NumberOfPixels() const;
 
+        /**
+         * Provides unchecked access to a row of pixels.
+         * 
+         * @param y the index of the row, must be within [0, height)
+         * @return pointer to the first pixel of the row
+         */
+        Color4d* GetRow(int y) {
+            return data.data() + static_cast<size_t>(y) * width;
+        }
+
+        /**
+         * Provides unchecked access to a row of pixels.
+         * 
+         * @param y the index of the row, must be within [0, height)
+         * @return pointer to the first pixel of the row
+         */
+        const Color4d* GetRow(int y) const {
+            return data.data() + static_cast<size_t>(y) * width;
+        }
+
         /**
          * This method provides raw access to the pixel colors, use with care.
          * 
@@ -0,0 +1,218 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+#pragma once
+
+// Local includes
+#include "Graphics/Image.h"
+
+// C++ Standard Library includes
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace astu {
+
+    // Forward declaration
+    class ThreadPool;
+
+    /**
+     * The filters used to resample images.
+     *
+     * @ingroup gfx_group
+     */
+    enum class ResizeFilter {
+        /** Linear interpolation, fast but slightly blurry. */
+        Bilinear,
+
+        /** Lanczos filter with three lobes, sharp but slower. */
+        Lanczos,
+    };
+
+    /**
+     * Applies image processing operations to entire images, e.g., to
+     * post-process rendered frames.
+     *
+     * The operations process images row by row as flat arrays of color
+     * components and distribute the rows among several threads. Results
+     * are written to preallocated images, most operations also accept the
+     * same image as source and destination. The alpha channel is processed
+     * like any other color component unless stated otherwise.
+     *
+     * **Example**
+     *
+     * ```
+     * ImageProcessor proc;
+     * proc.GaussianBlur(frame, frame, 2.0);
+     * proc.ApplyGamma(frame, frame, 2.2);
+     *
+     * Image thumbnail(frame.GetWidth() / 4, frame.GetHeight() / 4);
+     * proc.Resize(frame, thumbnail);
+     * ```
+     *
+     * @ingroup gfx_group
+     */
+    class ImageProcessor final {
+    public:
+
+        /**
+         * Constructor.
+         *
+         * @param numThreads    the number of threads, zero selects the
+         *                      number of hardware threads
+         */
+        ImageProcessor(size_t numThreads = 0);
+
+        /**
+         * Destructor.
+         */
+        ~ImageProcessor();
+
+        /**
+         * Sets the number of threads used for processing.
+         *
+         * @param n the number of threads, zero selects the number of
+         *          hardware threads, one processes on the calling thread
+         */
+        void SetNumThreads(size_t n);
+
+        /**
+         * Returns the number of threads used for processing.
+         *
+         * @return the number of threads, zero means hardware threads
+         */
+        size_t GetNumThreads() const {
+            return numThreads;
+        }
+
+        /**
+         * Blurs an image using a Gaussian filter.
+         *
+         * The filter extends to three standard deviations, pixels beyond
+         * the image borders are replaced by the nearest border pixel.
+         *
+         * @param src   the source image
+         * @param dst   receives the blurred image, may be the source image
+         * @param sigma the standard deviation of the filter in pixels
+         * @throws std::domain_error in case the dimensions of the images
+         *      differ or sigma is less or equal zero
+         */
+        void GaussianBlur(const Image & src, Image & dst, double sigma);
+
+        /**
+         * Blurs an image using a box filter.
+         *
+         * Each pixel becomes the average of the square of (2r + 1)^2
+         * pixels around it. The cost does not depend on the radius.
+         *
+         * @param src       the source image
+         * @param dst       receives the blurred image, may be the source image
+         * @param radius    the radius of the box in pixels
+         * @throws std::domain_error in case the dimensions of the images
+         *      differ or the radius is negative
+         */
+        void BoxBlur(const Image & src, Image & dst, int radius);
+
+        /**
+         * Resamples an image to the dimensions of the destination image.
+         *
+         * The filter gets widened when an image is downsized, which avoids
+         * aliasing. The Lanczos filter might produce values slightly
+         * outside the range [0, 1] close to sharp edges.
+         *
+         * @param src       the source image
+         * @param dst       receives the resampled image
+         * @param filter    the resampling filter
+         * @throws std::domain_error in case source and destination are
+         *      the same image
+         */
+        void Resize(const Image & src, Image & dst, ResizeFilter filter = ResizeFilter::Lanczos);
+
+        /**
+         * Adjusts hue, saturation and brightness of an image.
+         *
+         * The colors are converted to the HSV color space, see ColorHsv.
+         * The alpha channel remains unchanged.
+         *
+         * @param src               the source image
+         * @param dst               receives the result, may be the source image
+         * @param hueShift          the angle in degrees added to the hue
+         * @param saturationFactor  the factor applied to the saturation,
+         *                          the result gets clamped to [0, 1]
+         * @param valueFactor       the factor applied to the value
+         * @throws std::domain_error in case the dimensions of the images differ
+         */
+        void AdjustHsv(const Image & src, Image & dst,
+            double hueShift, double saturationFactor, double valueFactor);
+
+        /**
+         * Blends an image over another image.
+         *
+         * Colors are composited using the alpha channel of the source
+         * image (Porter-Duff 'over' operation). Parts of the source image
+         * which lie outside the destination image are ignored.
+         *
+         * @param src       the image to draw
+         * @param dst       the image to draw onto
+         * @param x         the column of the destination receiving the
+         *                  left border of the source image
+         * @param y         the row of the destination receiving the upper
+         *                  border of the source image
+         * @param opacity   the factor applied to the alpha channel of the
+         *                  source image
+         * @throws std::domain_error in case source and destination are
+         *      the same image
+         */
+        void Composite(const Image & src, Image & dst, int x = 0, int y = 0, double opacity = 1.0);
+
+        /**
+         * Applies gamma correction to the color components of an image.
+         *
+         * Each color component c becomes c^(1 / gamma), negative values
+         * become zero. A gamma of 2.2 encodes linear intensities for
+         * display, a gamma of 1 / 2.2 decodes them. The alpha channel
+         * remains unchanged.
+         *
+         * @param src   the source image
+         * @param dst   receives the result, may be the source image
+         * @param gamma the gamma value
+         * @throws std::domain_error in case the dimensions of the images
+         *      differ or the gamma value is less or equal zero
+         */
+        void ApplyGamma(const Image & src, Image & dst, double gamma);
+
+    private:
+        /** The number of threads, zero means hardware threads. */
+        size_t numThreads;
+
+        /** The thread pool used for processing, created on demand. */
+        std::unique_ptr<ThreadPool> threadPool;
+
+        /** Intermediate results of separable filters, reused between calls. */
+        std::vector<Color4d> scratch;
+
+        /**
+         * Processes a range of rows concurrently.
+         *
+         * @param numRows   the number of rows
+         * @param func      the function which processes the rows `[y0, y1)`
+         */
+        void ProcessRows(int numRows, const std::function<void(int, int)> & func);
+
+        /**
+         * Convolves an image with a symmetric kernel horizontally and
+         * vertically.
+         *
+         * @param src       the source image
+         * @param dst       receives the result
+         * @param kernel    the kernel weights, an odd number
+         */
+        void ConvolveSeparable(const Image & src, Image & dst, const std::vector<double> & kernel);
+    };
+
+} // end of namespace
@@ -19,15 +19,20 @@
 #include "Graphics/Color.h"
 
 // C++ Standard Library includes
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace astu {
 
     // Forward declaration
+    class Pattern;
     class UnionPattern;
     class UnicolorPattern;
     class Quadtree;
-    class IPatternRenderer;
+    class TiledPatternRenderer;
+    class CoverageRasterizer;
 
     /**
      * This class can be used to render geometric primitives in an resolution independent way.
@@ -109,9 +114,24 @@ namespace astu {
 
         /**
          * Clear the output rendering.
+         * 
+         * The memory used to store graphical elements is kept and reused
+         * by subsequent drawing calls.
          */
         void Clear();
 
+        /**
+         * Reserves memory for graphical elements.
+         * 
+         * Drawing calls do not allocate memory as long as the reserved
+         * number of elements is not exceeded.
+         * 
+         * @param numLines      the number of lines
+         * @param numCircles    the number of circles
+         * @param numRectangles the number of rectangles
+         */
+        void Reserve(size_t numLines, size_t numCircles = 0, size_t numRectangles = 0);
+
         /**
          * Sets the current draw color.
          * 
@@ -152,18 +172,21 @@ namespace astu {
          * @param cx    the x-coordinate of the center of the circle
          * @param cy    the y-coordinate of the center of the circle
          * @param r     the radius of the circle
+         * @return the identifier of the circle
+         * @throws std::domain_error in case the radius is less or equal zero
          */
-        void DrawCircle(double cx, double cy, double r);
+        size_t DrawCircle(double cx, double cy, double r);
 
         /**
          * Draws a filled circle.
          * 
          * @param c the center of the circle
          * @param r the radius of the circle
+         * @return the identifier of the circle
          */
-        void DrawCircle(const Vector2<double> &c, double r)
+        size_t DrawCircle(const Vector2<double> &c, double r)
         {
-            DrawCircle(c.x, c.y, r);
+            return DrawCircle(c.x, c.y, r);
         }
 
         /**
@@ -172,9 +195,10 @@ namespace astu {
          * @param p0    the start point of the line
          * @param p1    the end point of the line
          * @param w     the width of the line
+         * @return the identifier of the line
          */
-        void DrawLine(const Vector2<double> &p0, const Vector2<double> & p1, double w = 1) {
-            DrawLine(p0.x, p0.y, p1.x, p1.y, w);
+        size_t DrawLine(const Vector2<double> &p0, const Vector2<double> & p1, double w = 1) {
+            return DrawLine(p0.x, p0.y, p1.x, p1.y, w);
         }
 
         /**
@@ -185,8 +209,10 @@ namespace astu {
          * @param x1    the x-coordinate of the end point of the line
          * @param y1    the y-coordinate of the end point of the line
          * @param w     the width of the line
+         * @return the identifier of the line
+         * @throws std::domain_error in case the width is less or equal zero
          */
-        void DrawLine(double x0, double y0, double x1, double y1, double w = 1);
+        size_t DrawLine(double x0, double y0, double x1, double y1, double w = 1);
 
         /**
          * Draws a filled rectangle.
@@ -196,8 +222,11 @@ namespace astu {
          * @param w     the width of the rectangle
          * @param h     the height of the rectangle
          * @param angleDeg  the rotation angle in degrees
+         * @return the identifier of the rectangle
+         * @throws std::domain_error in case the width or height is less or 
+         *      equal zero
          */
-        void DrawRectangle(double cx, double cy, double w, double h, double angleDeg = 0);
+        size_t DrawRectangle(double cx, double cy, double w, double h, double angleDeg = 0);
 
         /**
          * Draws a rectangle with the current draw color.
@@ -206,11 +235,38 @@ namespace astu {
          * @param w         the width of the rectangle
          * @param h         the height of the rectangle
          * @param angleDeg  the rotation angle in degrees
+         * @return the identifier of the rectangle
          */
-        void DrawRectangle(const Vector2<double> & center, double w, double h, double angleDeg = 0) {
-            DrawRectangle(center.x, center.y, w, h, angleDeg);
+        size_t DrawRectangle(const Vector2<double> & center, double w, double h, double angleDeg = 0) {
+            return DrawRectangle(center.x, center.y, w, h, angleDeg);
         }
 
+        /**
+         * Moves a graphical element.
+         * 
+         * The identifiers of graphical elements are returned by the drawing
+         * methods and remain valid until Clear() gets called. Moving an
+         * element does not change the order in which elements are blended.
+         * Once the image has been rendered, moving or removing an element
+         * only updates the parts of the scene quadtree covering the element.
+         * 
+         * @param id    the identifier of the element
+         * @param dx    the offset along the x-axis
+         * @param dy    the offset along the y-axis
+         * @throws std::out_of_range in case the identifier is invalid or
+         *      the element has been removed
+         */
+        void MoveShape(size_t id, double dx, double dy);
+
+        /**
+         * Removes a graphical element.
+         * 
+         * @param id    the identifier of the element
+         * @throws std::out_of_range in case the identifier is invalid or
+         *      the element has already been removed
+         */
+        void RemoveShape(size_t id);
+
         /**
          * Sets the render quality used to create the image.
          * 
@@ -227,6 +283,47 @@ namespace astu {
             return quality;
         }
 
+        /**
+         * Sets the method used to render the image.
+         * 
+         * @param method    the render method
+         */
+        void SetRenderMethod(RenderMethod method) {
+            fullRedraw |= renderMethod != method;
+            renderMethod = method;
+        }
+
+        /**
+         * Returns the method used to render the image.
+         * 
+         * @return the render method
+         */
+        RenderMethod GetRenderMethod() const {
+            return renderMethod;
+        }
+
+        /**
+         * Enables or disables adaptive supersampling.
+         * 
+         * If enabled, the full anti-aliasing kernel is only evaluated in
+         * regions which are not uniformly colored. This speeds up rendering 
+         * about two to three times, but features smaller than the spacing 
+         * of the kernel samples might get lost.
+         * Has no effect for render quality `Fast`.
+         * 
+         * @param b set to `true` to enable adaptive supersampling
+         */
+        void SetAdaptiveSampling(bool b);
+
+        /**
+         * Returns whether adaptive supersampling is enabled.
+         * 
+         * @return `true` if adaptive supersampling is enabled
+         */
+        bool IsAdaptiveSampling() const {
+            return adaptiveSampling;
+        }
+
         /**
          * Returns the maximum recursion depth of the scene quadtree.
          * 
@@ -246,6 +343,52 @@ namespace astu {
          */
         void SetQuadtreeDepth(unsigned int depth);
 
+        /**
+         * Sets the number of threads used to render the image.
+         * 
+         * @param n the number of threads, zero selects the number of
+         *          hardware threads, one renders on the calling thread
+         */
+        void SetNumThreads(size_t n);
+
+        /**
+         * Returns the number of threads used to render the image.
+         * 
+         * @return the number of threads, zero means hardware threads
+         */
+        size_t GetNumThreads() const {
+            return numThreads;
+        }
+
+        /**
+         * Sets the edge length of the square tiles which are rendered 
+         * concurrently.
+         * 
+         * @param size  the tile size in pixels
+         * @throws std::domain_error in case the size is less than one
+         */
+        void SetTileSize(int size);
+
+        /**
+         * Returns the edge length of the tiles which are rendered 
+         * concurrently.
+         * 
+         * @return the tile size in pixels
+         */
+        int GetTileSize() const {
+            return tileSize;
+        }
+
+        /**
+         * Sets a callback which receives the rendering progress.
+         * 
+         * The progress is reported as value within the range [0, 1] on
+         * the thread which called Render().
+         * 
+         * @param callback  the progress callback or `nullptr`
+         */
+        void SetProgressCallback(std::function<void(double)> callback);
+
         /**
          * Renders the image.
          * 
@@ -253,10 +396,76 @@ namespace astu {
          */
         void Render(Image & img);
 
+        /**
+         * Renders the parts of the image which have changed since the
+         * last rendering.
+         * 
+         * Only the tiles touched by graphical elements which have been
+         * drawn, moved or removed since the last call to Render() or
+         * RenderIncremental() are rendered again, all other pixels remain
+         * unchanged. The image must therefore contain the result of the
+         * last rendering. The whole image is rendered in case the
+         * dimensions of the image, the background color or the render
+         * settings have changed or Clear() has been called.
+         * 
+         * **Example**
+         * 
+         * ```
+         * size_t id = renderer.DrawCircle(x, y, 10);
+         * renderer.Render(image);
+         * for (...) {
+         *     renderer.MoveShape(id, 1, 0);
+         *     renderer.RenderIncremental(image);
+         * }
+         * ```
+         * 
+         * @param img   image containing the result of the last rendering
+         */
+        void RenderIncremental(Image & img);
+
     private:
+        /** A line submitted by DrawLine(). */
+        struct LineShape {
+            double x0, y0, x1, y1, w;
+            Color4d color;
+        };
+
+        /** A circle submitted by DrawCircle(). */
+        struct CircleShape {
+            double cx, cy, r;
+            Color4d color;
+        };
+
+        /** A rectangle submitted by DrawRectangle(). */
+        struct RectangleShape {
+            double cx, cy, w, h, phi;
+            Color4d color;
+        };
+
+        /** The types of graphical elements. */
+        enum class ShapeType : uint32_t { Line, Circle, Rectangle };
+
+        /** References a graphical element in the order of submission. */
+        struct ShapeRef {
+            ShapeType type;
+            uint32_t index;
+            bool removed;
+        };
+
+        /** A region of the image which needs to be rendered again. */
+        struct DirtyRegion {
+            double minX, minY, maxX, maxY;
+        };
+
+        /** Holds the patterns built from the graphical elements. */
+        struct PatternStorage;
+
         /** The render quality. */
         RenderQuality quality;
 
+        /** The render method. */
+        RenderMethod renderMethod;
+
         /** The current drawing color. */
         Color4d drawColor;
 
@@ -273,10 +482,111 @@ namespace astu {
         std::shared_ptr<Quadtree> quadtree;
 
         /** Used to render the image. */
-        std::unique_ptr<IPatternRenderer> renderer;
+        std::unique_ptr<TiledPatternRenderer> renderer;
+
+        /** Used to render the image using the coverage method. */
+        std::unique_ptr<CoverageRasterizer> rasterizer;
 
         /** The maximum recursion depth for the scene quadtree. */
         unsigned int  quadtreeDepth;
+
+        /** The number of threads used for rendering. */
+        size_t numThreads;
+
+        /** Whether adaptive supersampling is enabled. */
+        bool adaptiveSampling;
+
+        /** The edge length of the tiles in pixels. */
+        int tileSize;
+
+        /** Receives the rendering progress. */
+        std::function<void(double)> progressCallback;
+
+        /** The submitted lines. */
+        std::vector<LineShape> lines;
+
+        /** The submitted circles. */
+        std::vector<CircleShape> circles;
+
+        /** The submitted rectangles. */
+        std::vector<RectangleShape> rectangles;
+
+        /** The order in which graphical elements have been submitted. */
+        std::vector<ShapeRef> order;
+
+        /** The patterns referenced by the quadtree. */
+        std::unique_ptr<PatternStorage> patterns;
+
+        /** Whether the quadtree reflects the submitted elements. */
+        bool patternsValid;
+
+        /** Whether the rasterizer reflects the submitted elements. */
+        bool rasterizerValid;
+
+        /** The regions changed since the last rendering. */
+        std::vector<DirtyRegion> dirtyRegions;
+
+        /** Whether the whole image must be rendered again. */
+        bool fullRedraw;
+
+        /** The width of the last rendered image. */
+        int renderedWidth;
+
+        /** The height of the last rendered image. */
+        int renderedHeight;
+
+        /**
+         * Adds a graphical element.
+         * 
+         * @param type  the type of the element
+         * @param index the index of the element within its array
+         * @return the identifier of the element
+         */
+        size_t AddShape(ShapeType type, size_t index);
+
+        /**
+         * Returns a graphical element which has not been removed.
+         * 
+         * @param id    the identifier of the element
+         * @return the reference to the element
+         * @throws std::out_of_range in case the identifier is invalid
+         */
+        ShapeRef & GetShape(size_t id);
+
+        /**
+         * Marks the region covered by a graphical element as changed.
+         * 
+         * @param ref   the element
+         */
+        void MarkDirty(const ShapeRef & ref);
+
+        /**
+         * Builds the patterns and the quadtree for the submitted elements.
+         */
+        void BuildPatterns();
+
+        /**
+         * Places the pattern of a graphical element at the current position
+         * of the element. The color of the pattern is retained.
+         * 
+         * @param ref       the element
+         * @param pattern   the rectangle or circle pattern of the element
+         */
+        void PlacePattern(const ShapeRef & ref, Pattern & pattern) const;
+
+        /**
+         * Updates the pattern and the quadtree after an element has been
+         * moved or removed. The patterns are marked as invalid if the
+         * quadtree needs to be rebuilt.
+         * 
+         * @param id    the identifier of the element
+         */
+        void UpdatePattern(size_t id);
+
+        /**
+         * Passes the submitted elements to the coverage rasterizer.
+         */
+        void BuildRasterizer();
     };
 
 } // end of namespace
\ No newline at end of file
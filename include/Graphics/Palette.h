@@ -9,12 +9,17 @@
 
 // Local includes
 #include "Graphics/Color.h"
+#include "Graphics/PixelImage.h"
 #include "Graphics/WebColors.h"
 
 // C++ Standard Library includes
+#include <cstddef>
 #include <vector>
 
 namespace astu {
+
+    // Forward declaration.
+    class BakedPalette;
     
     /**
      * A Palette represents a set of colors used to create color transitions.
@@ -81,6 +86,32 @@ namespace astu {
          */
         Color4d GetColor(double pos) const;
 
+        /**
+         * Extracts several colors from this palette.
+         * 
+         * This method yields the same colors as GetColor() but avoids the
+         * overhead of individual calls.
+         * 
+         * @param t     the positions within this palette [0, 1]
+         * @param out   receives the requested colors
+         * @param n     the number of colors to extract
+         */
+        void GetColors(const double* t, Color4d* out, size_t n) const;
+
+        /**
+         * Creates a lookup table of the colors of this palette.
+         * 
+         * Lookup tables trade accuracy for speed, they are intended for
+         * mapping large numbers of values to colors, e.g., for rendering
+         * fractals or heat maps. The lookup table is independent of this 
+         * palette, later changes of this palette do not affect it.
+         * 
+         * @param resolution    the number of colors of the lookup table
+         * @return the lookup table
+         * @throws std::domain_error in case the resolution is less than two
+         */
+        BakedPalette Bake(size_t resolution = 256) const;
+
         /**
          * Returns the number of colors in this palette.
          * 
@@ -164,4 +195,120 @@ namespace astu {
         void FindBoundaries(double pos, const Entry *&e1, const Entry *&e2) const;
     };
 
+    /**
+     * An immutable lookup table of colors, created by Palette::Bake().
+     * 
+     * Positions are mapped to the nearest of the evenly spaced colors of 
+     * the table. The colors are stored as single-precision and 8-bit 
+     * colors, a table with the default resolution of 256 colors occupies
+     * 5 KB and stays within the first level cache.
+     * 
+     * **Example**
+     * 
+     * ```
+     * Palette palette(WebColors::Black, WebColors::White);
+     * palette.AddColor(WebColors::Red, 0.5);
+     * BakedPalette lut = palette.Bake();
+     * 
+     * // Map one row of iteration counts to colors.
+     * lut.GetColors(values, image.GetRow(y), image.GetWidth());
+     * ```
+     * 
+     * @ingroup gfx_group
+     */
+    class BakedPalette final {
+    public:
+
+        /**
+         * Returns the number of colors of this lookup table.
+         * 
+         * @return the resolution of this lookup table
+         */
+        size_t GetResolution() const {
+            return colors.size();
+        }
+
+        /**
+         * Returns the color at the specified position.
+         * 
+         * The specified position gets clamped to the range [0, 1].
+         * 
+         * @param t the position within the palette [0, 1]
+         * @return the nearest color of the lookup table
+         */
+        const Color4f & GetColor(double t) const {
+            return colors[ToIndex(t)];
+        }
+
+        /**
+         * Returns the 8-bit color at the specified position.
+         * 
+         * The specified position gets clamped to the range [0, 1].
+         * 
+         * @param t the position within the palette [0, 1]
+         * @return the nearest color of the lookup table
+         */
+        const Rgba8 & GetColorRgba8(double t) const {
+            return colors8[ToIndex(t)];
+        }
+
+        /**
+         * Maps several positions to colors.
+         * 
+         * @param t     the positions within the palette [0, 1]
+         * @param out   receives the colors
+         * @param n     the number of positions
+         */
+        void GetColors(const double* t, Color4d* out, size_t n) const;
+
+        /**
+         * Maps several positions to colors.
+         * 
+         * @param t     the positions within the palette [0, 1]
+         * @param out   receives the colors
+         * @param n     the number of positions
+         */
+        void GetColors(const double* t, Color4f* out, size_t n) const;
+
+        /**
+         * Maps several positions to 8-bit colors.
+         * 
+         * @param t     the positions within the palette [0, 1]
+         * @param out   receives the colors
+         * @param n     the number of positions
+         */
+        void GetColors(const double* t, Rgba8* out, size_t n) const;
+
+    private:
+        /** The colors of this lookup table. */
+        std::vector<Color4f> colors;
+
+        /** The colors of this lookup table with 8 bits per component. */
+        std::vector<Rgba8> colors8;
+
+        /** Scales positions to indices. */
+        double scale;
+
+        /**
+         * Constructor, used by Palette::Bake().
+         * 
+         * @param palette       the palette to sample
+         * @param resolution    the number of colors
+         */
+        BakedPalette(const Palette & palette, size_t resolution);
+
+        /**
+         * Maps a position to the index of the nearest color.
+         * 
+         * @param t the position, gets clamped to [0, 1]
+         * @return the index of the color
+         */
+        size_t ToIndex(double t) const {
+            t = (t < 0.0) ? 0.0 : (1.0 < t) ? 1.0 : t;
+            return static_cast<size_t>(t * scale + 0.5);
+        }
+
+        friend class Palette;
+    };
+
 }
\ No newline at end of file
@@ -0,0 +1,365 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+#pragma once
+
+// C++ Library includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Local includes
+#include "Graphics/Color.h"
+#include "Graphics/Image.h"
+
+namespace astu {
+
+    /**
+     * Enumeration of pixel formats supported by pixel images.
+     *
+     * @ingroup gfx_group
+     */
+    enum class PixelFormat {
+        /** Four 8-bit unsigned normalized components, 4 bytes per pixel. */
+        RGBA8,
+
+        /** Four 16-bit floating-point components, 8 bytes per pixel. */
+        RGBA16F,
+
+        /** Four 32-bit floating-point components, 16 bytes per pixel. */
+        RGBA32F,
+
+        /** Four 64-bit floating-point components, 32 bytes per pixel. */
+        RGBA64F,
+    };
+
+    /**
+     * A pixel with four 8-bit unsigned normalized components.
+     *
+     * @ingroup gfx_group
+     */
+    struct Rgba8 {
+        uint8_t r, g, b, a;
+    };
+
+    /**
+     * A pixel with four 16-bit floating-point components.
+     *
+     * The components hold the bit patterns of IEEE 754 half-precision
+     * floating-point numbers.
+     *
+     * @ingroup gfx_group
+     */
+    struct Rgba16f {
+        uint16_t r, g, b, a;
+    };
+
+    /**
+     * Maps pixel types to pixel formats.
+     */
+    template <typename P> struct PixelFormatOf;
+    template <> struct PixelFormatOf<Rgba8> { static constexpr PixelFormat value = PixelFormat::RGBA8; };
+    template <> struct PixelFormatOf<Rgba16f> { static constexpr PixelFormat value = PixelFormat::RGBA16F; };
+    template <> struct PixelFormatOf<Color4f> { static constexpr PixelFormat value = PixelFormat::RGBA32F; };
+    template <> struct PixelFormatOf<Color4d> { static constexpr PixelFormat value = PixelFormat::RGBA64F; };
+
+    /**
+     * An image which stores its pixels in a specific pixel format.
+     *
+     * In contrast to the class Image, which always uses 32 bytes per pixel,
+     * pixel images can use compact formats to save memory and bandwidth.
+     * Pixels are stored row by row without padding. The row accessors do
+     * not check their arguments and are intended for tight loops within
+     * renderers and codecs.
+     *
+     * **Example**
+     *
+     * ```
+     * Image image(640, 480);
+     * // ... render into image
+     *
+     * ImageRgba8 compact(image.GetWidth(), image.GetHeight());
+     * ConvertImage(image, compact);
+     * ```
+     *
+     * @tparam P    the pixel type, Rgba8, Rgba16f, Color4f or Color4d
+     * @ingroup gfx_group
+     */
+    template <typename P>
+    class PixelImage final {
+    public:
+
+        /** The type of the pixels of this image. */
+        using Pixel = P;
+
+        /** The pixel format of this image. */
+        static constexpr PixelFormat Format = PixelFormatOf<P>::value;
+
+        /**
+         * Constructor.
+         *
+         * The pixels are initialized with the default value of the pixel
+         * type, i.e. transparent black for integer and half-precision
+         * pixels and opaque black for color pixels.
+         *
+         * @param w the width of the image in pixels
+         * @param h the height of the image in pixels
+         * @throws std::domain_error in case the width or height is invalid
+         */
+        PixelImage(int w, int h)
+            : width(w)
+            , height(h)
+        {
+            if (w <= 0) {
+                throw std::domain_error("Image width must be greater zero, got "
+                    + std::to_string(w));
+            }
+
+            if (h <= 0) {
+                throw std::domain_error("Image height must be greater zero, got "
+                    + std::to_string(h));
+            }
+
+            data.resize(static_cast<size_t>(width) * height, P());
+        }
+
+        /**
+         * Returns the width of this image
+         *
+         * @return the width of this image in pixel
+         */
+        int GetWidth() const {
+            return width;
+        }
+
+        /**
+         * Returns the height of this image
+         *
+         * @return the height of this image in pixel
+         */
+        int GetHeight() const {
+            return height;
+        }
+
+        /**
+         * Returns the number of pixels of this image.
+         *
+         * @return the number of pixels
+         */
+        size_t NumberOfPixels() const {
+            return data.size();
+        }
+
+        /**
+         * Returns the number of bytes occupied by one row of pixels.
+         *
+         * @return the number of bytes per row
+         */
+        size_t GetRowSize() const {
+            return static_cast<size_t>(width) * sizeof(P);
+        }
+
+        /**
+         * Returns the pixel at the specified location.
+         *
+         * @param x the x-coordinate of the pixel
+         * @param y the y-coordinate of the pixel
+         * @return the pixel
+         * @throws std::out_of_range in case the coordinates are invalid
+         */
+        const P & GetPixel(int x, int y) const {
+            ValidateCoordinates(x, y);
+            return data[static_cast<size_t>(y) * width + x];
+        }
+
+        /**
+         * Sets the pixel at the specified location.
+         *
+         * @param x the x-coordinate of the pixel
+         * @param y the y-coordinate of the pixel
+         * @param p the new pixel value
+         * @throws std::out_of_range in case the coordinates are invalid
+         */
+        void SetPixel(int x, int y, const P & p) {
+            ValidateCoordinates(x, y);
+            data[static_cast<size_t>(y) * width + x] = p;
+        }
+
+        /**
+         * Provides unchecked access to a row of pixels.
+         *
+         * @param y the index of the row, must be within [0, height)
+         * @return pointer to the first pixel of the row
+         */
+        P* GetRow(int y) {
+            return data.data() + static_cast<size_t>(y) * width;
+        }
+
+        /**
+         * Provides unchecked access to a row of pixels.
+         *
+         * @param y the index of the row, must be within [0, height)
+         * @return pointer to the first pixel of the row
+         */
+        const P* GetRow(int y) const {
+            return data.data() + static_cast<size_t>(y) * width;
+        }
+
+        /**
+         * This method provides raw access to the pixels, use with care.
+         *
+         * @return pointer to the linear array of pixels
+         */
+        P* GetPixels() {
+            return data.data();
+        }
+
+        /**
+         * This method provides raw access to the pixels, use with care.
+         *
+         * @return pointer to the linear array of pixels
+         */
+        const P* GetPixels() const {
+            return data.data();
+        }
+
+    private:
+        /** The width of the image in pixel. */
+        int width;
+
+        /** The height of the image in pixel. */
+        int height;
+
+        /** The pixels, stored row by row. */
+        std::vector<P> data;
+
+        /**
+         * Validates pixel coordinates.
+         *
+         * @param x the x-coordinate to validate
+         * @param y the y-coordinate to validate
+         * @throws std::out_of_range in case the coordinates are invalid
+         */
+        void ValidateCoordinates(int x, int y) const {
+            if (x < 0 || x >= width) {
+                throw std::out_of_range("The x-coordinate exceeds image width, got "
+                    + std::to_string(x));
+            }
+
+            if (y < 0 || y >= height) {
+                throw std::out_of_range("The y-coordinate exceeds image height, got "
+                    + std::to_string(y));
+            }
+        }
+    };
+
+    /** An image with 8-bit RGBA pixels. */
+    using ImageRgba8 = PixelImage<Rgba8>;
+
+    /** An image with 16-bit floating-point RGBA pixels. */
+    using ImageRgba16f = PixelImage<Rgba16f>;
+
+    /** An image with 32-bit floating-point RGBA pixels. */
+    using ImageRgba32f = PixelImage<Color4f>;
+
+    /** An image with 64-bit floating-point RGBA pixels. */
+    using ImageRgba64f = PixelImage<Color4d>;
+
+    /**
+     * Converts an array of pixels from one format to another.
+     *
+     * All pairs of the formats Rgba8, Rgba16f, Color4f and Color4d are
+     * supported.
+     *
+     * Conversions to 8-bit components saturate and round to the nearest
+     * value, conversions to 16-bit floating-point components round to
+     * the nearest even value. The pixels are processed as flat arrays of
+     * components, which allows the compiler to vectorize the loops.
+     *
+     * @param src   the source pixels
+     * @param dst   receives the converted pixels
+     * @param n     the number of pixels to convert
+     * @ingroup gfx_group
+     */
+    void ConvertPixels(const Color4d* src, Rgba8* dst, size_t n);
+    void ConvertPixels(const Rgba8* src, Color4d* dst, size_t n);
+    void ConvertPixels(const Color4d* src, Rgba16f* dst, size_t n);
+    void ConvertPixels(const Rgba16f* src, Color4d* dst, size_t n);
+    void ConvertPixels(const Color4d* src, Color4f* dst, size_t n);
+    void ConvertPixels(const Color4f* src, Color4d* dst, size_t n);
+    void ConvertPixels(const Color4f* src, Rgba8* dst, size_t n);
+    void ConvertPixels(const Rgba8* src, Color4f* dst, size_t n);
+    void ConvertPixels(const Color4f* src, Rgba16f* dst, size_t n);
+    void ConvertPixels(const Rgba16f* src, Color4f* dst, size_t n);
+    void ConvertPixels(const Rgba8* src, Rgba16f* dst, size_t n);
+    void ConvertPixels(const Rgba16f* src, Rgba8* dst, size_t n);
+
+    /**
+     * Copies an array of pixels of the same format.
+     *
+     * @param src   the source pixels
+     * @param dst   receives the pixels
+     * @param n     the number of pixels to copy
+     * @ingroup gfx_group
+     */
+    template <typename P>
+    void ConvertPixels(const P* src, P* dst, size_t n) {
+        std::copy(src, src + n, dst);
+    }
+
+    /**
+     * Converts an image to a pixel image of equal dimensions.
+     *
+     * @param src   the source image
+     * @param dst   receives the converted pixels
+     * @throws std::domain_error in case the dimensions do not match
+     * @ingroup gfx_group
+     */
+    template <typename P>
+    void ConvertImage(const Image & src, PixelImage<P> & dst) {
+        if (src.GetWidth() != dst.GetWidth() || src.GetHeight() != dst.GetHeight()) {
+            throw std::domain_error("Image dimensions do not match");
+        }
+        ConvertPixels(src.GetPixels(), dst.GetPixels(), dst.NumberOfPixels());
+    }
+
+    /**
+     * Converts a pixel image to an image of equal dimensions.
+     *
+     * @param src   the source pixel image
+     * @param dst   receives the converted pixels
+     * @throws std::domain_error in case the dimensions do not match
+     * @ingroup gfx_group
+     */
+    template <typename P>
+    void ConvertImage(const PixelImage<P> & src, Image & dst) {
+        if (src.GetWidth() != dst.GetWidth() || src.GetHeight() != dst.GetHeight()) {
+            throw std::domain_error("Image dimensions do not match");
+        }
+        ConvertPixels(src.GetPixels(), dst.GetPixels(), src.NumberOfPixels());
+    }
+
+    /**
+     * Converts a pixel image to another pixel image of equal dimensions.
+     *
+     * @param src   the source pixel image
+     * @param dst   receives the converted pixels
+     * @throws std::domain_error in case the dimensions do not match
+     * @ingroup gfx_group
+     */
+    template <typename S, typename D>
+    void ConvertImage(const PixelImage<S> & src, PixelImage<D> & dst) {
+        if (src.GetWidth() != dst.GetWidth() || src.GetHeight() != dst.GetHeight()) {
+            throw std::domain_error("Image dimensions do not match");
+        }
+        ConvertPixels(src.GetPixels(), dst.GetPixels(), src.NumberOfPixels());
+    }
+
+} // end of namespace
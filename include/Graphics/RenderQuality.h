@@ -31,6 +31,32 @@ namespace astu {
             Insane
     };
 
+    /**
+     * Describes the methods used to render images.
+     * 
+     * @ingroup gfx_group
+     */
+    enum class RenderMethod {
+            /** 
+             * Evaluates the scene at several sample points per pixel, the 
+             * number of samples depends on the render quality.
+             */
+            Sampling,
+
+            /** 
+             * Rasterizes shapes scanline by scanline using analytic pixel
+             * coverage, the render quality is ignored. Much faster than
+             * sampling but different anti-aliasing: the coverage is the
+             * area of a pixel covered by a shape (box filter), which is
+             * exact for rectangles and approximated within 0.09 for
+             * circles. Sampling uses kernels wider than one pixel and snaps
+             * sample positions to sub-pixels. Edges therefore look sharper
+             * and pixels along edges may differ from sampling by up to 0.6,
+             * whereas pixels away from edges are equal.
+             */
+            Coverage
+    };
+
     /**
      * Describes different levels of anti-aliasing.
      * 
@@ -15,8 +15,12 @@
 #include "Graphics/VertexBuffer2.h"
 
 // C++ Standard Library includes
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <stdexcept>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace astu {
@@ -49,6 +53,7 @@ namespace astu {
                 throw std::logic_error(
                     "Invalid number of vertices to define a polygon");
             }            
+            BuildEdgeTable();
         }
 
         /**
@@ -146,21 +151,57 @@ namespace astu {
          * inside of the polygon then it will intersect the edge an odd number
          * of times. https://en.wikipedia.org/wiki/Point_in_polygon
          * 
+         * This implementation uses a horizontal ray and an edge table, which
+         * is built whenever the vertices change. Edges are treated as
+         * half-open intervals regarding their y-coordinates, hence a ray
+         * passing through a vertex is counted exactly once. Points may be
+         * tested from several threads concurrently.
+         * 
          * @param p the point to test
          * @return `true` if the point lies within the polygon
          */
         bool IsInside(const Vector2<T>& p) const {
-            // Crearte a ray pointing arbitrary ray direction.
-            Ray2<T> ray(p.x, p.y, static_cast<T>(1.2), static_cast<T>(3.4));
+            return IsInsideUnchecked(p.x, p.y);
+        }
 
-            int cnt = 0;
-            for (size_t i = 0; i < NumEdges(); ++i) {
-                if (GetEdgeAsSegment(i).IsIntersecting(ray)) {
-                    ++cnt;
-                }
+        /**
+         * Tests whether several points lie within this polygon.
+         * 
+         * @param points    the points to test
+         * @param n         the number of points
+         * @param results   receives the results for the points
+         */
+        void IsInside(const Vector2<T>* points, size_t n, bool* results) const {
+            for (size_t i = 0; i < n; ++i) {
+                results[i] = IsInsideUnchecked(points[i].x, points[i].y);
             }
+        }
+
+        /**
+         * Enables or disables grid acceleration for point-in-polygon tests.
+         * 
+         * The grid divides the bounding box of this polygon into horizontal
+         * rows, each referencing the edges overlapping the row. Points are
+         * only tested against the edges of their row, which pays off for
+         * polygons with many vertices.
+         * 
+         * @param b         `true` to enable grid acceleration
+         * @param numRows   the number of rows, zero chooses the number of
+         *                  rows according to the number of edges
+         */
+        void SetGridAcceleration(bool b, size_t numRows = 0) {
+            gridRequested = b;
+            requestedGridRows = numRows;
+            BuildEdgeTable();
+        }
 
-            return cnt % 2 != 0;
+        /**
+         * Returns whether grid acceleration is enabled.
+         * 
+         * @return `true` if grid acceleration is enabled
+         */
+        bool IsGridAccelerated() const {
+            return gridRequested;
         }
 
         /**
@@ -170,14 +211,162 @@ namespace astu {
          * @return the 1D segment representing the projected polygon
          */
         Segment1<T> Project(const Vector2<T>& axis) const {
-            Segment1<T> result;
+            // Minimum and maximum are kept in local variables without
+            // branches, which allows the compiler to vectorize the loop.
+            const T ax = axis.x;
+            const T ay = axis.y;
+            T lo = ax * vertices[0].x + ay * vertices[0].y;
+            T hi = lo;
+            for (size_t i = 1; i < vertices.size(); ++i) {
+                const T d = ax * vertices[i].x + ay * vertices[i].y;
+                lo = std::min(lo, d);
+                hi = std::max(hi, d);
+            }
+
+            return Segment1<T>(lo, hi);
+        }
+
+        /**
+         * Projects this polygon on several axes.
+         * 
+         * @param axes      the axes used to project this polygon
+         * @param n         the number of axes
+         * @param results   receives the projected polygon for each axis
+         */
+        void Project(const Vector2<T>* axes, size_t n, Segment1<T>* results) const {
+            for (size_t i = 0; i < n; ++i) {
+                results[i] = Project(axes[i]);
+            }
+        }
+
+        /**
+         * Calculates the signed area of this polygon.
+         * 
+         * The area is positive if the vertices are in counter-clockwise 
+         * order and negative otherwise (assuming the y-axis points upwards).
+         * 
+         * @return the signed area
+         */
+        T CalcSignedArea() const {
+            T area = 0;
+            for (size_t i = 0; i < vertices.size(); ++i) {
+                area += vertices[i].Cross(vertices[(i + 1) % vertices.size()]);
+            }
+            return area / 2;
+        }
+
+        /**
+         * Tests whether this polygon is convex.
+         * 
+         * Collinear edges are allowed.
+         * 
+         * @return `true` if this polygon is convex
+         */
+        bool IsConvex() const {
+            bool hasPositive = false;
+            bool hasNegative = false;
+            for (size_t i = 0; i < vertices.size(); ++i) {
+                const T c = GetEdge(i).Cross(GetEdge((i + 1) % vertices.size()));
+                hasPositive |= c > 0;
+                hasNegative |= c < 0;
+            }
+            return !(hasPositive && hasNegative);
+        }
+
+        /**
+         * Tests whether this polygon is simple.
+         * 
+         * A polygon is simple if its edges do not intersect except for
+         * adjacent edges meeting at their common vertex. Consecutive
+         * duplicate vertices are ignored. Each pair of edges is tested,
+         * hence the cost of this method is quadratic in the number of
+         * vertices.
+         * 
+         * @return `true` if this polygon is simple
+         */
+        bool IsSimple() const {
+            std::vector<size_t> poly;
+            for (size_t i = 0; i < vertices.size(); ++i) {
+                if (vertices[i] != vertices[(i + 1) % vertices.size()]) {
+                    poly.push_back(i);
+                }
+            }
+
+            const size_t n = poly.size();
+            if (n < 3) {
+                return false;
+            }
 
-            auto it = vertices.begin();
-            result.Set( axis.Dot(*it++) );
-            for (; it != vertices.end(); ++it) {
-                result.Extend( axis.Dot(*it) );
+            for (size_t i = 0; i < n; ++i) {
+                const size_t a = poly[i];
+                const size_t b = poly[(i + 1) % n];
+
+                // Adjacent edges must not fold back onto each other.
+                const size_t c = poly[(i + 2) % n];
+                if (Cross(a, b, c) == 0 
+                    && (vertices[b] - vertices[a]).Dot(vertices[c] - vertices[b]) < 0) 
+                {
+                    return false;
+                }
+
+                // The last edge is adjacent to the first one.
+                for (size_t j = i + 2; j < n - (i == 0 ? 1 : 0); ++j) {
+                    if (AreIntersecting(a, b, poly[j], poly[(j + 1) % n])) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Splits this polygon into convex polygons.
+         * 
+         * The polygon is triangulated by ear clipping and adjacent triangles
+         * are merged as long as the result remains convex (Hertel-Mehlhorn
+         * algorithm), which yields at most four times the minimum number of
+         * convex parts. The vertices of the parts are in counter-clockwise
+         * order. This method is meant to be used once, e.g., when a shape
+         * gets created, its cost is quadratic in the number of vertices.
+         * 
+         * @see IsSimple()
+         * 
+         * @param maxVertices   the maximum number of vertices of each part,
+         *                      zero means unlimited
+         * @return the convex parts
+         * @throws std::domain_error in case the maximum number of vertices is
+         *      less than three or this polygon is not simple
+         */
+        std::vector<Polygon<T>> DecomposeConvex(size_t maxVertices = 0) const {
+            if (maxVertices != 0 && maxVertices < 3) {
+                throw std::domain_error(
+                    "Maximum number of vertices of convex parts must be at least three");
             }
 
+            if (!IsSimple()) {
+                throw std::domain_error(
+                    "Unable to decompose polygon, polygon must be simple");
+            }
+
+            // Work on indices in counter-clockwise order.
+            const bool clockwise = CalcSignedArea() < 0;
+            std::vector<size_t> remaining(vertices.size());
+            for (size_t i = 0; i < remaining.size(); ++i) {
+                remaining[i] = clockwise ? remaining.size() - 1 - i : i;
+            }
+
+            if (IsConvex() && (maxVertices == 0 || vertices.size() <= maxVertices)) {
+                return {Polygon<T>(IndicesToVertices(remaining))};
+            }
+
+            std::vector<std::vector<size_t>> parts = Triangulate(remaining);
+            MergeConvex(parts, maxVertices);
+
+            std::vector<Polygon<T>> result;
+            result.reserve(parts.size());
+            for (const auto& part : parts) {
+                result.push_back(Polygon<T>(IndicesToVertices(part)));
+            }
             return result;
         }
 
@@ -191,12 +380,412 @@ namespace astu {
             for (auto & vertex : vertices) {
                 tx.TransformPointIp(vertex);
             }
+            BuildEdgeTable();
             return *this;
         }
 
     private:
+        /** 
+         * Stores edges as separate arrays of coordinates, which allows the
+         * compiler to vectorize the crossing test.
+         */
+        struct EdgeTable {
+            /** The x-coordinates of the start vertices. */
+            std::vector<T> x0;
+
+            /** The y-coordinates of the start vertices. */
+            std::vector<T> y0;
+
+            /** The y-coordinates of the end vertices. */
+            std::vector<T> y1;
+
+            /** The change of x per unit of y, zero for horizontal edges. */
+            std::vector<T> slope;
+
+            void Clear() {
+                x0.clear();
+                y0.clear();
+                y1.clear();
+                slope.clear();
+            }
+
+            void Add(const Vector2<T>& v0, const Vector2<T>& v1) {
+                x0.push_back(v0.x);
+                y0.push_back(v0.y);
+                y1.push_back(v1.y);
+                slope.push_back(v1.y != v0.y ? (v1.x - v0.x) / (v1.y - v0.y) : 0);
+            }
+
+            /**
+             * Counts the edges within [begin, end) crossed by a ray pointing
+             * from the specified point in positive x-direction.
+             */
+            size_t CountCrossings(size_t begin, size_t end, T px, T py) const {
+                const T* ex0 = x0.data();
+                const T* ey0 = y0.data();
+                const T* ey1 = y1.data();
+                const T* es = slope.data();
+
+                size_t cnt = 0;
+                for (size_t i = begin; i < end; ++i) {
+                    const bool straddles = (ey0[i] > py) != (ey1[i] > py);
+                    const bool right = px < ex0[i] + (py - ey0[i]) * es[i];
+                    cnt += straddles & right;
+                }
+                return cnt;
+            }
+        };
+
+        /** The maximum number of grid rows chosen automatically. */
+        static constexpr size_t MAX_GRID_ROWS = 4096;
+
+        /** The average number of grid rows referencing an edge, at most. */
+        static constexpr size_t MAX_GRID_REFERENCES_PER_EDGE = 16;
+
         /** The vertices of this polygon. */
         std::vector<Vector2<T>> vertices;
+
+        /** The edges used for point-in-polygon tests. */
+        EdgeTable edges;
+
+        /** The edges referenced by the rows of the grid, row by row. */
+        EdgeTable grid;
+
+        /** The index of the first edge of each row in the grid table. */
+        std::vector<size_t> gridRowStart;
+
+        /** The height of a grid row, inverted. */
+        T gridInvRowHeight = 0;
+
+        /** The bounding box of this polygon. */
+        T minX = 0, minY = 0, maxX = 0, maxY = 0;
+
+        /** Whether grid acceleration is enabled. */
+        bool gridRequested = false;
+
+        /** The requested number of grid rows, zero chooses automatically. */
+        size_t requestedGridRows = 0;
+
+        /** Returns the cross product of the vectors a - o and b - o. */
+        T Cross(size_t o, size_t a, size_t b) const {
+            return (vertices[a] - vertices[o]).Cross(vertices[b] - vertices[o]);
+        }
+
+        std::vector<Vector2<T>> IndicesToVertices(const std::vector<size_t>& indices) const {
+            std::vector<Vector2<T>> result;
+            result.reserve(indices.size());
+            for (size_t idx : indices) {
+                result.push_back(vertices[idx]);
+            }
+            return result;
+        }
+
+        /**
+         * Tests whether the collinear point p lies on the segment a-b.
+         */
+        bool IsOnSegment(size_t p, size_t a, size_t b) const {
+            return std::min(vertices[a].x, vertices[b].x) <= vertices[p].x
+                && vertices[p].x <= std::max(vertices[a].x, vertices[b].x)
+                && std::min(vertices[a].y, vertices[b].y) <= vertices[p].y
+                && vertices[p].y <= std::max(vertices[a].y, vertices[b].y);
+        }
+
+        /**
+         * Tests whether the segments a-b and c-d intersect or touch.
+         */
+        bool AreIntersecting(size_t a, size_t b, size_t c, size_t d) const {
+            const T d1 = Cross(c, d, a);
+            const T d2 = Cross(c, d, b);
+            const T d3 = Cross(a, b, c);
+            const T d4 = Cross(a, b, d);
+
+            if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) 
+                && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))) 
+            {
+                return true;
+            }
+
+            return (d1 == 0 && IsOnSegment(a, c, d)) 
+                || (d2 == 0 && IsOnSegment(b, c, d))
+                || (d3 == 0 && IsOnSegment(c, a, b)) 
+                || (d4 == 0 && IsOnSegment(d, a, b));
+        }
+
+        /**
+         * Tests whether a point lies within or on the border of a triangle
+         * in counter-clockwise order.
+         */
+        bool IsInTriangle(size_t p, size_t a, size_t b, size_t c) const {
+            return Cross(a, b, p) >= 0 && Cross(b, c, p) >= 0 && Cross(c, a, p) >= 0;
+        }
+
+        /**
+         * Triangulates a polygon given by indices in counter-clockwise order
+         * using ear clipping.
+         */
+        std::vector<std::vector<size_t>> Triangulate(std::vector<size_t> remaining) const {
+            std::vector<std::vector<size_t>> triangles;
+            size_t i = 0;
+            size_t attempts = 0;
+            while (remaining.size() > 3) {
+                const size_t n = remaining.size();
+                const size_t prev = remaining[(i + n - 1) % n];
+                const size_t cur = remaining[i % n];
+                const size_t next = remaining[(i + 1) % n];
+                const T c = Cross(prev, cur, next);
+
+                bool isEar = c > 0;
+                for (size_t j = 0; isEar && j < n; ++j) {
+                    const size_t other = remaining[j];
+                    if (other != prev && other != cur && other != next
+                        && IsInTriangle(other, prev, cur, next))
+                    {
+                        isEar = false;
+                    }
+                }
+
+                if (isEar || c == 0) {
+                    // Collinear vertices are dropped without a triangle.
+                    if (isEar) {
+                        triangles.push_back({prev, cur, next});
+                    }
+                    remaining.erase(remaining.begin() + i % n);
+                    attempts = 0;
+                } else {
+                    ++i;
+                    if (++attempts > n) {
+                        throw std::domain_error(
+                            "Unable to decompose polygon, polygon must be simple");
+                    }
+                }
+                i %= remaining.size();
+            }
+
+            if (Cross(remaining[0], remaining[1], remaining[2]) > 0) {
+                triangles.push_back(remaining);
+            }
+            return triangles;
+        }
+
+        /**
+         * Tests whether a polygon given by indices in counter-clockwise
+         * order is convex.
+         */
+        bool IsConvex(const std::vector<size_t>& poly) const {
+            const size_t n = poly.size();
+            for (size_t i = 0; i < n; ++i) {
+                if (Cross(poly[i], poly[(i + 1) % n], poly[(i + 2) % n]) < 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Merges two polygons sharing the edge a->b of the first polygon.
+         */
+        static std::vector<size_t> Merge(const std::vector<size_t>& p, size_t ia,
+            const std::vector<size_t>& q, size_t ib)
+        {
+            // Walk p from b around to a, then q from a around to b
+            // excluding the shared vertices.
+            std::vector<size_t> result;
+            result.reserve(p.size() + q.size() - 2);
+            for (size_t k = 1; k <= p.size(); ++k) {
+                result.push_back(p[(ia + k) % p.size()]);
+            }
+            for (size_t k = 2; k < q.size(); ++k) {
+                result.push_back(q[(ib + k) % q.size()]);
+            }
+            return result;
+        }
+
+        /**
+         * Merges adjacent convex polygons as long as the result remains
+         * convex (Hertel-Mehlhorn).
+         * 
+         * Each diagonal shared by two polygons is tried exactly once. The
+         * polygons are looked up by their directed edges, merged polygons
+         * are tracked as disjoint sets.
+         */
+        void MergeConvex(std::vector<std::vector<size_t>>& parts, size_t maxVertices) const {
+            const size_t n = vertices.size();
+            std::unordered_map<size_t, size_t> edgeToPart;
+            for (size_t i = 0; i < parts.size(); ++i) {
+                for (size_t k = 0; k < parts[i].size(); ++k) {
+                    edgeToPart[parts[i][k] * n + parts[i][(k + 1) % parts[i].size()]] = i;
+                }
+            }
+
+            std::vector<size_t> owner(parts.size());
+            for (size_t i = 0; i < owner.size(); ++i) {
+                owner[i] = i;
+            }
+            const auto findOwner = [&owner](size_t i) {
+                while (owner[i] != i) {
+                    i = owner[i] = owner[owner[i]];
+                }
+                return i;
+            };
+
+            // Diagonals are the edges contained in two polygons.
+            std::vector<std::pair<size_t, size_t>> diagonals;
+            for (const auto& part : parts) {
+                for (size_t k = 0; k < part.size(); ++k) {
+                    const size_t a = part[k];
+                    const size_t b = part[(k + 1) % part.size()];
+                    if (a < b && edgeToPart.count(b * n + a)) {
+                        diagonals.push_back(std::make_pair(a, b));
+                    }
+                }
+            }
+
+            for (const auto& diagonal : diagonals) {
+                const size_t a = diagonal.first;
+                const size_t b = diagonal.second;
+                const size_t i = findOwner(edgeToPart[a * n + b]);
+                const size_t j = findOwner(edgeToPart[b * n + a]);
+                auto& p = parts[i];
+                auto& q = parts[j];
+                if (i == j || (maxVertices && p.size() + q.size() - 2 > maxVertices)) {
+                    continue;
+                }
+
+                const size_t ia = std::find(p.begin(), p.end(), a) - p.begin();
+                const size_t ib = std::find(q.begin(), q.end(), b) - q.begin();
+                assert(p[(ia + 1) % p.size()] == b && q[(ib + 1) % q.size()] == a);
+
+                auto candidate = Merge(p, ia, q, ib);
+                if (IsConvex(candidate)) {
+                    p = std::move(candidate);
+                    q.clear();
+                    owner[j] = i;
+                }
+            }
+
+            parts.erase(std::remove_if(parts.begin(), parts.end(), 
+                [](const std::vector<size_t>& part) { return part.empty(); }), parts.end());
+        }
+
+        size_t GetGridRow(T y) const {
+            const size_t numRows = gridRowStart.size() - 1;
+            const T row = (y - minY) * gridInvRowHeight;
+            return row <= 0 ? 0 : std::min(numRows - 1, static_cast<size_t>(row));
+        }
+
+        /**
+         * Builds the edge table and the optional grid used to test whether
+         * points lie within this polygon.
+         */
+        void BuildEdgeTable() {
+            edges.Clear();
+            minX = maxX = vertices[0].x;
+            minY = maxY = vertices[0].y;
+            for (size_t i = 0; i < vertices.size(); ++i) {
+                const auto& v0 = vertices[i];
+                const auto& v1 = vertices[(i + 1) % vertices.size()];
+                edges.Add(v0, v1);
+                minX = std::min(minX, v0.x);
+                maxX = std::max(maxX, v0.x);
+                minY = std::min(minY, v0.y);
+                maxY = std::max(maxY, v0.y);
+            }
+
+            grid.Clear();
+            gridRowStart.clear();
+            if (gridRequested) {
+                BuildGrid();
+            }
+        }
+
+        /**
+         * Determines the number of edges referenced by each row of the grid.
+         * 
+         * @param numRows   the number of rows
+         * @return the total number of edge references
+         */
+        size_t CountGridReferences(size_t numRows) {
+            const T height = maxY - minY;
+            gridInvRowHeight = height > 0 ? numRows / height : 0;
+            gridRowStart.assign(numRows + 1, 0);
+
+            // Each edge increments the counts of the rows [r0, r1], which
+            // are accumulated as differences.
+            std::vector<ptrdiff_t> diff(numRows + 1, 0);
+            size_t total = 0;
+            for (size_t i = 0; i < edges.x0.size(); ++i) {
+                if (edges.y0[i] == edges.y1[i]) {
+                    // Horizontal edges are never crossed.
+                    continue;
+                }
+                const size_t r0 = GetGridRow(std::min(edges.y0[i], edges.y1[i]));
+                const size_t r1 = GetGridRow(std::max(edges.y0[i], edges.y1[i]));
+                ++diff[r0];
+                --diff[r1 + 1];
+                total += r1 - r0 + 1;
+            }
+
+            ptrdiff_t cnt = 0;
+            for (size_t r = 0; r < numRows; ++r) {
+                cnt += diff[r];
+                gridRowStart[r + 1] = gridRowStart[r] + cnt;
+            }
+            return total;
+        }
+
+        void BuildGrid() {
+            const size_t numEdges = edges.x0.size();
+            size_t numRows = requestedGridRows;
+            if (maxY <= minY) {
+                numRows = 1;
+            } else if (numRows == 0) {
+                numRows = std::min<size_t>(std::max<size_t>(numEdges / 2, 1), MAX_GRID_ROWS);
+            }
+
+            // Long edges are referenced by many rows, automatically chosen
+            // grids get coarser until the memory consumption is reasonable.
+            size_t total = CountGridReferences(numRows);
+            while (requestedGridRows == 0 && numRows > 1 
+                && total > MAX_GRID_REFERENCES_PER_EDGE * numEdges) 
+            {
+                numRows /= 2;
+                total = CountGridReferences(numRows);
+            }
+
+            grid.x0.resize(total);
+            grid.y0.resize(total);
+            grid.y1.resize(total);
+            grid.slope.resize(total);
+
+            std::vector<size_t> next(gridRowStart.begin(), gridRowStart.end() - 1);
+            for (size_t i = 0; i < numEdges; ++i) {
+                if (edges.y0[i] == edges.y1[i]) {
+                    continue;
+                }
+                const size_t r0 = GetGridRow(std::min(edges.y0[i], edges.y1[i]));
+                const size_t r1 = GetGridRow(std::max(edges.y0[i], edges.y1[i]));
+                for (size_t r = r0; r <= r1; ++r) {
+                    const size_t j = next[r]++;
+                    grid.x0[j] = edges.x0[i];
+                    grid.y0[j] = edges.y0[i];
+                    grid.y1[j] = edges.y1[i];
+                    grid.slope[j] = edges.slope[i];
+                }
+            }
+        }
+
+        bool IsInsideUnchecked(T x, T y) const {
+            if (x < minX || x > maxX || y < minY || y > maxY) {
+                return false;
+            }
+
+            if (gridRowStart.empty()) {
+                return edges.CountCrossings(0, edges.x0.size(), x, y) % 2 != 0;
+            }
+
+            const size_t row = GetGridRow(y);
+            return grid.CountCrossings(gridRowStart[row], gridRowStart[row + 1], x, y) % 2 != 0;
+        }
     };
 
     /**
@@ -10,12 +10,14 @@
 // Local includes
 #include "ECS/EntityService.h"
 #include "Math/Polygon.h"
+#include "Math/Segment1.h"
 #include "Math/Vector2.h"
 
 // C++ Standard Library includes
 #include <stdexcept>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace astu::suite2d {
 
@@ -495,11 +497,40 @@ namespace astu::suite2d {
     /**
      * Polygonal collider.
      * 
+     * Polygons are split into convex parts when they get assigned to the
+     * collider. Each part caches its edge normals and its projection onto
+     * these normals, which is the data required by the separating axis
+     * theorem (SAT). Physics engines which only support convex shapes can
+     * use the convex parts instead of the polygon.
+     * 
      * @ingroup suite2d_group
      */
     class CPolygonCollider : public CBodyCollider {
     public: 
 
+        /**
+         * A convex part of the polygon of a collider.
+         */
+        struct ConvexPart {
+            /** The convex polygon in counter-clockwise order. */
+            Polygon2f polygon;
+
+            /** The edge normals, parallel edges share a single normal. */
+            std::vector<Vector2f> normals;
+
+            /** The projections of the polygon onto the normals. */
+            std::vector<Segment1f> extents;
+
+            /** The center of the bounding circle of the polygon. */
+            Vector2f center;
+
+            /** The radius of the bounding circle of the polygon. */
+            float radius;
+        };
+
+        /** Type alias for the convex parts of a polygon. */
+        using ConvexParts = std::vector<ConvexPart>;
+
         /**
          * Constructor.
          */
@@ -508,16 +539,82 @@ namespace astu::suite2d {
             // Intentionally left empty.        
         }
 
+        /**
+         * Splits a polygon into convex parts and precomputes the data
+         * required for overlap tests.
+         * 
+         * The result can be shared among colliders using the same polygon.
+         * 
+         * @param poly          the polygon, which must be simple
+         * @param maxVertices   the maximum number of vertices of each part,
+         *                      zero means unlimited
+         * @return the convex parts of the polygon
+         * @throws std::domain_error in case the polygon is not simple or
+         *      the maximum number of vertices is less than three
+         */
+        static std::shared_ptr<const ConvexParts> Preprocess(
+            const Polygon2f& poly, size_t maxVertices = 0);
+
         /**
          * Sets the polygon of this collider.
          * 
          * @param poly  the polygon
+         * @throws std::domain_error in case the polygon is not simple
+         */
+        void SetPolygon(std::shared_ptr<const Polygon2f> poly);
+
+        /**
+         * Sets the polygon of this collider together with its convex parts.
+         * 
+         * @param poly  the polygon
+         * @param parts the convex parts of the polygon, see Preprocess()
          */
-        void SetPolygon(std::shared_ptr<const Polygon2f> poly)
+        void SetPolygon(std::shared_ptr<const Polygon2f> poly, 
+            std::shared_ptr<const ConvexParts> parts)
         {
             polygon = poly;
+            convexParts = parts;
+        }
+
+        /**
+         * Returns the polygon of this collider.
+         * 
+         * @return the polygon
+         */
+        const std::shared_ptr<const Polygon2f>& GetPolygon() const {
+            return polygon;
         }
 
+        /**
+         * Returns the convex parts of the polygon of this collider.
+         * 
+         * @return the convex parts
+         */
+        const ConvexParts& GetConvexParts() const {
+            if (!convexParts) {
+                throw std::logic_error("No polygon specified for polygon collider");
+            }
+            return *convexParts;
+        }
+
+        /**
+         * Tests whether this collider overlaps another polygon collider.
+         * 
+         * Both colliders are placed by rigid transformations, i.e., a
+         * position and an orientation of their entities. The offsets of the
+         * colliders are taken into account. Touching colliders overlap.
+         * 
+         * @param pos           the position of this collider's entity
+         * @param angle         the orientation of this collider's entity in radians
+         * @param other         the other collider
+         * @param otherPos      the position of the other collider's entity
+         * @param otherAngle    the orientation of the other collider's entity in radians
+         * @return `true` if the colliders overlap
+         * @throws std::logic_error in case one of the colliders has no polygon
+         */
+        bool IsOverlapping(const Vector2f& pos, float angle, 
+            const CPolygonCollider& other, const Vector2f& otherPos, float otherAngle) const;
+
         // Inherited via CBodyCollider
         virtual void OnAddedToEntity(Entity & entity)
         {
@@ -527,6 +624,9 @@ namespace astu::suite2d {
     protected:
         /** The polygon defining the shape of this collider. */
         std::shared_ptr<const Polygon2f> polygon;
+
+        /** The convex parts of the polygon. */
+        std::shared_ptr<const ConvexParts> convexParts;
     };    
 
     /**
@@ -579,6 +679,7 @@ namespace astu::suite2d {
          */
         CPolygonColliderBuilder& Polygon(std::shared_ptr<const Polygon2f> poly) {
             polygon = poly;
+            convexParts = nullptr;
             return *this;
         }
 
@@ -590,6 +691,27 @@ namespace astu::suite2d {
          */
         CPolygonColliderBuilder& Polygon(const std::vector<Vector2f>& vertices) {
             polygon = std::make_shared<Polygon2f>(vertices);
+            convexParts = nullptr;
+            return *this;
+        }
+
+        /**
+         * Sets the maximum number of vertices of the convex parts.
+         * 
+         * Some physics engines limit the number of vertices of convex
+         * shapes, e.g., Box2D allows at most eight vertices.
+         * 
+         * @param n the maximum number of vertices, zero means unlimited
+         * @return reference to this builder for method chaining
+         * @throws std::domain_error in case n is less than three but not zero
+         */
+        CPolygonColliderBuilder& MaxPartVertices(size_t n) {
+            if (n != 0 && n < 3) {
+                throw std::domain_error(
+                    "Maximum number of vertices of convex parts must be at least three");
+            }
+            maxPartVertices = n;
+            convexParts = nullptr;
             return *this;
         }
 
@@ -610,6 +732,8 @@ namespace astu::suite2d {
         CPolygonColliderBuilder& Reset() {
             CBodyColliderBuilder::Reset();
             polygon = nullptr;
+            convexParts = nullptr;
+            maxPartVertices = 0;
             return *this;
         }
 
@@ -629,6 +753,12 @@ namespace astu::suite2d {
 
         /** The polygon defining the shape of the collider to build. */
         std::shared_ptr<const Polygon2f> polygon;
+
+        /** The convex parts of the polygon, shared by all built colliders. */
+        std::shared_ptr<const CPolygonCollider::ConvexParts> convexParts;
+
+        /** The maximum number of vertices of the convex parts. */
+        size_t maxPartVertices;
     };
 
 } // end of namespace
\ No newline at end of file
@@ -0,0 +1,310 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+#pragma once
+
+// Local includes
+#include "Service/Service.h"
+#include "Graphics/VertexBuffer2.h"
+#include "Graphics/Color.h"
+#include "Graphics/Image.h"
+#include "Graphics/PixelImage.h"
+#include "Math/Vector2.h"
+#include "Math/Matrix3.h"
+#include "Suite2D/Scene.h"
+
+// C++ Standard Library includes
+#include <cstdint>
+#include <vector>
+
+namespace astu::suite2d {
+
+    /////////////////////////////////////////////////
+    /////// ImageVertexBuffer2D
+    /////////////////////////////////////////////////
+
+    /**
+     * Vertex buffer used by the ImageSceneRenderer2D.
+     *
+     * @ingroup suite2d_group
+     */
+    class ImageVertexBuffer2D : public VertexBuffer2f {
+    public:
+        /** The vertices of this vertex buffer. */
+        std::vector<Vector2f> vertices;
+    };
+
+    /////////////////////////////////////////////////
+    /////// ImageVertexBufferBuilderService2D
+    /////////////////////////////////////////////////
+
+    /**
+     * Builds vertex buffers for the ImageSceneRenderer2D.
+     *
+     * Add this service instead of the SDL-based vertex buffer builder when
+     * rendering scene graphs without a display.
+     *
+     * @ingroup suite2d_group
+     */
+    class ImageVertexBufferBuilderService2D
+        : virtual public Service
+        , public VertexBufferBuilder2<float>
+    {
+    public:
+
+        /**
+         * Constructor.
+         */
+        ImageVertexBufferBuilderService2D();
+
+        // Inherited via VertexBufferBuilder2f
+        virtual VertexBufferBuilder2f& AddVertex(float x, float y) override;
+        virtual const Vector2f& GetVertex(size_t idx) const override;
+        virtual VertexBufferBuilder2f& SetVertex(size_t idx, float x, float y) override;
+        virtual size_t GetNumVertices() const override;
+        virtual VertexBufferBuilder2f& Reset() override;
+        virtual std::shared_ptr<VertexBuffer2f> Build() override;
+
+    private:
+        /** The vertices used for the buffer to build. */
+        std::vector<astu::Vector2f> vertices;
+    };
+
+    /////////////////////////////////////////////////
+    /////// ImageSceneRenderer2D
+    /////////////////////////////////////////////////
+
+    /**
+     * A scene renderer which rasterizes polylines into an 8-bit RGBA
+     * framebuffer in main memory.
+     *
+     * This renderer does not require a display and is intended for
+     * headless simulations, automated tests and thumbnail generation.
+     * Lines are drawn using Bresenham's algorithm or, if antialiasing
+     * is enabled, using Xiaolin Wu's algorithm.
+     *
+     * **Example**
+     *
+     * ```
+     * ImageSceneRenderer2D renderer(640, 480);
+     * renderer.Clear();
+     * sceneGraph.GetRoot()->Render(renderer, 1.0f);
+     *
+     * Image image(640, 480);
+     * renderer.CopyTo(image);
+     * ```
+     *
+     * @ingroup suite2d_group
+     */
+    class ImageSceneRenderer2D : public SceneRenderer2D {
+    public:
+
+        /**
+         * Constructor.
+         *
+         * @param width     the width of the framebuffer in pixels
+         * @param height    the height of the framebuffer in pixels
+         * @throws std::domain_error in case the width or height is invalid
+         */
+        ImageSceneRenderer2D(int width, int height);
+
+        /**
+         * Returns the width of the framebuffer.
+         *
+         * @return the width in pixels
+         */
+        int GetWidth() const {
+            return width;
+        }
+
+        /**
+         * Returns the height of the framebuffer.
+         *
+         * @return the height in pixels
+         */
+        int GetHeight() const {
+            return height;
+        }
+
+        /**
+         * Sets the view transformation.
+         *
+         * @param m the transformation matrix
+         */
+        void SetViewMatrix(const Matrix3f& m) {
+            viewMatrix = m;
+        }
+
+        /**
+         * Sets the background color used to clear the framebuffer.
+         *
+         * @param c the background color
+         */
+        void SetBackgroundColor(const Color4f& c) {
+            backgroundColor = c;
+        }
+
+        /**
+         * Returns the background color used to clear the framebuffer.
+         *
+         * @return the background color
+         */
+        const Color4f& GetBackgroundColor() const {
+            return backgroundColor;
+        }
+
+        /**
+         * Enables or disables antialiased lines.
+         *
+         * @param b set to `true` to enable antialiasing
+         */
+        void SetAntialiasing(bool b) {
+            antialiasing = b;
+        }
+
+        /**
+         * Returns whether lines are rendered antialiased.
+         *
+         * @return `true` if antialiasing is enabled
+         */
+        bool IsAntialiasing() const {
+            return antialiasing;
+        }
+
+        /**
+         * Fills the framebuffer with the background color.
+         */
+        void Clear();
+
+        /**
+         * Draws a line using the current settings.
+         *
+         * The coordinates are specified in screen space, the view matrix
+         * is not applied.
+         *
+         * @param p0    the start point of the line
+         * @param p1    the end point of the line
+         * @param c     the color of the line
+         */
+        void DrawLine(const Vector2f& p0, const Vector2f& p1, const Color4f& c);
+
+        /**
+         * Provides raw access to the framebuffer.
+         *
+         * The pixels are stored row by row, four bytes per pixel in the
+         * order red, green, blue and alpha.
+         *
+         * @return pointer to the first pixel of the framebuffer
+         */
+        const uint8_t* GetPixels() const {
+            return framebuffer.data();
+        }
+
+        /**
+         * Copies the content of the framebuffer to the specified image.
+         *
+         * @param image the image which receives the pixels
+         * @throws std::domain_error in case the dimensions of the image do
+         *  not match the dimensions of the framebuffer
+         */
+        void CopyTo(Image& image) const;
+
+        /**
+         * Copies the content of the framebuffer to the specified 8-bit
+         * image without any conversion.
+         *
+         * @param image the image which receives the pixels
+         * @throws std::domain_error in case the dimensions of the image do
+         *  not match the dimensions of the framebuffer
+         */
+        void CopyTo(ImageRgba8& image) const;
+
+        // Inherited via SceneRenderer2D
+        virtual void Render(Polyline& polyline, float alpha) override;
+
+    private:
+        /** The width of the framebuffer in pixels. */
+        int width;
+
+        /** The height of the framebuffer in pixels. */
+        int height;
+
+        /** The framebuffer, four bytes per pixel. */
+        std::vector<uint8_t> framebuffer;
+
+        /** The view transformation. */
+        Matrix3f viewMatrix;
+
+        /** The background color. */
+        Color4f backgroundColor;
+
+        /** Whether lines are rendered antialiased. */
+        bool antialiasing;
+
+        /**
+         * Clips a line against the framebuffer boundaries.
+         *
+         * @param x0    the x-coordinate of the start point
+         * @param y0    the y-coordinate of the start point
+         * @param x1    the x-coordinate of the end point
+         * @param y1    the y-coordinate of the end point
+         * @return `true` if the line is at least partially visible
+         */
+        bool ClipLine(float& x0, float& y0, float& x1, float& y1) const;
+
+        /**
+         * Draws a clipped line without antialiasing.
+         *
+         * @param x0    the x-coordinate of the start point
+         * @param y0    the y-coordinate of the start point
+         * @param x1    the x-coordinate of the end point
+         * @param y1    the y-coordinate of the end point
+         * @param rgba  the color components within the range [0, 255]
+         */
+        void DrawLineBresenham(float x0, float y0, float x1, float y1, const int rgba[4]);
+
+        /**
+         * Draws a clipped line with antialiasing.
+         *
+         * @param x0    the x-coordinate of the start point
+         * @param y0    the y-coordinate of the start point
+         * @param x1    the x-coordinate of the end point
+         * @param y1    the y-coordinate of the end point
+         * @param rgba  the color components within the range [0, 255]
+         */
+        void DrawLineWu(float x0, float y0, float x1, float y1, const int rgba[4]);
+
+        /**
+         * Blends a pixel of the framebuffer with the specified color.
+         *
+         * Pixels outside the framebuffer are ignored.
+         *
+         * @param x         the x-coordinate of the pixel
+         * @param y         the y-coordinate of the pixel
+         * @param rgba      the color components within the range [0, 255]
+         * @param coverage  the pixel coverage within the range [0, 255]
+         */
+        void BlendPixel(int x, int y, const int rgba[4], int coverage) {
+            if (x < 0 || y < 0 || x >= width || y >= height) {
+                return;
+            }
+
+            const int a = (rgba[3] * coverage + 127) / 255;
+            if (a == 0) {
+                return;
+            }
+
+            uint8_t* p = &framebuffer[(static_cast<size_t>(y) * width + x) * 4];
+            const int ia = 255 - a;
+            p[0] = static_cast<uint8_t>((p[0] * ia + rgba[0] * a + 127) / 255);
+            p[1] = static_cast<uint8_t>((p[1] * ia + rgba[1] * a + 127) / 255);
+            p[2] = static_cast<uint8_t>((p[2] * ia + rgba[2] * a + 127) / 255);
+            p[3] = static_cast<uint8_t>(a + (p[3] * ia + 127) / 255);
+        }
+    };
+
+} // end of namespace
@@ -16,12 +16,14 @@
 #include "Math/Matrix3.h"
 #include "Math/Transform2.h"
 #include "Graphics/Color.h"
+#include "Util/ThreadPool.h"
 
 // C++ Standard Library includes
 #include <stdexcept>
 #include <vector>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace astu::suite2d {
 
@@ -67,7 +69,10 @@ namespace astu::suite2d {
      * 
      * @ingroup suite2d_group
      */
-    class Spatial : public Controllable {
+    class Spatial 
+        : public Controllable
+        , public std::enable_shared_from_this<Spatial> 
+    {
     public:
 
         /** Virtual destructor. */
@@ -85,11 +90,12 @@ namespace astu::suite2d {
         /**
          * Sets the name of this spatial.
          * 
+         * If an ancestor of this spatial maintains a name index, the index
+         * gets updated accordingly.
+         * 
          * @param _name  then name
          */
-        void SetName(const std::string & _name) {
-            name = _name;
-        }
+        void SetName(const std::string & _name);
 
         /**
          * Sets the local transformation of this spatial.
@@ -139,6 +145,38 @@ namespace astu::suite2d {
          */
         void Update(double dt);
 
+        /**
+         * Defines whether this spatial may be updated concurrently with
+         * its siblings.
+         * 
+         * Spatials which opt out are always updated sequentially on the
+         * calling thread. Parallel updates are enabled by default, but only
+         * take place if all controllers of this spatial (and its descendants)
+         * are thread-safe.
+         * 
+         * @param b set to `false` to opt out of parallel updates
+         */
+        void SetParallelUpdate(bool b) {
+            parallelUpdate = b;
+        }
+
+        /**
+         * Returns whether this spatial has opted in for parallel updates.
+         * 
+         * @return `true` if parallel updates are enabled for this spatial
+         */
+        bool IsParallelUpdate() const {
+            return parallelUpdate;
+        }
+
+        /**
+         * Tests whether this spatial can be updated concurrently with 
+         * its siblings.
+         * 
+         * @return `true` if this spatial can be updated concurrently
+         */
+        virtual bool CanUpdateConcurrently() const;
+
         /**
          * Renders this spacial.
          * 
@@ -198,6 +236,9 @@ namespace astu::suite2d {
         /** The transparancy. */
         float alpha;
 
+        /** Whether this spatial may be updated concurrently. */
+        bool parallelUpdate;
+
         /**
          * Constructor. 
          */ 
@@ -238,6 +279,15 @@ namespace astu::suite2d {
         /** The local transformation matrix of this spatial. */
         Matrix3f localMatrix;
 
+        /** The index of the slot this spatial occupies within its parent. */
+        size_t childIndex;
+
+        /**
+         * The positions of this spatial within the name indices of its
+         * ancestors, used to remove it from a name index in constant time.
+         */
+        std::vector<std::pair<const Node*, size_t>> nameIndexSlots;
+
         friend class Node;
     };
 
@@ -253,9 +303,21 @@ namespace astu::suite2d {
     class Node : public Spatial {
     public:
 
+        /**
+         * Constructor.
+         */
+        Node();
+
+        /**
+         * Destructor.
+         */
+        virtual ~Node();
+
         /**
          * Tests whether the specified spatial has alreaedy been added.
          * 
+         * This test takes constant time.
+         * 
          * @return child    the spatial to test
          * @return `true` if the spatial has already been added as child
          */
@@ -268,6 +330,8 @@ namespace astu::suite2d {
          * nor a child of this node, other wise the behaviour is undefied and
          * might result in an exception.
          * 
+         * Attaching a child takes constant (amortized) time.
+         * 
          * @param child the child to attach
          */
         void AttachChild(std::shared_ptr<Spatial> child);
@@ -278,6 +342,9 @@ namespace astu::suite2d {
          * The specified child node must be a child of this node otherwise
          * the behaviour is undefined and might result in an exception.
          * 
+         * Detaching a child takes constant (amortized) time and preserves
+         * the order of the remaining children.
+         * 
          * @param child the child to detach
          */
         void DetachChild(std::shared_ptr<Spatial> child);
@@ -306,6 +373,11 @@ namespace astu::suite2d {
         /**
          * Searches recursively for a child node with a specific name.
          * 
+         * If the name index of this node is enabled, the lookup takes
+         * constant time, otherwise the subtree is searched recursively.
+         * In case several descendants share the same name, it is unspecified
+         * which one of them will be returned.
+         * 
          * @param childName the name of the child node to search for
          * @return  the requested child or `nullptr` if no child with the 
          *          specified name has been found
@@ -322,17 +394,109 @@ namespace astu::suite2d {
          */
         std::shared_ptr<Spatial> FindChild(const std::string & childName);
 
+        /**
+         * Updates the geometric state using multiple threads.
+         * 
+         * The children of this node get partitioned into contiguous chunks 
+         * which are updated concurrently by the specified thread pool. 
+         * Children which cannot be updated concurrently (see
+         * Spatial::CanUpdateConcurrently()) are updated sequentially on
+         * the calling thread before the parallel update starts.
+         * 
+         * @param dt    the elapsed time since the last update in seconds
+         * @param pool  the thread pool used to update the children
+         */
+        void UpdateParallel(double dt, ThreadPool& pool);
+
+        /**
+         * Enables or disables the name index of this node.
+         * 
+         * The name index maps the names of all descendants of this node
+         * to the corresponding spatials and is kept up to date when children
+         * get attached, detached or renamed. It speeds up FindChild() and
+         * FindChildOrNull() at the cost of additional memory and slightly
+         * more expensive modifications of the subtree.
+         * 
+         * @param b set to `true` to enable the name index
+         */
+        void EnableNameIndex(bool b);
+
+        /**
+         * Returns whether the name index of this node is enabled.
+         * 
+         * @return `true` if the name index is enabled
+         */
+        bool IsNameIndexEnabled() const {
+            return nameIndexEnabled;
+        }
+
         // Inherited via Spatial2
         virtual void Render(SceneRenderer2D& renderer, float alpha) override;
         virtual std::shared_ptr<Spatial> Clone() const override;
+        virtual bool CanUpdateConcurrently() const override;
 
     protected:
         // Inherited via Spatial2
         virtual void UpdateTransform(double dt) override;
 
     private:
-        /** The children of this node. */
+        /** 
+         * The children of this node. Slots of detached children are vacant
+         * (`nullptr`) until the vector gets compacted.
+         */
         std::vector<std::shared_ptr<Spatial>> children;
+
+        /** The number of vacant slots within the children vector. */
+        size_t numVacantSlots;
+
+        /** Used to collect children which can be updated concurrently. */
+        std::vector<Spatial*> concurrentChildren;
+
+        /** Whether the name index of this node is enabled. */
+        bool nameIndexEnabled;
+
+        /** Maps the names of all descendants to the corresponding spatials. */
+        std::unordered_map<std::string, std::vector<Spatial*>> nameIndex;
+
+        /**
+         * Adds the specified spatial and all its descendants to the name
+         * index of this node.
+         * 
+         * @param spatial   the spatial to add
+         */
+        void AddToNameIndex(Spatial& spatial);
+
+        /**
+         * Removes the specified spatial and all its descendants from the name
+         * index of this node.
+         * 
+         * @param spatial   the spatial to remove
+         */
+        void RemoveFromNameIndex(Spatial& spatial);
+
+        /**
+         * Adds a single entry to the name index of this node.
+         * 
+         * @param name      the name under which to index the spatial
+         * @param spatial   the spatial to add
+         */
+        void AddNameIndexEntry(const std::string& name, Spatial& spatial);
+
+        /**
+         * Removes a single entry from the name index of this node.
+         * 
+         * @param name      the name under which the spatial has been indexed
+         * @param spatial   the spatial to remove
+         */
+        void RemoveNameIndexEntry(const std::string& name, Spatial& spatial);
+
+        /**
+         * Removes vacant slots from the children vector, preserving the
+         * order of the children.
+         */
+        void CompactChildren();
+
+        friend class Spatial;
     };
 
     // A possible intermediate class if leaf nodes, that share things.
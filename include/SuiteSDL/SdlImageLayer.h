@@ -0,0 +1,185 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+#pragma once
+
+// C++ Standard libraries includes
+#include <functional>
+#include <memory>
+
+// Local includes
+#include "SdlRenderService.h"
+#include "Graphics/Image.h"
+#include "Graphics/PixelImage.h"
+
+// Forward declaration.
+struct SDL_Texture;
+
+namespace astu {
+
+    /**
+     * A SDL render layer which displays software-rendered images.
+     *
+     * The images are converted directly into a streaming texture, which
+     * avoids drawing individual pixels and allows to display content such
+     * as fractals or ray-traced images at full frame rate. The image is
+     * shown until it gets replaced or cleared.
+     *
+     * **Example**
+     *
+     * ```
+     * ASTU_CREATE_AND_ADD_SERVICE(SdlImageLayer);
+     *
+     * // Within the update method of a service.
+     * RenderFractal(image);
+     * ASTU_SERVICE(SdlImageLayer).SetImage(image);
+     * ```
+     *
+     * @ingroup sdl_group
+     */
+    class SdlImageLayer final : public SdlRenderLayer {
+    public:
+
+        /**
+         * Constructor.
+         *
+         * @param renderPriority    the priority of this render layer
+         */
+        SdlImageLayer(int renderPriority = Priority::Normal);
+
+        /**
+         * Virtual destructor.
+         */
+        virtual ~SdlImageLayer();
+
+        /**
+         * Sets the image to display.
+         *
+         * The color components are clamped to the range [0, 1].
+         *
+         * @param image the image to display
+         */
+        void SetImage(const Image & image);
+
+        /**
+         * Sets the 8-bit image to display.
+         *
+         * @param image the image to display
+         */
+        void SetImage(const ImageRgba8 & image);
+
+        /**
+         * Sets the pixels to display.
+         *
+         * @param pixels    the pixels row by row without padding
+         * @param width     the width of the image in pixels
+         * @param height    the height of the image in pixels
+         * @throws std::domain_error in case the dimensions are invalid
+         */
+        void SetPixels(const Rgba8* pixels, int width, int height);
+
+        /**
+         * Removes the current image, nothing gets displayed afterwards.
+         */
+        void Clear();
+
+        /**
+         * Specifies whether the image gets stretched to the render target.
+         *
+         * @param b `true` to stretch the image, `false` to display it
+         *      pixel by pixel at the upper left corner
+         */
+        void SetStretchToTarget(bool b) {
+            stretch = b;
+        }
+
+        /**
+         * Returns whether the image gets stretched to the render target.
+         *
+         * @return `true` if the image gets stretched
+         */
+        bool IsStretchToTarget() const {
+            return stretch;
+        }
+
+        /**
+         * Specifies whether the image is blended using its alpha channel.
+         *
+         * Blending is disabled by default, which renders opaque images
+         * faster.
+         *
+         * @param b `true` to enable blending
+         */
+        void SetBlending(bool b);
+
+        /**
+         * Returns whether the image is blended using its alpha channel.
+         *
+         * @return `true` if blending is enabled
+         */
+        bool IsBlending() const {
+            return blending;
+        }
+
+        // Inherited via SdlRenderLayer
+        virtual void OnRender(SDL_Renderer* renderer) override;
+
+    protected:
+
+        // Inherited via SdlRenderLayer
+        virtual void OnStartup() override;
+        virtual void OnShutdown() override;
+
+    private:
+        /** Type alias for functions which convert one row of the image. */
+        using RowConverter = std::function<void(int y, Rgba8* dst)>;
+
+        /** The streaming texture, created by the first call to OnRender. */
+        SDL_Texture* texture;
+
+        /** The width of the texture in pixels. */
+        int textureWidth;
+
+        /** The height of the texture in pixels. */
+        int textureHeight;
+
+        /** Receives images as long as no texture of matching size exists. */
+        std::unique_ptr<ImageRgba8> staging;
+
+        /** Whether an image is displayed. */
+        bool hasImage;
+
+        /** Whether the image gets stretched to the render target. */
+        bool stretch;
+
+        /** Whether the image is blended using its alpha channel. */
+        bool blending;
+
+        /**
+         * Converts an image into the texture or the staging image.
+         *
+         * @param width     the width of the image
+         * @param height    the height of the image
+         * @param convert   converts the rows of the image
+         */
+        void Update(int width, int height, const RowConverter & convert);
+
+        /**
+         * Copies the staging image to the texture, recreates the texture
+         * if required.
+         *
+         * @param renderer  the SDL renderer owning the texture
+         */
+        void UploadStaging(SDL_Renderer* renderer);
+
+        /**
+         * Releases the texture.
+         */
+        void DestroyTexture();
+    };
+
+} // end of namespace
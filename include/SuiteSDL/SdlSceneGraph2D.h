@@ -15,6 +15,7 @@
 #include "Suite2D/CameraService.h"
 #include "Service/TimeService.h"
 #include "Service/UpdateService.h"
+#include "Util/ThreadPool.h"
 
 // C++ Standard libraries includes
 #include <memory>
@@ -83,6 +84,27 @@ namespace astu {
         /** Virtual destructor. */
         virtual ~SdlSceneGraph2D();
 
+        /**
+         * Enables or disables the parallel update of the scene graph.
+         * 
+         * If enabled, the children of the root node are updated 
+         * concurrently, see suite2d::Node::UpdateParallel().
+         * 
+         * @param b             set to `true` to enable parallel updates
+         * @param numThreads    the number of threads, zero selects the
+         *                      number of hardware threads
+         */
+        void EnableParallelUpdate(bool b, size_t numThreads = 0);
+
+        /**
+         * Returns whether the scene graph is updated in parallel.
+         * 
+         * @return `true` if parallel updates are enabled
+         */
+        bool IsParallelUpdate() const {
+            return threadPool != nullptr;
+        }
+
         // Inherited via Updatable
         virtual void OnUpdate() override;
 
@@ -94,6 +116,9 @@ namespace astu {
     private:
         /** The scene renderer used to render the scene graph. */
         std::unique_ptr<SdlSceneRenderer2D> sceneRenderer;
+
+        /** The thread pool used for parallel updates, if enabled. */
+        std::unique_ptr<ThreadPool> threadPool;
     };
 
 } // end of namespace
\ No newline at end of file
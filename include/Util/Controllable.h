@@ -28,6 +28,13 @@ namespace astu {
         bool HasController(std::shared_ptr<Controller> ctrl);
         void UpdateControllers(double dt);
 
+        /**
+         * Tests whether all attached controllers are thread-safe.
+         * 
+         * @return `true` if all controllers are thread-safe
+         */
+        bool HasOnlyThreadSafeControllers() const;
+
     private:
         /** The controllers attached to this object. */
         std::vector<std::shared_ptr<Controller>> controllers;
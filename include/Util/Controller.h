@@ -41,6 +41,19 @@ namespace astu {
 
         virtual void Update(double dt);
 
+        /**
+         * Returns whether this controller may be updated concurrently with
+         * controllers of other objects.
+         * 
+         * Thread-safe controllers must only modify the controllable they
+         * are attached to.
+         * 
+         * @return `true` if this controller is thread-safe
+         */
+        virtual bool IsThreadSafe() const {
+            return false;
+        }
+
     private:
         /** The controllable controlled to be controlled. */
         Controllable* controllable;
@@ -0,0 +1,111 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ * 
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+#pragma once
+
+// C++ Standard Library includes
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace astu {
+
+    /**
+     * A fixed-size pool of worker threads which execute submitted tasks.
+     * 
+     * @ingroup misc_group
+     */
+    class ThreadPool {
+    public:
+
+        /**
+         * Constructor.
+         * 
+         * @param numThreads    the number of worker threads, zero selects
+         *                      the number of hardware threads
+         */
+        explicit ThreadPool(size_t numThreads = 0);
+
+        /**
+         * Destructor.
+         * 
+         * Waits for all pending tasks to be finished.
+         */
+        ~ThreadPool();
+
+        /** Copying is not allowed. */
+        ThreadPool(const ThreadPool&) = delete;
+
+        /** Copy assignment is not allowed. */
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * Returns the number of worker threads.
+         * 
+         * @return the number of worker threads
+         */
+        size_t GetNumThreads() const {
+            return workers.size();
+        }
+
+        /**
+         * Submits a task to be executed by one of the worker threads.
+         * 
+         * Exceptions thrown by the task are reported by the returned future.
+         * 
+         * @param task  the task to execute
+         * @return a future which becomes ready once the task has been executed
+         */
+        std::future<void> Submit(std::function<void()> task);
+
+        /**
+         * Splits a range of indices into contiguous chunks and processes
+         * them concurrently.
+         * 
+         * This method blocks until all chunks have been processed. The
+         * calling thread processes one of the chunks itself. Exceptions
+         * thrown by the function are re-thrown by this method. This method
+         * must not be called from within a task executed by this pool.
+         * 
+         * @param begin     the first index of the range
+         * @param end       the index one past the last index of the range
+         * @param func      the function which processes a chunk `[b, e)`
+         * @param minChunk  the minimum number of indices per chunk
+         */
+        void ParallelFor(
+            size_t begin, 
+            size_t end, 
+            const std::function<void(size_t, size_t)>& func, 
+            size_t minChunk = 1);
+
+    private:
+        /** The worker threads. */
+        std::vector<std::thread> workers;
+
+        /** The pending tasks. */
+        std::queue<std::packaged_task<void()>> tasks;
+
+        /** Protects the task queue. */
+        std::mutex mutex;
+
+        /** Used to signal new tasks or termination to the workers. */
+        std::condition_variable condition;
+
+        /** Whether the workers should terminate. */
+        bool terminate;
+
+        /**
+         * The main loop of the worker threads.
+         */
+        void RunWorker();
+    };
+
+} // end of namespace
@@ -8,10 +8,20 @@
 #include <cassert>
 #include <map>
 #include <iostream>
+#include <vector>
 #include "Graphics/Image.h"
-#include "Graphics/BmpCodec.h"
+#include "AstuGraphics.h"
 #include "AstUtils1.h"
 
+/** The number of handle bits used for the slot index. */
+#define SLOT_BITS 20
+
+/** Extracts the slot index (plus one) from a handle. */
+#define SLOT_MASK ((1 << SLOT_BITS) - 1)
+
+/** The maximum generation which fits into a handle. */
+#define MAX_GENERATION ((1 << (31 - SLOT_BITS)) - 1)
+
 namespace astu1 {
 
     struct RgbFloatData {
@@ -20,17 +30,26 @@ namespace astu1 {
     };
 
 
-    /** The global storage for images, associated with handles. */
-    static std::map<int, std::unique_ptr<astu::Image>> images;
+    /** An entry of the global image storage. */
+    struct ImageSlot {
+        /** The image, `nullptr` for unused slots. */
+        std::unique_ptr<astu::Image> image;
 
-    /** Used to read BMP files. */
-    static astu::BmpDecoder bmpDecoder;
+        /** Incremented whenever the slot gets freed, invalidates old handles. */
+        int generation;
+
+        /** The number of locks held for the image. */
+        int lockCount;
+    };
 
-    /** Used to write BMP files. */
-    static astu::BmpEncoder bmpEncoder;
+    /** 
+     * The global storage for images. A handle consists of the slot index 
+     * plus one and the generation of the slot.
+     */
+    static std::vector<ImageSlot> imageSlots;
 
-    /** Incremented to create new unique image handles. */
-    static int imageCounter = 0;
+    /** The indices of unused slots. */
+    static std::vector<size_t> freeSlots;
 
     /** Used to store additional information about extracted RGB float data. */
     static std::map<float*, RgbFloatData> rgbFloatDataMap;
@@ -53,14 +72,58 @@ namespace astu1 {
     /////// Internal Utility Functions
     /////////////////////////////////////////////////
 
-    bool HasImage(int hImg)
+    void SetLastErrorX(const std::string & txt)
     {
-        return images.find(hImg) != images.end();
+        lastErrorText = txt;
     }
 
-    void SetLastErrorX(const std::string & txt)
+    ImageSlot* FindSlot(int hImg)
     {
-        lastErrorText = txt;
+        if (hImg <= 0) {
+            return nullptr;
+        }
+
+        const size_t idx = static_cast<size_t>(hImg & SLOT_MASK) - 1;
+        if (idx >= imageSlots.size()) {
+            return nullptr;
+        }
+
+        ImageSlot & slot = imageSlots[idx];
+        if (!slot.image || slot.generation != (hImg >> SLOT_BITS)) {
+            return nullptr;
+        }
+        return &slot;
+    }
+
+    astu::Image* FindImage(int hImg)
+    {
+        ImageSlot* slot = FindSlot(hImg);
+        if (!slot) {
+            SetLastErrorX("invalid image handle");
+            return nullptr;
+        }
+        return slot->image.get();
+    }
+
+    int AddImage(std::unique_ptr<astu::Image> image)
+    {
+        size_t idx;
+        if (!freeSlots.empty()) {
+            idx = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            if (imageSlots.size() >= SLOT_MASK) {
+                SetLastErrorX("too many images");
+                return INVALID_HANDLE;
+            }
+            imageSlots.push_back({nullptr, 0, 0});
+            idx = imageSlots.size() - 1;
+        }
+
+        ImageSlot & slot = imageSlots[idx];
+        slot.image = std::move(image);
+        slot.lockCount = 0;
+        return (slot.generation << SLOT_BITS) | static_cast<int>(idx + 1);
     }
 
     bool hasRgbFloatData(float *ptr)
@@ -113,11 +176,8 @@ namespace astu1 {
 
     int LoadImage(const char *filename) 
     {
-        assert(!HasImage(imageCounter + 1));
-
         try {
-            images[++imageCounter] = bmpDecoder.Decode(filename);
-            return imageCounter;
+            return AddImage(astu::LoadImage(filename));
         } catch (std::runtime_error & e) {
             std::cerr << e.what() << std::endl;
             SetLastErrorX(e.what());
@@ -128,20 +188,18 @@ namespace astu1 {
 
     int CreateImage(int width, int height)
     {
-        images[++imageCounter] = std::make_unique<astu::Image>(width, height);
-        return imageCounter;
+        return AddImage(std::make_unique<astu::Image>(width, height));
     }
 
     int StoreImage(int hImg, const char *filename)
     {
-        auto it = images.find(hImg);
-        if (it == images.end())  {
-            SetLastErrorX("invalid image handle");
+        auto image = FindImage(hImg);
+        if (!image)  {
             return ERR_FAILED;
         }
 
         try {
-            bmpEncoder.Encode(*it->second, filename);
+            astu::StoreImage(*image, filename);
         } catch (std::runtime_error & e) {
             SetLastErrorX(e.what());
             return ERR_FAILED;
@@ -152,57 +210,61 @@ namespace astu1 {
 
     int DestroyImage(int hImg)
     {
-        auto it = images.find(hImg);
-        if (it == images.end()) {
+        auto slot = FindSlot(hImg);
+        if (!slot) {
             SetLastErrorX("invalid image handle");
             return ERR_FAILED;
         }
-        images.erase(it);
+
+        if (slot->lockCount > 0) {
+            SetLastErrorX("image is locked");
+            return ERR_FAILED;
+        }
+
+        slot->image = nullptr;
+        slot->generation = (slot->generation + 1) & MAX_GENERATION;
+        freeSlots.push_back(static_cast<size_t>(hImg & SLOT_MASK) - 1);
         return ERR_SUCCESS;
     } 
 
     int GetImageWidth(int hImg)
     {
-        auto it = images.find(hImg);
-        if (it == images.end()) {
-            SetLastErrorX("invalid image handle");
+        auto image = FindImage(hImg);
+        if (!image) {
             return ERR_FAILED;
         }
 
-        return it->second->GetWidth();
+        return image->GetWidth();
     }
 
     int GetImageHeight(int hImg)
     {
-        auto it = images.find(hImg);
-        if (it == images.end()) {
-            SetLastErrorX("invalid image handle");
+        auto image = FindImage(hImg);
+        if (!image) {
             return ERR_FAILED;
         }
 
-        return it->second->GetHeight();
+        return image->GetHeight();
     }
 
     astu::Color4d GetPixel(int hImg, int x, int y)
     {
-        auto it = images.find(hImg);
-        if (it == images.end()) {
-            SetLastErrorX("invalid image handle");
+        auto image = FindImage(hImg);
+        if (!image) {
             return ERR_FAILED;
         }
 
-        return it->second->GetPixel(x, y);
+        return image->GetPixel(x, y);
     }
 
 
     float* ExportRgbFloats(int hImg)
     {
-        auto it = images.find(hImg);
-        if (it == images.end()) {
-            SetLastErrorX("invalid image handle");
+        auto pImage = FindImage(hImg);
+        if (!pImage) {
             return nullptr;
         }
-        astu::Image & image = *it->second;
+        astu::Image & image = *pImage;
 
         auto result = AllocateRgbFloatData(image.GetWidth(), image.GetHeight());
         if (!result) {
@@ -210,14 +272,13 @@ namespace astu1 {
             return nullptr;
         }
 
-        float *ptr = result;
-        for (int j = 0; j < image.GetHeight(); ++j) {
-            for (int i = 0; i < image.GetWidth(); ++i) {
-                auto & c = image.GetPixel(i, j);
-                *ptr++ = static_cast<float>(c.r);
-                *ptr++ = static_cast<float>(c.g);
-                *ptr++ = static_cast<float>(c.b);
-            }
+        // The pixels are contiguous, no need to access them one by one.
+        const double* src = &image.GetPixels()->r;
+        const size_t n = image.NumberOfPixels();
+        for (size_t i = 0; i < n; ++i) {
+            result[i * 3] = static_cast<float>(src[i * 4]);
+            result[i * 3 + 1] = static_cast<float>(src[i * 4 + 1]);
+            result[i * 3 + 2] = static_cast<float>(src[i * 4 + 2]);
         }
 
         return result;
@@ -231,30 +292,70 @@ namespace astu1 {
             return ERR_FAILED;
         }
 
-        auto it2 = images.find(hImg);
-        if (it2 == images.end()) {
-            SetLastErrorX("invalid image handle");
+        auto pImage = FindImage(hImg);
+        if (!pImage) {
             return ERR_FAILED;
         }
 
         const auto & rgbFloat = it1->second;
-        auto & image = *it2->second;
+        auto & image = *pImage;
 
         if (rgbFloat.width != image.GetWidth() || rgbFloat.height != image.GetHeight()) {
             SetLastErrorX("invalid image size");
             return ERR_FAILED;
         } 
 
-        for (int j = 0; j < image.GetHeight(); ++j) {
-            for (int i = 0; i < image.GetWidth(); ++i) {
-                astu::Color4d c;
-                c.r = *ptr++;
-                c.g = *ptr++;
-                c.b = *ptr++;
-                image.SetPixel(i, j, c);
-            }
-        }        
+        // Alpha gets reset to one, like for pixels created from RGB values.
+        double* dst = &image.GetPixels()->r;
+        const size_t n = image.NumberOfPixels();
+        for (size_t i = 0; i < n; ++i) {
+            dst[i * 4] = ptr[i * 3];
+            dst[i * 4 + 1] = ptr[i * 3 + 1];
+            dst[i * 4 + 2] = ptr[i * 3 + 2];
+            dst[i * 4 + 3] = 1.0;
+        }
+
+        return ERR_SUCCESS;
+    }
+
+    int LockImage(int hImg, ImageView* view)
+    {
+        auto slot = FindSlot(hImg);
+        if (!slot) {
+            SetLastErrorX("invalid image handle");
+            return ERR_FAILED;
+        }
+
+        if (!view) {
+            SetLastErrorX("image view must not be null");
+            return ERR_FAILED;
+        }
+
+        astu::Image & image = *slot->image;
+        view->data = &image.GetPixels()->r;
+        view->width = image.GetWidth();
+        view->height = image.GetHeight();
+        view->pixelStride = 4;
+        view->rowStride = image.GetWidth() * 4;
+        ++slot->lockCount;
+
+        return ERR_SUCCESS;
+    }
+
+    int UnlockImage(int hImg)
+    {
+        auto slot = FindSlot(hImg);
+        if (!slot) {
+            SetLastErrorX("invalid image handle");
+            return ERR_FAILED;
+        }
+
+        if (slot->lockCount <= 0) {
+            SetLastErrorX("image is not locked");
+            return ERR_FAILED;
+        }
 
+        --slot->lockCount;
         return ERR_SUCCESS;
     }
 
@@ -0,0 +1,112 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+// Local includes
+#include "Graphics/AccumulationBuffer.h"
+
+// C++ Standard Library includes
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace astu {
+
+    // The loops treat pixels and sums as flat arrays of components, which
+    // allows the compiler to vectorize them.
+
+    AccumulationBuffer::AccumulationBuffer(int w, int h)
+        : width(w)
+        , height(h)
+        , numImages(0)
+    {
+        if (w <= 0) {
+            throw std::domain_error("Buffer width must be greater zero, got "
+                + std::to_string(w));
+        }
+
+        if (h <= 0) {
+            throw std::domain_error("Buffer height must be greater zero, got "
+                + std::to_string(h));
+        }
+
+        sums.resize(static_cast<size_t>(w) * h * 4, 0.0f);
+    }
+
+    void AccumulationBuffer::Clear()
+    {
+        std::fill(sums.begin(), sums.end(), 0.0f);
+        numImages = 0;
+    }
+
+    void AccumulationBuffer::Add(const Image & image)
+    {
+        ValidateDimensions(image.GetWidth(), image.GetHeight());
+
+        const double* src = &image.GetPixels()->r;
+        float* dst = sums.data();
+        const size_t n = sums.size();
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] += static_cast<float>(src[i]);
+        }
+        ++numImages;
+    }
+
+    void AccumulationBuffer::Add(const ImageRgba8 & image)
+    {
+        ValidateDimensions(image.GetWidth(), image.GetHeight());
+
+        const uint8_t* src = &image.GetPixels()->r;
+        float* dst = sums.data();
+        const size_t n = sums.size();
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] += src[i] * (1.0f / 255.0f);
+        }
+        ++numImages;
+    }
+
+    void AccumulationBuffer::Resolve(Image & result) const
+    {
+        ValidateResolve(result.GetWidth(), result.GetHeight());
+
+        const float scale = 1.0f / numImages;
+        const float* src = sums.data();
+        double* dst = &result.GetPixels()->r;
+        const size_t n = sums.size();
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = src[i] * scale;
+        }
+    }
+
+    void AccumulationBuffer::Resolve(ImageRgba8 & result) const
+    {
+        ValidateResolve(result.GetWidth(), result.GetHeight());
+
+        const float scale = 255.0f / numImages;
+        const float* src = sums.data();
+        uint8_t* dst = &result.GetPixels()->r;
+        const size_t n = sums.size();
+        for (size_t i = 0; i < n; ++i) {
+            dst[i] = static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, src[i] * scale)) + 0.5f);
+        }
+    }
+
+    void AccumulationBuffer::ValidateDimensions(int w, int h) const
+    {
+        if (w != width || h != height) {
+            throw std::domain_error("Image dimensions do not match accumulation buffer");
+        }
+    }
+
+    void AccumulationBuffer::ValidateResolve(int w, int h) const
+    {
+        ValidateDimensions(w, h);
+        if (numImages == 0) {
+            throw std::domain_error("Unable to resolve accumulation buffer, no images accumulated");
+        }
+    }
+
+} // end of namespace
@@ -13,6 +13,12 @@
 // Local includes    
 #include "AstuGraphics.h"
 #include "Graphics/BmpCodec.h"
+#include "Graphics/PngCodec.h"
+#include "Graphics/QoiCodec.h"
+
+// C++ Standard Library includes
+#include <algorithm>
+#include <cctype>
 
 namespace astu {
 
@@ -22,13 +28,52 @@ namespace astu {
     /** Used to write BMP files. */
     static astu::BmpEncoder bmpEncoder;
 
-    void StoreImage(const Image & image, const std::string & filename)
+    /** Used to read PNG files. */
+    static astu::PngDecoder pngDecoder;
+
+    /** Used to read QOI files. */
+    static astu::QoiDecoder qoiDecoder;
+
+    /** Used to write QOI files. */
+    static astu::QoiEncoder qoiEncoder;
+
+    /**
+     * Tests whether a filename ends with the specified lower-case extension.
+     */
+    static bool HasExtension(const std::string & filename, const std::string & ext)
     {
-        bmpEncoder.Encode(image, filename.c_str());
+        if (filename.size() < ext.size()) {
+            return false;
+        }
+
+        return std::equal(ext.begin(), ext.end(), filename.end() - ext.size(), 
+            [](char a, char b) { 
+                return a == std::tolower(static_cast<unsigned char>(b)); 
+            });
+    }
+
+    void StoreImage(const Image & image, const std::string & filename, int compressionLevel)
+    {
+        if (HasExtension(filename, ".png")) {
+            // Encoders are configured per call to keep this function thread-safe.
+            PngEncoder pngEncoder;
+            pngEncoder.SetCompressionLevel(compressionLevel);
+            pngEncoder.Encode(image, filename.c_str());
+        } else if (HasExtension(filename, ".qoi")) {
+            qoiEncoder.Encode(image, filename.c_str());
+        } else {
+            bmpEncoder.Encode(image, filename.c_str());
+        }
     }
 
     std::unique_ptr<Image> LoadImage(const std::string & filename)
     {
+        if (HasExtension(filename, ".png")) {
+            return pngDecoder.Decode(filename.c_str());
+        } else if (HasExtension(filename, ".qoi")) {
+            return qoiDecoder.Decode(filename.c_str());
+        }
+
         return bmpDecoder.Decode(filename.c_str());  
     }
 
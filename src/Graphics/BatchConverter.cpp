@@ -0,0 +1,280 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+// Local includes
+#include "Graphics/BatchConverter.h"
+#include "Graphics/BmpCodec.h"
+#include "Graphics/PngCodec.h"
+#include "Graphics/QoiCodec.h"
+#include "Util/ThreadPool.h"
+
+// C++ Standard Library includes
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <map>
+#include <stdexcept>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace astu {
+
+    /////////////////////////////////////////////////
+    /////// Helper functions
+    /////////////////////////////////////////////////
+
+    static string ToLower(string s)
+    {
+        std::transform(s.begin(), s.end(), s.begin(),
+            [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+        return s;
+    }
+
+    /**
+     * Returns the lower-case extension of a filename without the dot.
+     */
+    static string GetExtension(const string & filename)
+    {
+        string ext = fs::path(filename).extension().string();
+        return ext.empty() ? ext : ToLower(ext.substr(1));
+    }
+
+    static bool IsSupportedExtension(const string & ext)
+    {
+        return ext == "bmp" || ext == "png" || ext == "qoi";
+    }
+
+    static void CreateDirectory(const string & directory)
+    {
+        std::error_code ec;
+        fs::create_directories(directory, ec);
+        if (ec) {
+            throw std::runtime_error("Unable to create directory '" + directory
+                + "': " + ec.message());
+        }
+    }
+
+    /////////////////////////////////////////////////
+    /////// BatchConverter::Worker
+    /////////////////////////////////////////////////
+
+    struct BatchConverter::Worker {
+        BmpDecoder bmpDecoder;
+        BmpEncoder bmpEncoder;
+        PngDecoder pngDecoder;
+        PngEncoder pngEncoder;
+        QoiDecoder qoiDecoder;
+        QoiEncoder qoiEncoder;
+
+        /** The statistics of the files converted by this worker. */
+        BatchStatistics stats;
+
+        Worker(int compressionLevel) {
+            pngEncoder.SetCompressionLevel(compressionLevel);
+        }
+
+        unique_ptr<Image> Decode(const string & filename) const {
+            const string ext = GetExtension(filename);
+            if (ext == "bmp") {
+                return bmpDecoder.Decode(filename.c_str());
+            } else if (ext == "png") {
+                return pngDecoder.Decode(filename.c_str());
+            } else if (ext == "qoi") {
+                return qoiDecoder.Decode(filename.c_str());
+            }
+
+            throw std::domain_error("Unsupported file extension '" + ext + "'");
+        }
+
+        void Encode(const Image & image, const string & filename) const {
+            const string ext = GetExtension(filename);
+            if (ext == "bmp") {
+                bmpEncoder.Encode(image, filename.c_str());
+            } else if (ext == "png") {
+                pngEncoder.Encode(image, filename.c_str());
+            } else if (ext == "qoi") {
+                qoiEncoder.Encode(image, filename.c_str());
+            } else {
+                throw std::domain_error("Unsupported file extension '" + ext + "'");
+            }
+        }
+
+        void Convert(const string & input, const string & output, const Transform & transform) {
+            auto image = Decode(input);
+            if (transform) {
+                transform(*image);
+            }
+            Encode(*image, output);
+
+            ++stats.numFrames;
+            stats.bytesRead += fs::file_size(input);
+            stats.bytesWritten += fs::file_size(output);
+        }
+
+        /**
+         * Converts files until all files have been taken by the workers.
+         */
+        void Run(const vector<pair<string, string>> & jobs, const Transform & transform, 
+            atomic<size_t> & next)
+        {
+            size_t i;
+            while ((i = next.fetch_add(1)) < jobs.size()) {
+                const string & input = jobs[i].first;
+                try {
+                    Convert(input, jobs[i].second, transform);
+                } catch (const std::exception & e) {
+                    ++stats.numFailed;
+                    stats.errors.push_back(input + ": " + e.what());
+                }
+            }
+        }
+    };
+
+    /////////////////////////////////////////////////
+    /////// BatchConverter
+    /////////////////////////////////////////////////
+
+    BatchConverter::BatchConverter(size_t numThreads)
+        : numThreads(numThreads)
+        , outputExtension("bmp")
+        , compressionLevel(6)
+    {
+        // Intentionally left empty.
+    }
+
+    BatchConverter::~BatchConverter()
+    {
+        // Intentionally left empty.
+    }
+
+    void BatchConverter::SetNumThreads(size_t n)
+    {
+        if (n != numThreads) {
+            numThreads = n;
+            threadPool = nullptr;
+        }
+    }
+
+    void BatchConverter::SetOutputExtension(const std::string & extension)
+    {
+        const string ext = ToLower(extension);
+        if (!IsSupportedExtension(ext)) {
+            throw std::domain_error("Unsupported output file extension '" + extension
+                + "', expected bmp, png or qoi");
+        }
+        outputExtension = ext;
+    }
+
+    void BatchConverter::SetCompressionLevel(int level)
+    {
+        if (level < 0 || level > 9) {
+            throw std::domain_error("Compression level must be within [0, 9], got "
+                + std::to_string(level));
+        }
+        compressionLevel = level;
+    }
+
+    BatchStatistics BatchConverter::Convert(
+        const std::vector<std::string> & filenames, const std::string & outputDirectory)
+    {
+        CreateDirectory(outputDirectory);
+
+        // Input files with equal names but different extensions would be
+        // converted to the same output file, only the first one of them 
+        // gets converted.
+        BatchStatistics result;
+        vector<pair<string, string>> jobs;
+        map<string, string> outputToInput;
+        for (const auto & input : filenames) {
+            fs::path output = fs::path(outputDirectory) / fs::path(input).stem();
+            output += "." + outputExtension;
+
+            auto it = outputToInput.insert(make_pair(output.string(), input));
+            if (it.second) {
+                jobs.push_back(make_pair(input, output.string()));
+            } else {
+                ++result.numFailed;
+                result.errors.push_back(input + ": output file '" + output.string() 
+                    + "' is already produced by '" + it.first->second + "'");
+            }
+        }
+
+        if (numThreads != 1 && !threadPool) {
+            // The calling thread runs one worker itself.
+            threadPool = std::make_unique<ThreadPool>(
+                numThreads == 0 ? 0 : numThreads - 1);
+        }
+
+        // Each worker holds at most one image at a time, which bounds the
+        // memory consumption regardless of the number of files.
+        const size_t numWorkers = std::min(jobs.size(),
+            threadPool ? threadPool->GetNumThreads() + 1 : 1);
+        vector<Worker> workers(numWorkers, Worker(compressionLevel));
+
+        atomic<size_t> next(0);
+        const auto startTime = std::chrono::steady_clock::now();
+
+        vector<future<void>> done;
+        for (size_t i = 1; i < numWorkers; ++i) {
+            Worker & worker = workers[i];
+            done.push_back(threadPool->Submit([&, this]() {
+                worker.Run(jobs, transform, next);
+            }));
+        }
+        if (numWorkers > 0) {
+            workers[0].Run(jobs, transform, next);
+        }
+        for (auto & f : done) {
+            f.get();
+        }
+
+        result.seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - startTime).count();
+
+        for (auto & worker : workers) {
+            result.numFrames += worker.stats.numFrames;
+            result.numFailed += worker.stats.numFailed;
+            result.bytesRead += worker.stats.bytesRead;
+            result.bytesWritten += worker.stats.bytesWritten;
+            result.errors.insert(result.errors.end(),
+                worker.stats.errors.begin(), worker.stats.errors.end());
+        }
+
+        return result;
+    }
+
+    BatchStatistics BatchConverter::ConvertDirectory(
+        const std::string & inputDirectory, const std::string & outputDirectory)
+    {
+        vector<string> filenames;
+        std::error_code ec;
+        for (fs::directory_iterator it(inputDirectory, ec), end; !ec && it != end; it.increment(ec)) {
+            if (!it->is_regular_file()) {
+                continue;
+            }
+
+            const string filename = it->path().string();
+            const string ext = GetExtension(filename);
+            if (IsSupportedExtension(ext)) {
+                filenames.push_back(filename);
+            }
+        }
+
+        if (ec) {
+            throw std::runtime_error("Unable to read directory '" + inputDirectory
+                + "': " + ec.message());
+        }
+
+        std::sort(filenames.begin(), filenames.end());
+        return Convert(filenames, outputDirectory);
+    }
+
+} // end of namespace
@@ -9,9 +9,12 @@
 #include "Graphics/BmpCodec.h"
 #include "Graphics/Color.h"
 #include "Graphics/Image.h"
+#include "Graphics/PixelImage.h"
 
 // C++ Standard Library includes
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <fstream>
 #include <string>
 #include <stdexcept>
@@ -23,6 +26,9 @@
 
 #define BYTES_PER_PIXEL 3
 
+/** The preferred number of bytes written to the output stream at once. */
+#define IO_BLOCK_SIZE (1 << 20)
+
 #pragma pack(push, 1)
 
 // Note: Bitmap file format uses Little-endian. This code does assume that
@@ -87,173 +93,317 @@ namespace astu {
         flipVertically = flip;
     }
 
-    void BmpEncoder::Encode(const Image & image, std::ostream& os) const
+    /**
+     * Packs a row of pixels into BGR triples.
+     */
+    static void PackRow(const Color4d* src, unsigned char* dst, int width)
+    {
+        for (int i = 0; i < width; ++i) {
+            // Truncate like Color::GetARGB(), but saturate first.
+            dst[0] = static_cast<unsigned char>(std::min(1.0, std::max(0.0, src[i].b)) * 255);
+            dst[1] = static_cast<unsigned char>(std::min(1.0, std::max(0.0, src[i].g)) * 255);
+            dst[2] = static_cast<unsigned char>(std::min(1.0, std::max(0.0, src[i].r)) * 255);
+            dst += BYTES_PER_PIXEL;
+        }
+    }
+
+    /**
+     * Packs a row of pixels into BGR triples.
+     */
+    static void PackRow(const Rgba8* src, unsigned char* dst, int width)
     {
-		// Each line must contain number of bytes dividable by four.
-		int numPadding = CalcNumPadding(image.GetWidth(), BYTES_PER_PIXEL);
-
-		// The size of the image in bytes (including ling padding)
-		unsigned int sizeOfImage = image.GetHeight() * (image.GetWidth() * BYTES_PER_PIXEL + numPadding);
-
-		// Initialize file header.
-		BitmapFileHeader fh;
-		fh.bfType = 0x4d42;
-		fh.bfSize = sizeof(BitmapFileHeader) + sizeof(BitmapInfoHeader) + sizeOfImage;
-		fh.bfReserved = 0;
-		fh.bfOffBits = sizeof(BitmapFileHeader) + sizeof(BitmapInfoHeader);
-
-		// Initialize info header.
-		BitmapInfoHeader ih;
-		ih.biSize = sizeof(BitmapInfoHeader);
-		ih.biWidth = image.GetWidth();
-		ih.biHeight = image.GetHeight();
-		ih.biPlanes = 1;
-		ih.biBitCount = BYTES_PER_PIXEL * 8;
-		ih.biCompression = BI_RGB;
-		ih.biSizeImage = sizeOfImage;
-		ih.biXPelsPerMeter = 0;
-		ih.biYPelsPerMeter = 0;
-		ih.biClrUsed = 0;
-		ih.biClrImportant = 0;
-        
-		// Write header information
+        for (int i = 0; i < width; ++i) {
+            dst[0] = src[i].b;
+            dst[1] = src[i].g;
+            dst[2] = src[i].r;
+            dst += BYTES_PER_PIXEL;
+        }
+    }
+
+    /**
+     * Writes the headers and pixel data of a BMP file.
+     * 
+     * Rows are converted into a buffer which is written in large blocks.
+     */
+    template <typename I>
+    static void WriteBmp(const I & image, bool flip, std::ostream& os)
+    {
+        const int width = image.GetWidth();
+        const int height = image.GetHeight();
+
+        // Each line must contain number of bytes dividable by four.
+        const size_t numPadding = CalcNumPadding(width, BYTES_PER_PIXEL);
+        const size_t rowSize = width * BYTES_PER_PIXEL + numPadding;
+
+        // The size of the image in bytes (including line padding)
+        const size_t sizeOfImage = height * rowSize;
+
+        // Initialize file header.
+        BitmapFileHeader fh;
+        fh.bfType = 0x4d42;
+        fh.bfSize = static_cast<uint32_t>(sizeof(BitmapFileHeader) + sizeof(BitmapInfoHeader) + sizeOfImage);
+        fh.bfReserved = 0;
+        fh.bfOffBits = sizeof(BitmapFileHeader) + sizeof(BitmapInfoHeader);
+
+        // Initialize info header.
+        BitmapInfoHeader ih;
+        ih.biSize = sizeof(BitmapInfoHeader);
+        ih.biWidth = width;
+        ih.biHeight = height;
+        ih.biPlanes = 1;
+        ih.biBitCount = BYTES_PER_PIXEL * 8;
+        ih.biCompression = BI_RGB;
+        ih.biSizeImage = static_cast<uint32_t>(sizeOfImage);
+        ih.biXPelsPerMeter = 0;
+        ih.biYPelsPerMeter = 0;
+        ih.biClrUsed = 0;
+        ih.biClrImportant = 0;
+
+        // Write header information
         os.write(reinterpret_cast<const char*>(&fh), sizeof(BitmapFileHeader));
         os.write(reinterpret_cast<const char*>(&ih), sizeof(BitmapInfoHeader));
 
-		// Write image data.
-        if (flipVertically) {
-			for (int j = image.GetHeight(); j > 0; --j) {
-				for (int i = 0; i < image.GetWidth(); ++i) {
-					// Write pixel data.
-					int pixel = image.GetPixel(i, j - 1).GetARGB();
-                    os.write(reinterpret_cast<const char*>(&pixel), 3);
-				}
-
-				for (int i = 0; i < numPadding; ++i) {
-                    os.put(0);
-				}
-			}
-        } else {
-            for (int j = 0; j < image.GetHeight(); ++j) {
-                for (int i = 0; i < image.GetWidth(); ++i) {
-                    // Write pixel data.
-                    int pixel = image.GetPixel(i, j).GetARGB();
-                    os.write(reinterpret_cast<const char*>(&pixel), 3);
-                }
+        // Write image data, several rows at once.
+        const int rowsPerBlock = static_cast<int>(std::max<size_t>(1, IO_BLOCK_SIZE / rowSize));
+        std::vector<unsigned char> block(std::min(height, rowsPerBlock) * rowSize, 0);
 
-                for (int i = 0; i < numPadding; ++i) {
-                    os.put(0);
-                }
+        for (int j0 = 0; j0 < height; j0 += rowsPerBlock) {
+            const int j1 = std::min(height, j0 + rowsPerBlock);
+            unsigned char* dst = block.data();
+            for (int j = j0; j < j1; ++j, dst += rowSize) {
+                PackRow(image.GetRow(flip ? height - 1 - j : j), dst, width);
             }
+            os.write(reinterpret_cast<const char*>(block.data()), (j1 - j0) * rowSize);
         }
     }
 
-    void BmpEncoder::Encode(const Image & image, const char * filename) const
+    /**
+     * Reads and validates the headers of a BMP file.
+     */
+    static void ReadBmpHeaders(std::istream& is, BitmapFileHeader& fh, BitmapInfoHeader& ih)
     {
-		// Create file.
-        std::ofstream ofs(filename, std::ios::out | std::ios::binary);
-        if (!ofs) {
+        // Read file header.
+        is.read(reinterpret_cast<char*>(&fh), sizeof(BitmapFileHeader));
 
-            throw std::runtime_error(std::string("unable to open BMP file for writing '") 
-				+ filename + "'");
+        if (!is.good() || is.gcount() != sizeof(BitmapFileHeader)) {
+            throw std::runtime_error("unable to read BMP file header");
         }
 
-        Encode(image, ofs);
-		ofs.close();
+        if (fh.bfType != 0x4d42) {
+            throw std::runtime_error("unable to read BMP file, invalid header");
+        }
+
+        // Read info header.
+        is.read(reinterpret_cast<char*>(&ih), sizeof(ih.biSize));
+
+        if (!is.good() || is.gcount() != sizeof(ih.biSize)) {
+            throw std::runtime_error("unable to read reading BMP info header");
+        }
+
+        if (ih.biSize != sizeof(BitmapInfoHeader)) {
+            throw std::runtime_error("unsupported BMP format (size of bitmap info header mismatch, expected " 
+                + std::to_string(sizeof(BitmapInfoHeader)) 
+                + " but got " + std::to_string(ih.biSize) + ")");
+        }
+
+        is.read(reinterpret_cast<char*>(&ih.biWidth), sizeof(BitmapInfoHeader) - sizeof(ih.biSize));
+
+        if (!is.good() || is.gcount() != sizeof(BitmapInfoHeader) - sizeof(ih.biSize)) {
+            throw std::runtime_error("unable to read reading BMP info header");
+        }
+
+        if (ih.biCompression != BI_RGB || ih.biBitCount != BYTES_PER_PIXEL * 8) {
+            throw std::runtime_error("unsupported BMP format");
+        }
+
+        if (ih.biWidth <= 0 || ih.biHeight == 0) {
+            throw std::runtime_error("unable to read BMP file, invalid dimensions");
+        }
+
+        const size_t readSoFar = sizeof(BitmapFileHeader) + sizeof(BitmapInfoHeader);
+        if (fh.bfOffBits > readSoFar) {
+            is.ignore(fh.bfOffBits - readSoFar);
+        }
     }
 
-	/////////////////////////////////////////////////
-	/////// BmpEncoder
-	/////////////////////////////////////////////////
+    /**
+     * Reads one row of BGR triples into a row of pixels.
+     */
+    static void ReadRow(std::istream& is, Color4d* row, int width, std::vector<unsigned char>& scratch)
+    {
+        is.read(reinterpret_cast<char*>(scratch.data()), scratch.size());
+        if (!is.good() || static_cast<size_t>(is.gcount()) != scratch.size()) {
+            throw std::runtime_error("unable to read bitmap data");
+        }
 
-	BmpDecoder::BmpDecoder()
-	{
-		// Intentionally left empty.
-	}
+        // Same values as Color4d::CreateFromRgb(), without the divisions.
+        static const struct ByteToDouble {
+            double v[256];
+            ByteToDouble() {
+                for (int i = 0; i < 256; ++i) {
+                    v[i] = i / 255.0;
+                }
+            }
+        } lut;
 
-	std::unique_ptr<Image> BmpDecoder::Decode(std::istream& is) const
-	{
-		// Read file header.
-		BitmapFileHeader fh;
+        const unsigned char* ptr = scratch.data();
+        for (int i = 0; i < width; ++i, ptr += BYTES_PER_PIXEL) {
+            row[i].Set(lut.v[ptr[2]], lut.v[ptr[1]], lut.v[ptr[0]], 1.0);
+        }
+    }
 
-		is.read(reinterpret_cast<char*>(&fh), sizeof(BitmapFileHeader));
+    /**
+     * Reads one row of BGR triples into a row of pixels.
+     * 
+     * The triples are read directly into the upper three quarters of the
+     * row and expanded in place, the scratch buffer only receives the
+     * padding bytes.
+     */
+    static void ReadRow(std::istream& is, Rgba8* row, int width, std::vector<unsigned char>& scratch)
+    {
+        unsigned char* data = &row->r;
+        unsigned char* src = data + width;
+        const size_t numBytes = static_cast<size_t>(width) * BYTES_PER_PIXEL;
 
-		if (!is.good() || is.gcount() != sizeof(BitmapFileHeader)) {
-			throw std::runtime_error("unable to read BMP file header");
-		}
+        is.read(reinterpret_cast<char*>(src), numBytes);
+        if (!is.good() || static_cast<size_t>(is.gcount()) != numBytes) {
+            throw std::runtime_error("unable to read bitmap data");
+        }
 
-		if (fh.bfType != 0x4d42) {
-			throw std::runtime_error("unable to read BMP file, invalid header");
-		}
+        const size_t numPadding = scratch.size() - numBytes;
+        if (numPadding) {
+            is.read(reinterpret_cast<char*>(scratch.data()), numPadding);
+            if (!is.good() || static_cast<size_t>(is.gcount()) != numPadding) {
+                throw std::runtime_error("unable to read bitmap data");
+            }
+        }
 
-		// Read info header.
-		BitmapInfoHeader ih;
+        // Pixel i is written to bytes [4i, 4i + 4), which never overlap
+        // the triples of pixels not yet expanded, starting at width + 3i.
+        for (int i = 0; i < width; ++i, src += BYTES_PER_PIXEL) {
+            const unsigned char b = src[0];
+            const unsigned char g = src[1];
+            const unsigned char r = src[2];
+            row[i].r = r;
+            row[i].g = g;
+            row[i].b = b;
+            row[i].a = 255;
+        }
+    }
 
-		is.read(reinterpret_cast<char*>(&ih), sizeof(ih.biSize));
+    /**
+     * Reads the headers and pixel data of a BMP file.
+     */
+    template <typename I>
+    static std::unique_ptr<I> ReadBmp(std::istream& is)
+    {
+        BitmapFileHeader fh;
+        BitmapInfoHeader ih;
+        ReadBmpHeaders(is, fh, ih);
+
+        const bool flip = ih.biHeight >= 0;
+        const int width = ih.biWidth;
+        const int height = std::abs(ih.biHeight);
+
+        // Each line must contain number of bytes dividable by four.
+        const auto numPadding = CalcNumPadding(width, BYTES_PER_PIXEL);
+        std::vector<unsigned char> scratch(width * BYTES_PER_PIXEL + numPadding);
+
+        // Read bitmap data.
+        auto result = std::make_unique<I>(width, height);
+        for (int j = 0; j < height; ++j) {
+            ReadRow(is, result->GetRow(flip ? height - 1 - j : j), width, scratch);
+        }
 
-		if (!is.good() || is.gcount() != sizeof(ih.biSize)) {
-			throw std::runtime_error("unable to read reading BMP info header");
-		}
+        return result;
+    }
 
-		if (ih.biSize != sizeof(BitmapInfoHeader)) {
-			throw std::runtime_error("unsupported BMP format (size of bitmap info header mismatch, expected " 
-				+ std::to_string(sizeof(BitmapInfoHeader)) 
-				+ " but got " + std::to_string(ih.biSize) + ")");
-		}
+    void BmpEncoder::Encode(const Image & image, std::ostream& os) const
+    {
+        WriteBmp(image, flipVertically, os);
+    }
 
-		is.read(reinterpret_cast<char*>(&ih.biWidth), sizeof(BitmapInfoHeader) - sizeof(ih.biSize));
+    void BmpEncoder::Encode(const ImageRgba8 & image, std::ostream& os) const
+    {
+        WriteBmp(image, flipVertically, os);
+    }
 
-		if (!is.good() || is.gcount() != sizeof(BitmapInfoHeader) - sizeof(ih.biSize)) {
-			throw std::runtime_error("unable to read reading BMP info header");
-		}
+    /**
+     * Opens a file for writing and encodes an image.
+     */
+    template <typename I>
+    static void EncodeFile(const BmpEncoder & encoder, const I & image, const char * filename)
+    {
+        // Create file.
+        std::ofstream ofs(filename, std::ios::out | std::ios::binary);
+        if (!ofs) {
+            throw std::runtime_error(std::string("unable to open BMP file for writing '") 
+                + filename + "'");
+        }
 
-		if (ih.biCompression != BI_RGB || ih.biBitCount != BYTES_PER_PIXEL * 8) {
-			throw std::runtime_error("unsupported BMP format");
-		}
+        encoder.Encode(image, ofs);
+        ofs.close();
+        if (!ofs) {
+            throw std::runtime_error(std::string("unable to write BMP file '") 
+                + filename + "'");
+        }
+    }
 
-		size_t readSoFar = sizeof(BitmapFileHeader) + sizeof(BitmapInfoHeader);
-		is.ignore(fh.bfOffBits - readSoFar);
+    void BmpEncoder::Encode(const Image & image, const char * filename) const
+    {
+        EncodeFile(*this, image, filename);
+    }
 
-		bool flip = ih.biHeight >= 0;
-		ih.biHeight = std::abs(ih.biHeight);
+    void BmpEncoder::Encode(const ImageRgba8 & image, const char * filename) const
+    {
+        EncodeFile(*this, image, filename);
+    }
 
-		// Each line must contain number of bytes dividable by four.
-		auto numPadding = CalcNumPadding(ih.biWidth, BYTES_PER_PIXEL);
+    /////////////////////////////////////////////////
+    /////// BmpDecoder
+    /////////////////////////////////////////////////
 
-		buffer.resize(ih.biWidth * 3 + numPadding);
+    BmpDecoder::BmpDecoder()
+    {
+        // Intentionally left empty.
+    }
 
-		// Read bitmap data.
-		auto result = std::make_unique<Image>(ih.biWidth, ih.biHeight);
-		for (int j = 0; j < ih.biHeight; ++j) {
-			is.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
- 
-			if (!is.good() || is.gcount() != buffer.size()) {
-				throw std::runtime_error("unable to read bitmap data");
-			}
-			unsigned char *ptr = buffer.data();
-			for (int i = 0; i < ih.biWidth; ++i) {
-				unsigned char red, green, blue;
-				blue = *ptr++;
-				green = *ptr++;
-				red = *ptr++;
-				result->SetPixel(i, flip ? result->GetHeight() - 1 - j : j, Color4d::CreateFromRgb(red, green, blue));
-			}
-		}
+    std::unique_ptr<Image> BmpDecoder::Decode(std::istream& is) const
+    {
+        return ReadBmp<Image>(is);
+    }
 
-		return result;
-	}
+    std::unique_ptr<ImageRgba8> BmpDecoder::DecodeRgba8(std::istream& is) const
+    {
+        return ReadBmp<ImageRgba8>(is);
+    }
 
-	std::unique_ptr<Image> BmpDecoder::Decode(const char *filename) const
-	{
-		// Open file.
+    /**
+     * Opens a file for reading and decodes an image.
+     */
+    template <typename I>
+    static std::unique_ptr<I> DecodeFile(const char * filename)
+    {
+        // Open file.
         std::ifstream ifs(filename, std::ios::in | std::ios::binary);
         if (!ifs) {
             throw std::runtime_error(std::string("unable to open BMP file '") 
-				+ filename + "' for reading");
+                + filename + "' for reading");
         }
 
-		auto result = Decode(ifs);
-		ifs.close();
-		return result;
-	}
+        auto result = ReadBmp<I>(ifs);
+        ifs.close();
+        return result;
+    }
+
+    std::unique_ptr<Image> BmpDecoder::Decode(const char *filename) const
+    {
+        return DecodeFile<Image>(filename);
+    }
+
+    std::unique_ptr<ImageRgba8> BmpDecoder::DecodeRgba8(const char *filename) const
+    {
+        return DecodeFile<ImageRgba8>(filename);
+    }
+
 }
\ No newline at end of file
@@ -11,6 +11,9 @@
 #include <iostream>
 #include <vector>
 
+// Local includes
+#include "Graphics/PixelImage.h"
+
 namespace astu {
 
     // Forward declaration.
@@ -18,6 +21,10 @@ namespace astu {
 
     /**
      * Converts images into BMP files.
+     * 
+     * The pixels are converted row by row and written to the output stream
+     * in large blocks. Encoders do not keep any state while encoding and 
+     * can be used by several threads concurrently.
      */
     class BmpEncoder {
     public:
@@ -46,6 +53,26 @@ namespace astu {
          */
         void Encode(const Image & image, const char * filename) const;
 
+        /**
+         * Encodes the specified 8-bit image to the given output stream.
+         * 
+         * The alpha channel is ignored. This method will not close the 
+         * given output stream.
+         *
+         * @param image the image to be encoded
+         * @param os    the output stream
+         */
+        void Encode(const ImageRgba8 & image, std::ostream& os) const;
+
+        /**
+         * Convenient method to write an 8-bit image directly into a file.
+         *
+         * @param image     the image to be encoded
+         * @param filename  the filename including the file path
+         * @throws std::runtime_error in case of an I/O error
+         */
+        void Encode(const ImageRgba8 & image, const char * filename) const;
+
         /**
          * Returns whether images will get flipped vertically.
          * This flags defines whether the image will be flipped
@@ -73,6 +100,10 @@ namespace astu {
 
     /**
      * Decodes BMP files to images.
+     * 
+     * The pixel data is read row by row directly into the resulting image.
+     * Decoders do not keep any state while decoding and can be used by 
+     * several threads concurrently.
      */
     class BmpDecoder {
     public:
@@ -104,9 +135,29 @@ namespace astu {
          */
         std::unique_ptr<Image> Decode(const char * filename) const;
 
-    private:
-        /** Used to buffer input stream. */
-        mutable std::vector<unsigned char> buffer;
+        /**
+         * Decodes an BMP file from an input stream into an 8-bit image.
+         * 
+         * The pixel data is read into the rows of the resulting image and
+         * expanded in place, no intermediate copy of the image is made.
+         * The alpha channel of all pixels is set to 255.
+         *
+         * @param is    the input stream
+         * @return the newly created image containing the BMP data
+         * @throws std::runtime_error in case of i/o problem or if the
+         *      input stream does not contain a valid BMP file
+         */
+        std::unique_ptr<ImageRgba8> DecodeRgba8(std::istream& is) const;
+
+        /**
+         * Convenient method to read an 8-bit image directly from a file.
+         *
+         * @param filename  the filename including the file path
+         * @return the newly created image containing the BMP data
+         * @throws std::runtime_error in case of i/o problem or if the
+         *      input file does not contain a valid BMP file
+         */
+        std::unique_ptr<ImageRgba8> DecodeRgba8(const char * filename) const;
     };
 
 }
@@ -0,0 +1,368 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+// Local includes
+#include "CoverageRasterizer.h"
+#include "Graphics/Image.h"
+#include "Util/ThreadPool.h"
+
+// C++ Standard Library includes
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+/** The number of rows rendered by one task. */
+#define ROWS_PER_TASK 16
+
+/** The squared radius below which circles are scaled down to their area. */
+#define MIN_RAMP_RADIUS2 (1.0 / 3.0)
+
+namespace astu {
+
+    /**
+     * Computes the length of the overlap of the interval [t - 0.5, t + 0.5]
+     * with the interval [-h, h].
+     */
+    static inline double Overlap(double t, double h)
+    {
+        const double lo = std::max(t - 0.5, -h);
+        const double hi = std::min(t + 0.5, h);
+        return std::max(0.0, hi - lo);
+    }
+
+    /**
+     * Clips a polygon against the half-plane sign * v[axis] <= h.
+     *
+     * @return the number of vertices of the clipped polygon
+     */
+    static int ClipPolygon(const double (*in)[2], int n, int axis, double sign, double h, 
+        double (*out)[2])
+    {
+        int m = 0;
+        for (int i = 0; i < n; ++i) {
+            const double* a = in[i];
+            const double* b = in[(i + 1) % n];
+            const double da = sign * a[axis] - h;
+            const double db = sign * b[axis] - h;
+            if (da <= 0) {
+                out[m][0] = a[0];
+                out[m++][1] = a[1];
+            }
+            if ((da < 0 && db > 0) || (da > 0 && db < 0)) {
+                const double t = da / (da - db);
+                out[m][0] = a[0] + (b[0] - a[0]) * t;
+                out[m++][1] = a[1] + (b[1] - a[1]) * t;
+            }
+        }
+        return m;
+    }
+
+    /**
+     * Computes the area of a pixel within a rectangle centered at the
+     * origin of its local coordinate system.
+     *
+     * @param lx, ly    the local coordinates of the pixel center
+     * @param ux, uy    the unit vector of the local x-axis
+     * @param hw, hh    the half extents of the rectangle
+     */
+    static double ClipPixelArea(double lx, double ly, double ux, double uy, double hw, double hh)
+    {
+        // Corners of the pixel in local coordinates, each clip step adds 
+        // at most one vertex.
+        static const double cornerX[4] = {-0.5, 0.5, 0.5, -0.5};
+        static const double cornerY[4] = {-0.5, -0.5, 0.5, 0.5};
+        double poly[8][2];
+        double tmp[8][2];
+        for (int i = 0; i < 4; ++i) {
+            poly[i][0] = lx + cornerX[i] * ux + cornerY[i] * uy;
+            poly[i][1] = ly - cornerX[i] * uy + cornerY[i] * ux;
+        }
+
+        int n = ClipPolygon(poly, 4, 0, 1, hw, tmp);
+        n = ClipPolygon(tmp, n, 0, -1, hw, poly);
+        n = ClipPolygon(poly, n, 1, 1, hh, tmp);
+        n = ClipPolygon(tmp, n, 1, -1, hh, poly);
+
+        double area = 0;
+        for (int i = 0; i < n; ++i) {
+            const double* a = poly[i];
+            const double* b = poly[(i + 1) % n];
+            area += a[0] * b[1] - a[1] * b[0];
+        }
+        return std::min(1.0, std::abs(area) * 0.5);
+    }
+
+    /**
+     * Restricts the interval [lo, hi] of px to the values for which
+     * |a * px + b| < h holds.
+     */
+    static inline void RestrictSlab(double a, double b, double h, double& lo, double& hi)
+    {
+        if (std::abs(a) < 1e-12) {
+            if (std::abs(b) >= h) {
+                lo = 1;
+                hi = 0;
+            }
+            return;
+        }
+
+        double t0 = (-h - b) / a;
+        double t1 = (h - b) / a;
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        lo = std::max(lo, t0);
+        hi = std::min(hi, t1);
+    }
+
+    CoverageRasterizer::CoverageRasterizer()
+        : numThreads(0)
+    {
+        // Intentionally left empty.
+    }
+
+    CoverageRasterizer::~CoverageRasterizer()
+    {
+        // Intentionally left empty.
+    }
+
+    void CoverageRasterizer::Clear()
+    {
+        shapes.clear();
+    }
+
+    void CoverageRasterizer::SetNumThreads(size_t n)
+    {
+        if (n != numThreads) {
+            numThreads = n;
+            threadPool = nullptr;
+        }
+    }
+
+    void CoverageRasterizer::AddCircle(double cx, double cy, double r, const Color4d& c)
+    {
+        Shape s;
+        s.type = ShapeType::Circle;
+        s.cx = cx;
+        s.cy = cy;
+        s.hw = s.hh = r;
+        s.ux = 1;
+        s.uy = 0;
+        s.color = c;
+        s.minX = cx - r - 0.5;
+        s.maxX = cx + r + 0.5;
+        s.minY = cy - r - 0.5;
+        s.maxY = cy + r + 0.5;
+        shapes.push_back(s);
+    }
+
+    void CoverageRasterizer::AddRectangle(
+        double cx, double cy, double w, double h, double ux, double uy,
+        const Color4d& c)
+    {
+        Shape s;
+        s.type = ShapeType::Rectangle;
+        s.cx = cx;
+        s.cy = cy;
+        s.hw = w / 2;
+        s.hh = h / 2;
+        s.ux = ux;
+        s.uy = uy;
+        s.color = c;
+
+        const double ex = s.hw * std::abs(ux) + s.hh * std::abs(uy) + 0.5;
+        const double ey = s.hw * std::abs(uy) + s.hh * std::abs(ux) + 0.5;
+        s.minX = cx - ex;
+        s.maxX = cx + ex;
+        s.minY = cy - ey;
+        s.maxY = cy + ey;
+        shapes.push_back(s);
+    }
+
+    void CoverageRasterizer::Render(const Color4d& background, Image& result)
+    {
+        const int w = result.GetWidth();
+        const int h = result.GetHeight();
+
+        if (numThreads == 1) {
+            RenderRegion(background, result, 0, 0, w, h);
+            return;
+        }
+
+        if (!threadPool) {
+            threadPool = std::make_unique<ThreadPool>(numThreads);
+        }
+
+        vector<future<void>> futures;
+        for (int y0 = 0; y0 < h; y0 += ROWS_PER_TASK) {
+            const int y1 = std::min(h, y0 + ROWS_PER_TASK);
+            futures.push_back(threadPool->Submit(
+                [this, &background, &result, w, y0, y1]() {
+                    RenderRegion(background, result, 0, y0, w, y1);
+                }));
+        }
+
+        for (auto & f : futures) {
+            f.get();
+        }
+    }
+
+    void CoverageRasterizer::RenderTiles(
+        const Color4d& background, Image& result, int tileSize, const std::vector<size_t>& tiles)
+    {
+        if (tileSize < 1) {
+            throw std::domain_error("Tile size must be greater zero, got " 
+                + std::to_string(tileSize));
+        }
+
+        const int w = result.GetWidth();
+        const int h = result.GetHeight();
+        const int nx = (w + tileSize - 1) / tileSize;
+
+        if (numThreads == 1) {
+            for (auto tile : tiles) {
+                const int x0 = static_cast<int>(tile % nx) * tileSize;
+                const int y0 = static_cast<int>(tile / nx) * tileSize;
+                RenderRegion(background, result, x0, y0, 
+                    std::min(x0 + tileSize, w), std::min(y0 + tileSize, h));
+            }
+            return;
+        }
+
+        if (!threadPool) {
+            threadPool = std::make_unique<ThreadPool>(numThreads);
+        }
+
+        vector<future<void>> futures;
+        futures.reserve(tiles.size());
+        for (auto tile : tiles) {
+            const int x0 = static_cast<int>(tile % nx) * tileSize;
+            const int y0 = static_cast<int>(tile / nx) * tileSize;
+            const int x1 = std::min(x0 + tileSize, w);
+            const int y1 = std::min(y0 + tileSize, h);
+            futures.push_back(threadPool->Submit(
+                [this, &background, &result, x0, y0, x1, y1]() {
+                    RenderRegion(background, result, x0, y0, x1, y1);
+                }));
+        }
+
+        for (auto & f : futures) {
+            f.get();
+        }
+    }
+
+    void CoverageRasterizer::RenderRegion(
+        const Color4d& background, Image& result, int x0, int y0, int x1, int y1) const
+    {
+        const int w = result.GetWidth();
+        Color4d* pixels = result.GetPixels();
+
+        for (int y = y0; y < y1; ++y) {
+            Color4d* row = pixels + static_cast<size_t>(y) * w;
+            std::fill(row + x0, row + x1, background);
+        }
+
+        for (const auto & s : shapes) {
+            if (s.maxY < y0 || s.minY >= y1 || s.maxX < x0 || s.minX >= x1) {
+                continue;
+            }
+
+            const int sy0 = std::max(y0, static_cast<int>(std::floor(s.minY)));
+            const int sy1 = std::min(y1, static_cast<int>(std::floor(s.maxY)) + 1);
+            for (int y = sy0; y < sy1; ++y) {
+                Color4d* row = pixels + static_cast<size_t>(y) * w;
+                if (s.type == ShapeType::Circle) {
+                    RasterizeCircle(s, row, y, x0, x1);
+                } else {
+                    RasterizeRectangle(s, row, y, x0, x1);
+                }
+            }
+        }
+    }
+
+    void CoverageRasterizer::RasterizeCircle(const Shape& s, Color4d* row, int y, int xa, int xb)
+    {
+        // The coverage ramps down linearly within one pixel around the
+        // radius re, which sums up to pi * (re^2 + 1/12). The radius of the
+        // ramp is shrunk accordingly, circles too small for that are
+        // rendered with a ramp around 0.5 scaled down to their area.
+        const double r2 = s.hw * s.hw;
+        const double re = r2 > MIN_RAMP_RADIUS2 ? std::sqrt(r2 - 1.0 / 12.0) : 0.5;
+        const double scale = r2 > MIN_RAMP_RADIUS2 ? 1.0 : 3.0 * r2;
+
+        const double dy = y + 0.5 - s.cy;
+        const double outer = re + 0.5;
+        const double d2 = outer * outer - dy * dy;
+        if (d2 <= 0) {
+            return;
+        }
+
+        const double half = std::sqrt(d2);
+        const int x0 = std::max(xa, static_cast<int>(std::ceil(s.cx - half - 0.5)));
+        const int x1 = std::min(xb - 1, static_cast<int>(std::floor(s.cx + half - 0.5)));
+        for (int x = x0; x <= x1; ++x) {
+            const double dx = x + 0.5 - s.cx;
+            const double dist = std::sqrt(dx * dx + dy * dy);
+            const double coverage = std::min(1.0, outer - dist);
+            if (coverage > 0) {
+                BlendPixel(row[x], s.color, coverage * scale);
+            }
+        }
+    }
+
+    void CoverageRasterizer::RasterizeRectangle(const Shape& s, Color4d* row, int y, int xa, int xb)
+    {
+        // Local coordinates of pixel centers along this row are linear in
+        // the pixel center's x-coordinate px:
+        //   lx =  (px - cx) * ux + (py - cy) * uy
+        //   ly = -(px - cx) * uy + (py - cy) * ux
+        const double dy = y + 0.5 - s.cy;
+        const double bx = -s.cx * s.ux + dy * s.uy;
+        const double by = s.cx * s.uy + dy * s.ux;
+
+        // The projection of the pixel footprint onto the local axes
+        // extends up to half a pixel's diagonal from its center.
+        const double e = 0.5 * (std::abs(s.ux) + std::abs(s.uy));
+        double lo = s.minX;
+        double hi = s.maxX;
+        RestrictSlab(s.ux, bx, s.hw + e, lo, hi);
+        RestrictSlab(-s.uy, by, s.hh + e, lo, hi);
+        if (lo > hi) {
+            return;
+        }
+
+        // The product of the overlaps is exact for axis-aligned rectangles
+        // only, the pixels along the edges of rotated rectangles are 
+        // clipped against the rectangle.
+        const bool axisAligned = s.ux == 0 || s.uy == 0;
+        const int x0 = std::max(xa, static_cast<int>(std::ceil(lo - 0.5)));
+        const int x1 = std::min(xb - 1, static_cast<int>(std::floor(hi - 0.5)));
+        for (int x = x0; x <= x1; ++x) {
+            const double px = x + 0.5;
+            const double lx = s.ux * px + bx;
+            const double ly = -s.uy * px + by;
+
+            double coverage;
+            if (axisAligned) {
+                coverage = Overlap(lx, s.hw) * Overlap(ly, s.hh);
+            } else if (std::abs(lx) <= s.hw - e && std::abs(ly) <= s.hh - e) {
+                coverage = 1;
+            } else {
+                coverage = ClipPixelArea(lx, ly, s.ux, s.uy, s.hw, s.hh);
+            }
+
+            if (coverage > 0) {
+                BlendPixel(row[x], s.color, coverage);
+            }
+        }
+    }
+
+} // end of namespace
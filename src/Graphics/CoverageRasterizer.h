@@ -0,0 +1,207 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+#pragma once
+
+// Local includes
+#include "Graphics/Color.h"
+
+// C++ Standard Library includes
+#include <memory>
+#include <vector>
+
+namespace astu {
+
+    class Image;
+    class ThreadPool;
+
+    /**
+     * Rasterizes circles and (rotated) rectangles scanline by scanline,
+     * computing the coverage of each pixel analytically.
+     *
+     * For each scanline, only the span of pixels which might be touched by
+     * a shape is visited. Rectangles use the exact area of the pixel
+     * footprint within the rectangle, computed as product of the overlaps
+     * with the slabs for axis-aligned rectangles and by clipping the
+     * footprint along the edges of rotated rectangles. Circles ramp the
+     * coverage linearly with the distance to their boundary, which
+     * preserves their area but deviates from the exact coverage of a pixel
+     * by up to 0.09. Shapes are composited in the order in which they have
+     * been added.
+     */
+    class CoverageRasterizer final {
+    public:
+
+        /**
+         * Constructor.
+         */
+        CoverageRasterizer();
+
+        /**
+         * Destructor.
+         */
+        ~CoverageRasterizer();
+
+        /**
+         * Removes all shapes.
+         */
+        void Clear();
+
+        /**
+         * Adds a circle.
+         *
+         * @param cx    the x-coordinate of the center
+         * @param cy    the y-coordinate of the center
+         * @param r     the radius
+         * @param c     the color
+         */
+        void AddCircle(double cx, double cy, double r, const Color4d& c);
+
+        /**
+         * Adds a rectangle.
+         *
+         * @param cx    the x-coordinate of the center
+         * @param cy    the y-coordinate of the center
+         * @param w     the width of the rectangle along its local x-axis
+         * @param h     the height of the rectangle along its local y-axis
+         * @param ux    the x-component of the unit vector of the local x-axis
+         * @param uy    the y-component of the unit vector of the local x-axis
+         * @param c     the color
+         */
+        void AddRectangle(
+            double cx, double cy, double w, double h, double ux, double uy,
+            const Color4d& c);
+
+        /**
+         * Returns the number of shapes.
+         *
+         * @return the number of shapes
+         */
+        size_t NumberOfShapes() const {
+            return shapes.size();
+        }
+
+        /**
+         * Sets the number of threads used for rendering.
+         *
+         * @param n the number of threads, zero selects the number of
+         *          hardware threads, one renders on the calling thread
+         */
+        void SetNumThreads(size_t n);
+
+        /**
+         * Renders all shapes to the specified image.
+         *
+         * @param background    the background color
+         * @param result        the image receiving the rendered pixels
+         */
+        void Render(const Color4d& background, Image& result);
+
+        /**
+         * Renders a subset of the square tiles of the specified image.
+         *
+         * Tiles are numbered row by row, starting with the upper left
+         * tile. Pixels outside the specified tiles remain unchanged.
+         *
+         * @param background    the background color
+         * @param result        the image receiving the rendered pixels
+         * @param tileSize      the edge length of the tiles in pixels
+         * @param tiles         the indices of the tiles to render
+         */
+        void RenderTiles(const Color4d& background, Image& result, int tileSize, 
+            const std::vector<size_t>& tiles);
+
+    private:
+        /** The types of supported shapes. */
+        enum class ShapeType { Circle, Rectangle };
+
+        /** Describes a single shape. */
+        struct Shape {
+            ShapeType type;
+
+            /** The center of the shape. */
+            double cx, cy;
+
+            /** The half extents, both equal the radius for circles. */
+            double hw, hh;
+
+            /** The unit vector of the local x-axis. */
+            double ux, uy;
+
+            /** The color of the shape. */
+            Color4d color;
+
+            /** The conservative bounding box in pixel coordinates. */
+            double minX, minY, maxX, maxY;
+        };
+
+        /** The shapes to rasterize. */
+        std::vector<Shape> shapes;
+
+        /** The number of threads, zero means hardware threads. */
+        size_t numThreads;
+
+        /** The thread pool used for rendering, created on demand. */
+        std::unique_ptr<ThreadPool> threadPool;
+
+        /**
+         * Renders all shapes to a rectangular region.
+         *
+         * @param background    the background color
+         * @param result        the image receiving the rendered pixels
+         * @param x0            the first column
+         * @param y0            the first row
+         * @param x1            the column one past the last column
+         * @param y1            the row one past the last row
+         */
+        void RenderRegion(const Color4d& background, Image& result, int x0, int y0, int x1, int y1) const;
+
+        /**
+         * Rasterizes a circle into one row.
+         *
+         * @param s     the circle
+         * @param row   the pixels of the row
+         * @param y     the index of the row
+         * @param x0    the first column to rasterize
+         * @param x1    the column one past the last column to rasterize
+         */
+        static void RasterizeCircle(const Shape& s, Color4d* row, int y, int x0, int x1);
+
+        /**
+         * Rasterizes a rectangle into one row.
+         *
+         * @param s     the rectangle
+         * @param row   the pixels of the row
+         * @param y     the index of the row
+         * @param x0    the first column to rasterize
+         * @param x1    the column one past the last column to rasterize
+         */
+        static void RasterizeRectangle(const Shape& s, Color4d* row, int y, int x0, int x1);
+
+        /**
+         * Blends a color weighted by coverage over a pixel.
+         *
+         * @param dst       the pixel
+         * @param src       the color to blend
+         * @param coverage  the coverage within the range [0, 1]
+         */
+        static void BlendPixel(Color4d& dst, const Color4d& src, double coverage) {
+            const double sa = src.a * coverage;
+            const double iba = 1.0 - sa;
+            const double a = sa + dst.a * iba;
+            if (a <= 0) {
+                return;
+            }
+
+            dst.r = (src.r * sa + dst.r * dst.a * iba) / a;
+            dst.g = (src.g * sa + dst.g * dst.a * iba) / a;
+            dst.b = (src.b * sa + dst.b * dst.a * iba) / a;
+            dst.a = a;
+        }
+    };
+
+} // end of namespace
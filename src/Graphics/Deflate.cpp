@@ -0,0 +1,970 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+// Local includes
+#include "Deflate.h"
+
+// C++ Standard Library includes
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+/** The size of the sliding window of the deflate algorithm. */
+#define WINDOW_SIZE 32768
+
+/** The number of bits used for hashing three consecutive bytes. */
+#define HASH_BITS 15
+
+/** The minimum length of a match. */
+#define MIN_MATCH 3
+
+/** The maximum length of a match. */
+#define MAX_MATCH 258
+
+/** The maximum number of symbols collected for one block. */
+#define MAX_BLOCK_SYMBOLS 65536
+
+/** The maximum length of Huffman codes for literals, lengths and distances. */
+#define MAX_CODE_LENGTH 15
+
+/** The maximum length of Huffman codes used to encode code lengths. */
+#define MAX_CODE_LENGTH_CODE_LENGTH 7
+
+/** The number of literal/length codes. */
+#define NUM_LITLEN_CODES 286
+
+/** The number of distance codes. */
+#define NUM_DIST_CODES 30
+
+/** The number of code length codes. */
+#define NUM_CODE_LENGTH_CODES 19
+
+namespace astu {
+
+    /////////////////////////////////////////////////
+    /////// Checksums
+    /////////////////////////////////////////////////
+
+    uint32_t UpdateCrc32(uint32_t crc, const unsigned char* data, size_t n)
+    {
+        static const struct CrcTable {
+            uint32_t v[256];
+            CrcTable() {
+                for (uint32_t i = 0; i < 256; ++i) {
+                    uint32_t c = i;
+                    for (int k = 0; k < 8; ++k) {
+                        c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                    }
+                    v[i] = c;
+                }
+            }
+        } table;
+
+        crc = ~crc;
+        for (size_t i = 0; i < n; ++i) {
+            crc = table.v[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    uint32_t UpdateAdler32(uint32_t adler, const unsigned char* data, size_t n)
+    {
+        // Largest number of bytes which can be summed up without overflow.
+        const size_t NMAX = 5552;
+
+        uint32_t a = adler & 0xffff;
+        uint32_t b = adler >> 16;
+        while (n > 0) {
+            const size_t k = std::min(n, NMAX);
+            for (size_t i = 0; i < k; ++i) {
+                a += data[i];
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+            data += k;
+            n -= k;
+        }
+        return (b << 16) | a;
+    }
+
+    /////////////////////////////////////////////////
+    /////// Tables of the deflate format
+    /////////////////////////////////////////////////
+
+    static const uint16_t kLengthBase[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+    };
+
+    static const uint8_t kLengthExtra[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+
+    static const uint16_t kDistBase[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+        257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+        8193, 12289, 16385, 24577
+    };
+
+    static const uint8_t kDistExtra[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+        7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+    };
+
+    /** The order in which code length code lengths are stored. */
+    static const uint8_t kCodeLengthOrder[NUM_CODE_LENGTH_CODES] = {
+        16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+    };
+
+    /**
+     * Maps match lengths and distances to their codes.
+     */
+    static const struct CodeTables {
+        /** Maps length - 3 to the length code index [0, 29). */
+        uint8_t lengthCode[MAX_MATCH - MIN_MATCH + 1];
+
+        /** Maps distance - 1 to the distance code, for distances up to 512. */
+        uint8_t distCodeLow[512];
+
+        /** Maps (distance - 1) >> 7 to the distance code, for larger distances. */
+        uint8_t distCodeHigh[256];
+
+        CodeTables() {
+            for (int code = 0; code < 29; ++code) {
+                const int n = 1 << kLengthExtra[code];
+                for (int i = 0; i < n && kLengthBase[code] + i <= MAX_MATCH; ++i) {
+                    lengthCode[kLengthBase[code] + i - MIN_MATCH] = static_cast<uint8_t>(code);
+                }
+            }
+
+            for (int code = 0; code < NUM_DIST_CODES; ++code) {
+                const int n = 1 << kDistExtra[code];
+                for (int i = 0; i < n; ++i) {
+                    const int d = kDistBase[code] + i - 1;
+                    if (d < 512) {
+                        distCodeLow[d] = static_cast<uint8_t>(code);
+                    }
+                    distCodeHigh[d >> 7] = static_cast<uint8_t>(code);
+                }
+            }
+        }
+
+        int DistCode(int dist) const {
+            return dist <= 512 ? distCodeLow[dist - 1] : distCodeHigh[(dist - 1) >> 7];
+        }
+    } kCodeTables;
+
+    /////////////////////////////////////////////////
+    /////// Huffman codes
+    /////////////////////////////////////////////////
+
+    /**
+     * Reverses the lowest bits of a code.
+     */
+    static inline uint32_t ReverseBits(uint32_t code, int len)
+    {
+        uint32_t result = 0;
+        for (int i = 0; i < len; ++i) {
+            result = (result << 1) | (code & 1);
+            code >>= 1;
+        }
+        return result;
+    }
+
+    /**
+     * Computes length-limited Huffman code lengths for the given symbol
+     * frequencies.
+     *
+     * @param freqs     the frequencies of the symbols
+     * @param n         the number of symbols
+     * @param maxLen    the maximum code length
+     * @param lengths   receives the code lengths
+     */
+    static void BuildCodeLengths(const uint32_t* freqs, int n, int maxLen, uint8_t* lengths)
+    {
+        std::fill(lengths, lengths + n, 0);
+
+        vector<int> symbols;
+        for (int i = 0; i < n; ++i) {
+            if (freqs[i]) {
+                symbols.push_back(i);
+            }
+        }
+
+        if (symbols.empty()) {
+            return;
+        }
+
+        if (symbols.size() == 1) {
+            lengths[symbols[0]] = 1;
+            return;
+        }
+
+        // Build the Huffman tree to obtain unrestricted code lengths.
+        struct TreeNode { uint64_t freq; int left, right; };
+        vector<TreeNode> nodes;
+        using Entry = pair<uint64_t, int>;
+        priority_queue<Entry, vector<Entry>, greater<Entry>> queue;
+        for (int s : symbols) {
+            queue.push({freqs[s], static_cast<int>(nodes.size())});
+            nodes.push_back({freqs[s], -1, s});
+        }
+
+        while (queue.size() > 1) {
+            const auto a = queue.top();
+            queue.pop();
+            const auto b = queue.top();
+            queue.pop();
+            queue.push({a.first + b.first, static_cast<int>(nodes.size())});
+            nodes.push_back({a.first + b.first, a.second, b.second});
+        }
+
+        // Count the number of codes per length.
+        vector<int> numCodes(std::max(maxLen, 64) + 1, 0);
+        vector<pair<int, int>> stack = {{queue.top().second, 0}};
+        while (!stack.empty()) {
+            const auto e = stack.back();
+            stack.pop_back();
+            const TreeNode & node = nodes[e.first];
+            if (node.left < 0) {
+                ++numCodes[std::min(e.second, static_cast<int>(numCodes.size()) - 1)];
+            } else {
+                stack.push_back({node.left, e.second + 1});
+                stack.push_back({node.right, e.second + 1});
+            }
+        }
+
+        // Limit the code lengths while keeping the Kraft sum at one.
+        for (size_t i = maxLen + 1; i < numCodes.size(); ++i) {
+            numCodes[maxLen] += numCodes[i];
+            numCodes[i] = 0;
+        }
+
+        uint64_t total = 0;
+        for (int i = 1; i <= maxLen; ++i) {
+            total += static_cast<uint64_t>(numCodes[i]) << (maxLen - i);
+        }
+
+        while (total != (1ull << maxLen)) {
+            --numCodes[maxLen];
+            for (int i = maxLen - 1; i > 0; --i) {
+                if (numCodes[i]) {
+                    --numCodes[i];
+                    numCodes[i + 1] += 2;
+                    break;
+                }
+            }
+            --total;
+        }
+
+        // Assign the longest codes to the least frequent symbols.
+        std::stable_sort(symbols.begin(), symbols.end(), [freqs](int a, int b) {
+            return freqs[a] < freqs[b];
+        });
+
+        size_t idx = 0;
+        for (int len = maxLen; len > 0; --len) {
+            for (int k = 0; k < numCodes[len]; ++k) {
+                lengths[symbols[idx++]] = static_cast<uint8_t>(len);
+            }
+        }
+    }
+
+    /**
+     * Computes canonical Huffman codes from code lengths.
+     *
+     * The codes are bit-reversed, ready to be written LSB first.
+     */
+    static void BuildCodes(const uint8_t* lengths, int n, uint16_t* codes)
+    {
+        int count[MAX_CODE_LENGTH + 1] = {0};
+        for (int i = 0; i < n; ++i) {
+            ++count[lengths[i]];
+        }
+        count[0] = 0;
+
+        int next[MAX_CODE_LENGTH + 2] = {0};
+        int code = 0;
+        for (int len = 1; len <= MAX_CODE_LENGTH; ++len) {
+            code = (code + count[len - 1]) << 1;
+            next[len] = code;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            const int len = lengths[i];
+            codes[i] = len ? static_cast<uint16_t>(ReverseBits(next[len]++, len)) : 0;
+        }
+    }
+
+    /////////////////////////////////////////////////
+    /////// Compression
+    /////////////////////////////////////////////////
+
+    /**
+     * Writes bits LSB first to a byte vector.
+     */
+    class BitWriter {
+    public:
+        BitWriter(vector<unsigned char>& out)
+            : out(out), bits(0), numBits(0)
+        {
+            // Intentionally left empty.
+        }
+
+        void Write(uint32_t value, int n) {
+            bits |= static_cast<uint64_t>(value) << numBits;
+            numBits += n;
+            while (numBits >= 8) {
+                out.push_back(static_cast<unsigned char>(bits));
+                bits >>= 8;
+                numBits -= 8;
+            }
+        }
+
+        void AlignToByte() {
+            if (numBits > 0) {
+                Write(0, 8 - numBits);
+            }
+        }
+
+    private:
+        vector<unsigned char>& out;
+        uint64_t bits;
+        int numBits;
+    };
+
+    /** A literal or a length/distance pair found by the match finder. */
+    struct Symbol {
+        /** The literal or the match length. */
+        uint16_t value;
+
+        /** The match distance, zero for literals. */
+        uint16_t dist;
+    };
+
+    /** Compression parameters per level. */
+    struct LevelParams {
+        /** The maximum number of hash chain entries to examine. */
+        int maxChain;
+
+        /** Stop searching once a match of this length has been found. */
+        int niceLength;
+
+        /** Whether to defer matches in favor of longer ones. */
+        bool lazy;
+    };
+
+    static const LevelParams kLevelParams[10] = {
+        {0, 0, false},
+        {4, 8, false},
+        {8, 16, false},
+        {16, 32, false},
+        {16, 32, true},
+        {32, 64, true},
+        {128, 128, true},
+        {256, 258, true},
+        {1024, 258, true},
+        {4096, 258, true},
+    };
+
+    /**
+     * Writes the code lengths of the literal/length and distance codes.
+     */
+    static void WriteDynamicHeader(BitWriter& bw, const uint8_t* litLens, int numLit, const uint8_t* distLens, int numDist)
+    {
+        // Concatenate lengths and run-length encode them.
+        vector<uint8_t> all(litLens, litLens + numLit);
+        all.insert(all.end(), distLens, distLens + numDist);
+
+        struct Rle { uint8_t sym, extra; };
+        vector<Rle> rle;
+        for (size_t i = 0; i < all.size();) {
+            const uint8_t len = all[i];
+            size_t run = 1;
+            while (i + run < all.size() && all[i + run] == len) {
+                ++run;
+            }
+
+            size_t left = run;
+            if (len == 0) {
+                while (left >= 11) {
+                    const size_t k = std::min<size_t>(left, 138);
+                    rle.push_back({18, static_cast<uint8_t>(k - 11)});
+                    left -= k;
+                }
+                if (left >= 3) {
+                    rle.push_back({17, static_cast<uint8_t>(left - 3)});
+                    left = 0;
+                }
+            } else {
+                rle.push_back({len, 0});
+                --left;
+                while (left >= 3) {
+                    const size_t k = std::min<size_t>(left, 6);
+                    rle.push_back({16, static_cast<uint8_t>(k - 3)});
+                    left -= k;
+                }
+            }
+
+            while (left-- > 0) {
+                rle.push_back({len, 0});
+            }
+            i += run;
+        }
+
+        uint32_t freqs[NUM_CODE_LENGTH_CODES] = {0};
+        for (const auto & r : rle) {
+            ++freqs[r.sym];
+        }
+
+        uint8_t clLens[NUM_CODE_LENGTH_CODES];
+        uint16_t clCodes[NUM_CODE_LENGTH_CODES];
+        BuildCodeLengths(freqs, NUM_CODE_LENGTH_CODES, MAX_CODE_LENGTH_CODE_LENGTH, clLens);
+        BuildCodes(clLens, NUM_CODE_LENGTH_CODES, clCodes);
+
+        int numCl = NUM_CODE_LENGTH_CODES;
+        while (numCl > 4 && clLens[kCodeLengthOrder[numCl - 1]] == 0) {
+            --numCl;
+        }
+
+        bw.Write(numLit - 257, 5);
+        bw.Write(numDist - 1, 5);
+        bw.Write(numCl - 4, 4);
+        for (int i = 0; i < numCl; ++i) {
+            bw.Write(clLens[kCodeLengthOrder[i]], 3);
+        }
+
+        for (const auto & r : rle) {
+            bw.Write(clCodes[r.sym], clLens[r.sym]);
+            if (r.sym == 16) {
+                bw.Write(r.extra, 2);
+            } else if (r.sym == 17) {
+                bw.Write(r.extra, 3);
+            } else if (r.sym == 18) {
+                bw.Write(r.extra, 7);
+            }
+        }
+    }
+
+    /**
+     * Writes one block using dynamic Huffman codes.
+     */
+    static void WriteBlock(BitWriter& bw, const vector<Symbol>& symbols, bool last)
+    {
+        uint32_t litFreqs[NUM_LITLEN_CODES] = {0};
+        uint32_t distFreqs[NUM_DIST_CODES] = {0};
+        for (const auto & s : symbols) {
+            if (s.dist == 0) {
+                ++litFreqs[s.value];
+            } else {
+                ++litFreqs[257 + kCodeTables.lengthCode[s.value - MIN_MATCH]];
+                ++distFreqs[kCodeTables.DistCode(s.dist)];
+            }
+        }
+        litFreqs[256] = 1;
+
+        uint8_t litLens[NUM_LITLEN_CODES];
+        uint8_t distLens[NUM_DIST_CODES];
+        uint16_t litCodes[NUM_LITLEN_CODES];
+        uint16_t distCodes[NUM_DIST_CODES];
+        BuildCodeLengths(litFreqs, NUM_LITLEN_CODES, MAX_CODE_LENGTH, litLens);
+        BuildCodeLengths(distFreqs, NUM_DIST_CODES, MAX_CODE_LENGTH, distLens);
+        BuildCodes(litLens, NUM_LITLEN_CODES, litCodes);
+        BuildCodes(distLens, NUM_DIST_CODES, distCodes);
+
+        int numLit = NUM_LITLEN_CODES;
+        while (numLit > 257 && litLens[numLit - 1] == 0) {
+            --numLit;
+        }
+
+        int numDist = NUM_DIST_CODES;
+        while (numDist > 1 && distLens[numDist - 1] == 0) {
+            --numDist;
+        }
+
+        bw.Write(last ? 1 : 0, 1);
+        bw.Write(2, 2);
+        WriteDynamicHeader(bw, litLens, numLit, distLens, numDist);
+
+        for (const auto & s : symbols) {
+            if (s.dist == 0) {
+                bw.Write(litCodes[s.value], litLens[s.value]);
+            } else {
+                const int lc = kCodeTables.lengthCode[s.value - MIN_MATCH];
+                bw.Write(litCodes[257 + lc], litLens[257 + lc]);
+                bw.Write(s.value - kLengthBase[lc], kLengthExtra[lc]);
+
+                const int dc = kCodeTables.DistCode(s.dist);
+                bw.Write(distCodes[dc], distLens[dc]);
+                bw.Write(s.dist - kDistBase[dc], kDistExtra[dc]);
+            }
+        }
+        bw.Write(litCodes[256], litLens[256]);
+    }
+
+    /**
+     * Writes the data as uncompressed blocks.
+     */
+    static void WriteStored(BitWriter& bw, vector<unsigned char>& out, const unsigned char* data, size_t n)
+    {
+        size_t pos = 0;
+        do {
+            const size_t k = std::min<size_t>(n - pos, 65535);
+            bw.Write(pos + k == n ? 1 : 0, 1);
+            bw.Write(0, 2);
+            bw.AlignToByte();
+            bw.Write(static_cast<uint32_t>(k), 16);
+            bw.Write(static_cast<uint32_t>(~k & 0xffff), 16);
+            out.insert(out.end(), data + pos, data + pos + k);
+            pos += k;
+        } while (pos < n);
+    }
+
+    /**
+     * Computes the hash of three bytes.
+     */
+    static inline uint32_t Hash3(const unsigned char* p)
+    {
+        const uint32_t v = p[0] | (p[1] << 8) | (p[2] << 16);
+        return (v * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    /**
+     * Finds the longest match for the specified position.
+     */
+    static inline int FindMatch(
+        const unsigned char* data, size_t n, size_t pos,
+        const vector<int64_t>& head, const vector<int64_t>& prev,
+        const LevelParams& params, int minLength, int& bestDist)
+    {
+        // Only matches longer than minLength are of interest, which also
+        // keeps the comparison at m[bestLen] within the data.
+        const int maxLen = static_cast<int>(std::min<size_t>(MAX_MATCH, n - pos));
+        if (maxLen <= minLength) {
+            return 0;
+        }
+
+        int bestLen = minLength;
+        int64_t cand = head[Hash3(data + pos)];
+        const int64_t limit = static_cast<int64_t>(pos) - WINDOW_SIZE;
+        const unsigned char* cur = data + pos;
+
+        for (int chain = params.maxChain; chain > 0 && cand > limit && cand >= 0; --chain) {
+            const unsigned char* m = data + cand;
+            if (m[bestLen] == cur[bestLen] && m[0] == cur[0] && m[1] == cur[1]) {
+                int len = 2;
+                while (len < maxLen && m[len] == cur[len]) {
+                    ++len;
+                }
+
+                if (len > bestLen) {
+                    bestLen = len;
+                    bestDist = static_cast<int>(pos - cand);
+                    if (len >= params.niceLength || len == maxLen) {
+                        break;
+                    }
+                }
+            }
+
+            const int64_t next = prev[cand & (WINDOW_SIZE - 1)];
+            if (next >= cand) {
+                break;
+            }
+            cand = next;
+        }
+
+        return bestLen > minLength ? bestLen : 0;
+    }
+
+    void ZlibCompress(const unsigned char* data, size_t n, int level, vector<unsigned char>& out)
+    {
+        if (level < 0 || level > 9) {
+            throw std::domain_error("Compression level must be within [0, 9], got "
+                + std::to_string(level));
+        }
+
+        // zlib header, 32K window, no dictionary.
+        const int flevel = level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3));
+        uint32_t header = (0x78 << 8) | (flevel << 6);
+        header += 31 - header % 31;
+        out.push_back(static_cast<unsigned char>(header >> 8));
+        out.push_back(static_cast<unsigned char>(header));
+
+        BitWriter bw(out);
+        if (level == 0) {
+            WriteStored(bw, out, data, n);
+        } else {
+            const LevelParams& params = kLevelParams[level];
+            vector<int64_t> head(1 << HASH_BITS, -1);
+            vector<int64_t> prev(WINDOW_SIZE, -1);
+            vector<Symbol> symbols;
+            symbols.reserve(MAX_BLOCK_SYMBOLS);
+
+            auto insert = [&](size_t p) {
+                if (p + MIN_MATCH <= n) {
+                    const uint32_t h = Hash3(data + p);
+                    prev[p & (WINDOW_SIZE - 1)] = head[h];
+                    head[h] = static_cast<int64_t>(p);
+                }
+            };
+
+            size_t pos = 0;
+            while (pos < n) {
+                int dist = 0;
+                int len = FindMatch(data, n, pos, head, prev, params, MIN_MATCH - 1, dist);
+
+                if (len && params.lazy && len < params.niceLength && pos + 1 < n) {
+                    // Check whether the next position yields a longer match.
+                    insert(pos);
+                    int nextDist = 0;
+                    const int nextLen = FindMatch(data, n, pos + 1, head, prev, params, len, nextDist);
+                    if (nextLen) {
+                        symbols.push_back({data[pos], 0});
+                        ++pos;
+                        len = nextLen;
+                        dist = nextDist;
+                        insert(pos);
+                    }
+                    symbols.push_back({static_cast<uint16_t>(len), static_cast<uint16_t>(dist)});
+                    for (size_t p = pos + 1; p < pos + len; ++p) {
+                        insert(p);
+                    }
+                    pos += len;
+                } else if (len) {
+                    symbols.push_back({static_cast<uint16_t>(len), static_cast<uint16_t>(dist)});
+                    for (size_t p = pos; p < pos + len; ++p) {
+                        insert(p);
+                    }
+                    pos += len;
+                } else {
+                    insert(pos);
+                    symbols.push_back({data[pos], 0});
+                    ++pos;
+                }
+
+                if (symbols.size() >= MAX_BLOCK_SYMBOLS - 1) {
+                    WriteBlock(bw, symbols, pos >= n);
+                    symbols.clear();
+                }
+            }
+
+            if (!symbols.empty() || n == 0) {
+                WriteBlock(bw, symbols, true);
+            }
+        }
+        bw.AlignToByte();
+
+        const uint32_t adler = UpdateAdler32(1, data, n);
+        out.push_back(static_cast<unsigned char>(adler >> 24));
+        out.push_back(static_cast<unsigned char>(adler >> 16));
+        out.push_back(static_cast<unsigned char>(adler >> 8));
+        out.push_back(static_cast<unsigned char>(adler));
+    }
+
+    /////////////////////////////////////////////////
+    /////// Decompression
+    /////////////////////////////////////////////////
+
+    /**
+     * Reads bits LSB first from a byte array.
+     */
+    class BitReader {
+    public:
+        BitReader(const unsigned char* data, size_t n)
+            : data(data), size(n), pos(0), bits(0), numBits(0)
+        {
+            // Intentionally left empty.
+        }
+
+        /** Ensures that at least 32 bits are buffered, pads with zeros. */
+        void Refill() {
+            while (numBits <= 56) {
+                const uint64_t byte = pos < size ? data[pos] : 0;
+                ++pos;
+                bits |= byte << numBits;
+                numBits += 8;
+            }
+        }
+
+        uint32_t Peek(int n) {
+            if (numBits < n) {
+                Refill();
+            }
+            return static_cast<uint32_t>(bits & ((1ull << n) - 1));
+        }
+
+        void Consume(int n) {
+            bits >>= n;
+            numBits -= n;
+        }
+
+        uint32_t Read(int n) {
+            if (n == 0) {
+                return 0;
+            }
+            const uint32_t v = Peek(n);
+            Consume(n);
+            return v;
+        }
+
+        void AlignToByte() {
+            Consume(numBits & 7);
+        }
+
+        /** Returns the position of the next unread byte. */
+        size_t BytePosition() const {
+            return pos - numBits / 8;
+        }
+
+        /** Moves the read position to the specified byte, discarding buffered bits. */
+        void SetBytePosition(size_t p) {
+            pos = p;
+            bits = 0;
+            numBits = 0;
+        }
+
+        /** Returns whether bits beyond the end of the data have been consumed. */
+        bool IsOverrun() const {
+            return BytePosition() > size;
+        }
+
+    private:
+        const unsigned char* data;
+        size_t size;
+        size_t pos;
+        uint64_t bits;
+        int numBits;
+    };
+
+    /**
+     * A lookup table used to decode Huffman codes.
+     *
+     * Each entry is indexed by the next MAX_CODE_LENGTH bits of the input
+     * and stores the symbol and the length of its code.
+     */
+    class HuffmanTable {
+    public:
+        void Build(const uint8_t* lengths, int n) {
+            uint16_t codes[NUM_LITLEN_CODES + 2];
+            int count[MAX_CODE_LENGTH + 1] = {0};
+            for (int i = 0; i < n; ++i) {
+                ++count[lengths[i]];
+            }
+            count[0] = 0;
+
+            // Reject over-subscribed codes.
+            int left = 1;
+            for (int len = 1; len <= MAX_CODE_LENGTH; ++len) {
+                left <<= 1;
+                left -= count[len];
+                if (left < 0) {
+                    throw std::runtime_error("invalid deflate stream, over-subscribed Huffman code");
+                }
+            }
+
+            BuildCodes(lengths, n, codes);
+            entries.assign(1 << MAX_CODE_LENGTH, 0);
+            for (int s = 0; s < n; ++s) {
+                const int len = lengths[s];
+                if (len == 0) {
+                    continue;
+                }
+                const uint16_t entry = static_cast<uint16_t>((s << 4) | len);
+                for (uint32_t i = codes[s]; i < (1u << MAX_CODE_LENGTH); i += 1u << len) {
+                    entries[i] = entry;
+                }
+            }
+        }
+
+        int Decode(BitReader& br) const {
+            const uint16_t entry = entries[br.Peek(MAX_CODE_LENGTH)];
+            if (entry == 0) {
+                throw std::runtime_error("invalid deflate stream, invalid Huffman code");
+            }
+            br.Consume(entry & 0xf);
+            return entry >> 4;
+        }
+
+    private:
+        vector<uint16_t> entries;
+    };
+
+    /**
+     * Reads the code lengths of a dynamic Huffman block.
+     */
+    static void ReadDynamicTables(BitReader& br, HuffmanTable& lit, HuffmanTable& dist)
+    {
+        const int numLit = br.Read(5) + 257;
+        const int numDist = br.Read(5) + 1;
+        const int numCl = br.Read(4) + 4;
+        if (numLit > NUM_LITLEN_CODES || numDist > NUM_DIST_CODES) {
+            throw std::runtime_error("invalid deflate stream, too many codes");
+        }
+
+        uint8_t clLens[NUM_CODE_LENGTH_CODES] = {0};
+        for (int i = 0; i < numCl; ++i) {
+            clLens[kCodeLengthOrder[i]] = static_cast<uint8_t>(br.Read(3));
+        }
+
+        HuffmanTable clTable;
+        clTable.Build(clLens, NUM_CODE_LENGTH_CODES);
+
+        uint8_t lens[NUM_LITLEN_CODES + NUM_DIST_CODES] = {0};
+        int i = 0;
+        while (i < numLit + numDist) {
+            const int sym = clTable.Decode(br);
+            if (sym < 16) {
+                lens[i++] = static_cast<uint8_t>(sym);
+                continue;
+            }
+
+            int repeat;
+            uint8_t value = 0;
+            if (sym == 16) {
+                if (i == 0) {
+                    throw std::runtime_error("invalid deflate stream, repeat without length");
+                }
+                value = lens[i - 1];
+                repeat = 3 + br.Read(2);
+            } else if (sym == 17) {
+                repeat = 3 + br.Read(3);
+            } else {
+                repeat = 11 + br.Read(7);
+            }
+
+            if (i + repeat > numLit + numDist) {
+                throw std::runtime_error("invalid deflate stream, too many code lengths");
+            }
+            std::fill(lens + i, lens + i + repeat, value);
+            i += repeat;
+        }
+
+        if (lens[256] == 0) {
+            throw std::runtime_error("invalid deflate stream, missing end of block code");
+        }
+
+        lit.Build(lens, numLit);
+        dist.Build(lens + numLit, numDist);
+    }
+
+    void ZlibDecompress(const unsigned char* data, size_t n, vector<unsigned char>& out)
+    {
+        if (n < 6) {
+            throw std::runtime_error("invalid zlib stream, too short");
+        }
+
+        const uint32_t cmf = data[0];
+        const uint32_t flg = data[1];
+        if ((cmf & 0x0f) != 8 || (cmf >> 4) > 7 || ((cmf << 8) | flg) % 31 != 0) {
+            throw std::runtime_error("invalid zlib stream header");
+        }
+
+        if (flg & 0x20) {
+            throw std::runtime_error("unsupported zlib stream, preset dictionary");
+        }
+
+        const size_t start = out.size();
+        BitReader br(data + 2, n - 2);
+        HuffmanTable lit, dist;
+        bool last = false;
+
+        while (!last) {
+            last = br.Read(1) != 0;
+            const uint32_t type = br.Read(2);
+
+            if (type == 0) {
+                br.AlignToByte();
+                const uint32_t len = br.Read(16);
+                const uint32_t nlen = br.Read(16);
+                if ((len ^ 0xffff) != nlen) {
+                    throw std::runtime_error("invalid deflate stream, corrupt stored block");
+                }
+
+                const size_t p = br.BytePosition();
+                if (p + len > n - 2) {
+                    throw std::runtime_error("invalid deflate stream, truncated stored block");
+                }
+                out.insert(out.end(), data + 2 + p, data + 2 + p + len);
+                br.SetBytePosition(p + len);
+                continue;
+            }
+
+            if (type == 1) {
+                uint8_t lens[NUM_LITLEN_CODES + 2 + NUM_DIST_CODES];
+                std::fill(lens, lens + 144, 8);
+                std::fill(lens + 144, lens + 256, 9);
+                std::fill(lens + 256, lens + 280, 7);
+                std::fill(lens + 280, lens + 288, 8);
+                std::fill(lens + 288, lens + 288 + NUM_DIST_CODES, 5);
+                lit.Build(lens, 288);
+                dist.Build(lens + 288, NUM_DIST_CODES);
+            } else if (type == 2) {
+                ReadDynamicTables(br, lit, dist);
+            } else {
+                throw std::runtime_error("invalid deflate stream, invalid block type");
+            }
+
+            while (true) {
+                const int sym = lit.Decode(br);
+                if (sym < 256) {
+                    out.push_back(static_cast<unsigned char>(sym));
+                    continue;
+                }
+
+                if (sym == 256) {
+                    break;
+                }
+
+                const int lc = sym - 257;
+                if (lc >= 29) {
+                    throw std::runtime_error("invalid deflate stream, invalid length code");
+                }
+                const size_t len = kLengthBase[lc] + br.Read(kLengthExtra[lc]);
+
+                const int dc = dist.Decode(br);
+                if (dc >= NUM_DIST_CODES) {
+                    throw std::runtime_error("invalid deflate stream, invalid distance code");
+                }
+                const size_t d = kDistBase[dc] + br.Read(kDistExtra[dc]);
+                if (d > out.size() - start) {
+                    throw std::runtime_error("invalid deflate stream, distance too far back");
+                }
+
+                const size_t from = out.size() - d;
+                out.resize(out.size() + len);
+                unsigned char* dst = out.data() + out.size() - len;
+                const unsigned char* src = out.data() + from;
+                for (size_t i = 0; i < len; ++i) {
+                    dst[i] = src[i];
+                }
+            }
+
+            if (br.IsOverrun()) {
+                throw std::runtime_error("invalid deflate stream, unexpected end of data");
+            }
+        }
+
+        br.AlignToByte();
+        const size_t p = br.BytePosition() + 2;
+        if (p + 4 > n) {
+            throw std::runtime_error("invalid zlib stream, missing checksum");
+        }
+
+        const uint32_t expected = (static_cast<uint32_t>(data[p]) << 24)
+            | (data[p + 1] << 16) | (data[p + 2] << 8) | data[p + 3];
+        if (UpdateAdler32(1, out.data() + start, out.size() - start) != expected) {
+            throw std::runtime_error("invalid zlib stream, checksum mismatch");
+        }
+    }
+
+} // end of namespace
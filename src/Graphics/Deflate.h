@@ -0,0 +1,62 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+#pragma once
+
+// C++ Standard Library includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace astu {
+
+    /**
+     * Updates a CRC-32 checksum, as used by PNG and ZIP.
+     *
+     * @param crc   the checksum of the preceding data, zero for no data
+     * @param data  the data to process
+     * @param n     the number of bytes to process
+     * @return the updated checksum
+     */
+    uint32_t UpdateCrc32(uint32_t crc, const unsigned char* data, size_t n);
+
+    /**
+     * Updates an Adler-32 checksum, as used by the zlib format.
+     *
+     * @param adler the checksum of the preceding data, one for no data
+     * @param data  the data to process
+     * @param n     the number of bytes to process
+     * @return the updated checksum
+     */
+    uint32_t UpdateAdler32(uint32_t adler, const unsigned char* data, size_t n);
+
+    /**
+     * Compresses data using the deflate algorithm and wraps the result
+     * into a zlib stream (RFC 1950 and RFC 1951).
+     *
+     * Level zero stores the data uncompressed, higher levels search
+     * longer for matches. Compressed blocks use dynamic Huffman codes.
+     *
+     * @param data  the data to compress
+     * @param n     the number of bytes to compress
+     * @param level the compression level within the range [0, 9]
+     * @param out   receives the zlib stream, existing content is kept
+     * @throws std::domain_error in case the compression level is invalid
+     */
+    void ZlibCompress(const unsigned char* data, size_t n, int level, std::vector<unsigned char>& out);
+
+    /**
+     * Decompresses a zlib stream.
+     *
+     * @param data  the zlib stream
+     * @param n     the size of the zlib stream in bytes
+     * @param out   receives the decompressed data, existing content is kept
+     * @throws std::runtime_error in case the stream is invalid
+     */
+    void ZlibDecompress(const unsigned char* data, size_t n, std::vector<unsigned char>& out);
+
+} // end of namespace
@@ -0,0 +1,526 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+// Local includes
+#include "Graphics/FrameSink.h"
+
+// C++ Standard Library includes
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+using namespace std;
+
+#define AVIF_HASINDEX       0x00000010
+#define AVIIF_KEYFRAME      0x00000010
+
+/** The size of the AVI headers preceding the frame data list, including the RIFF header. */
+#define AVI_HEADER_SIZE     (12 + 12 + 8 + 56 + 12 + 8 + 56 + 8 + 40)
+
+#pragma pack(push, 1)
+
+// Note: AVI files use Little-endian. This code does assume that the machine
+// executing this code is using Little-endian as well.
+
+struct AviMainHeader {
+    uint32_t microSecPerFrame;
+    uint32_t maxBytesPerSec;
+    uint32_t paddingGranularity;
+    uint32_t flags;
+    uint32_t totalFrames;
+    uint32_t initialFrames;
+    uint32_t streams;
+    uint32_t suggestedBufferSize;
+    uint32_t width;
+    uint32_t height;
+    uint32_t reserved[4];
+};
+
+struct AviStreamHeader {
+    char fccType[4];
+    char fccHandler[4];
+    uint32_t flags;
+    uint16_t priority;
+    uint16_t language;
+    uint32_t initialFrames;
+    uint32_t scale;
+    uint32_t rate;
+    uint32_t start;
+    uint32_t length;
+    uint32_t suggestedBufferSize;
+    uint32_t quality;
+    uint32_t sampleSize;
+    int16_t frame[4];
+};
+
+struct AviBitmapInfoHeader {
+    uint32_t biSize;
+    int32_t biWidth;
+    int32_t biHeight;
+    uint16_t biPlanes;
+    uint16_t biBitCount;
+    uint32_t biCompression;
+    uint32_t biSizeImage;
+    int32_t biXPelsPerMeter;
+    int32_t biYPelsPerMeter;
+    uint32_t biClrUsed;
+    uint32_t biClrImportant;
+};
+
+struct AviIndexEntry {
+    char chunkId[4];
+    uint32_t flags;
+    uint32_t offset;
+    uint32_t size;
+};
+
+#pragma pack(pop)
+
+namespace astu {
+
+    /////////////////////////////////////////////////
+    /////// Utility functions
+    /////////////////////////////////////////////////
+
+    /**
+     * Approximates a frame rate by a rational number.
+     */
+    static void ToRational(double frameRate, uint32_t & num, uint32_t & den)
+    {
+        if (!(frameRate >= 0.001) || frameRate > 1e6) {
+            throw std::domain_error("Frame rate must be within [0.001, 1e6], got "
+                + std::to_string(frameRate));
+        }
+
+        // Recognize NTSC-style rates like 30000/1001, other rates are
+        // represented in thousandths.
+        const double ntsc = frameRate * 1001;
+        const double milli = frameRate * 1000;
+        if (std::abs(milli - std::round(milli)) > 1e-6 && std::abs(ntsc - std::round(ntsc)) < 1e-6) {
+            num = static_cast<uint32_t>(std::round(ntsc));
+            den = 1001;
+            return;
+        }
+
+        den = 1000;
+        num = static_cast<uint32_t>(std::round(frameRate * den));
+        const uint32_t d = std::gcd(num, den);
+        num /= d;
+        den /= d;
+    }
+
+    static void ValidateDimensions(const ImageRgba8 & frame, int width, int height)
+    {
+        if (frame.GetWidth() != width || frame.GetHeight() != height) {
+            throw std::domain_error("Frame dimensions must not change within a sequence");
+        }
+    }
+
+    /////////////////////////////////////////////////
+    /////// Y4mWriter
+    /////////////////////////////////////////////////
+
+    Y4mWriter::Y4mWriter(const std::string & filename, double frameRate, bool subsampleChroma)
+        : subsampleChroma(subsampleChroma)
+        , width(0)
+        , height(0)
+    {
+        ToRational(frameRate, rateNum, rateDen);
+
+        ofs.open(filename, std::ios::out | std::ios::binary);
+        if (!ofs) {
+            throw std::runtime_error("unable to open Y4M file for writing '" + filename + "'");
+        }
+    }
+
+    Y4mWriter::~Y4mWriter()
+    {
+        try {
+            Close();
+        } catch (const std::exception & e) {
+            cerr << "Unable to close Y4M file: " << e.what() << endl;
+        }
+    }
+
+    /** Computes the luma of an 8-bit RGB color (BT.601, limited range). */
+    static inline uint8_t LumaOf(int r, int g, int b)
+    {
+        return static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+    }
+
+    /** Computes the blue-difference chroma of an 8-bit RGB color. */
+    static inline uint8_t CbOf(int r, int g, int b)
+    {
+        return static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+    }
+
+    /** Computes the red-difference chroma of an 8-bit RGB color. */
+    static inline uint8_t CrOf(int r, int g, int b)
+    {
+        return static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+
+    void Y4mWriter::WriteFrame(const ImageRgba8 & frame)
+    {
+        if (!ofs.is_open()) {
+            throw std::runtime_error("unable to write frame, Y4M file has been closed");
+        }
+
+        if (width == 0) {
+            width = frame.GetWidth();
+            height = frame.GetHeight();
+            ofs << "YUV4MPEG2 W" << width << " H" << height
+                << " F" << rateNum << ":" << rateDen << " Ip A1:1 "
+                << (subsampleChroma ? "C420jpeg" : "C444") << "\n";
+        } else {
+            ValidateDimensions(frame, width, height);
+        }
+
+        const size_t lumaSize = static_cast<size_t>(width) * height;
+        const int cw = subsampleChroma ? (width + 1) / 2 : width;
+        const int ch = subsampleChroma ? (height + 1) / 2 : height;
+        const size_t chromaSize = static_cast<size_t>(cw) * ch;
+        planes.resize(lumaSize + 2 * chromaSize);
+        uint8_t* yPlane = planes.data();
+        uint8_t* uPlane = yPlane + lumaSize;
+        uint8_t* vPlane = uPlane + chromaSize;
+
+        for (int y = 0; y < height; ++y) {
+            const Rgba8* row = frame.GetRow(y);
+            uint8_t* dst = yPlane + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                dst[x] = LumaOf(row[x].r, row[x].g, row[x].b);
+            }
+        }
+
+        if (subsampleChroma) {
+            // Average the colors of 2x2 blocks, matching the centered chroma
+            // siting of C420jpeg.
+            for (int cy = 0; cy < ch; ++cy) {
+                const Rgba8* row0 = frame.GetRow(cy * 2);
+                const Rgba8* row1 = frame.GetRow(std::min(cy * 2 + 1, height - 1));
+                uint8_t* u = uPlane + static_cast<size_t>(cy) * cw;
+                uint8_t* v = vPlane + static_cast<size_t>(cy) * cw;
+                for (int cx = 0; cx < cw; ++cx) {
+                    const int x0 = cx * 2;
+                    const int x1 = std::min(x0 + 1, width - 1);
+                    const int r = (row0[x0].r + row0[x1].r + row1[x0].r + row1[x1].r + 2) >> 2;
+                    const int g = (row0[x0].g + row0[x1].g + row1[x0].g + row1[x1].g + 2) >> 2;
+                    const int b = (row0[x0].b + row0[x1].b + row1[x0].b + row1[x1].b + 2) >> 2;
+                    u[cx] = CbOf(r, g, b);
+                    v[cx] = CrOf(r, g, b);
+                }
+            }
+        } else {
+            for (int y = 0; y < height; ++y) {
+                const Rgba8* row = frame.GetRow(y);
+                uint8_t* u = uPlane + static_cast<size_t>(y) * width;
+                uint8_t* v = vPlane + static_cast<size_t>(y) * width;
+                for (int x = 0; x < width; ++x) {
+                    u[x] = CbOf(row[x].r, row[x].g, row[x].b);
+                    v[x] = CrOf(row[x].r, row[x].g, row[x].b);
+                }
+            }
+        }
+
+        ofs << "FRAME\n";
+        ofs.write(reinterpret_cast<const char*>(planes.data()), planes.size());
+        if (!ofs) {
+            throw std::runtime_error("unable to write frame to Y4M file");
+        }
+    }
+
+    void Y4mWriter::Close()
+    {
+        if (!ofs.is_open()) {
+            return;
+        }
+
+        ofs.close();
+        if (!ofs) {
+            throw std::runtime_error("unable to write Y4M file");
+        }
+    }
+
+    /////////////////////////////////////////////////
+    /////// AviWriter
+    /////////////////////////////////////////////////
+
+    AviWriter::AviWriter(const std::string & filename, double frameRate)
+        : width(0)
+        , height(0)
+        , frameSize(0)
+        , moviOffset(0)
+    {
+        ToRational(frameRate, rateNum, rateDen);
+
+        ofs.open(filename, std::ios::out | std::ios::binary);
+        if (!ofs) {
+            throw std::runtime_error("unable to open AVI file for writing '" + filename + "'");
+        }
+    }
+
+    AviWriter::~AviWriter()
+    {
+        try {
+            Close();
+        } catch (const std::exception & e) {
+            cerr << "Unable to close AVI file: " << e.what() << endl;
+        }
+    }
+
+    /**
+     * Writes a four-character code followed by a 32-bit value.
+     */
+    static void WriteTag(std::ostream & os, const char* fourcc, uint32_t value)
+    {
+        os.write(fourcc, 4);
+        os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void AviWriter::WriteHeader()
+    {
+        const uint32_t numFrames = static_cast<uint32_t>(frameOffsets.size());
+        const uint64_t moviSize = 4 + static_cast<uint64_t>(numFrames) * (8 + frameSize);
+        const uint64_t indexSize = static_cast<uint64_t>(numFrames) * sizeof(AviIndexEntry);
+        const uint64_t riffSize = AVI_HEADER_SIZE - 8 + 8 + moviSize + 8 + indexSize;
+
+        AviMainHeader avih = {};
+        avih.microSecPerFrame = static_cast<uint32_t>(std::round(1e6 * rateDen / rateNum));
+        avih.maxBytesPerSec = static_cast<uint32_t>(std::min<uint64_t>(UINT32_MAX,
+            static_cast<uint64_t>(frameSize) * rateNum / rateDen + 1));
+        avih.flags = AVIF_HASINDEX;
+        avih.totalFrames = numFrames;
+        avih.streams = 1;
+        avih.suggestedBufferSize = frameSize + 8;
+        avih.width = width;
+        avih.height = height;
+
+        AviStreamHeader strh = {};
+        std::memcpy(strh.fccType, "vids", 4);
+        std::memcpy(strh.fccHandler, "DIB ", 4);
+        strh.scale = rateDen;
+        strh.rate = rateNum;
+        strh.length = numFrames;
+        strh.suggestedBufferSize = frameSize + 8;
+        strh.quality = UINT32_MAX;
+        strh.frame[2] = static_cast<int16_t>(width);
+        strh.frame[3] = static_cast<int16_t>(height);
+
+        AviBitmapInfoHeader strf = {};
+        strf.biSize = sizeof(AviBitmapInfoHeader);
+        strf.biWidth = width;
+        strf.biHeight = height;
+        strf.biPlanes = 1;
+        strf.biBitCount = 24;
+        strf.biSizeImage = frameSize;
+
+        ofs.seekp(0);
+        WriteTag(ofs, "RIFF", static_cast<uint32_t>(riffSize));
+        ofs.write("AVI ", 4);
+        WriteTag(ofs, "LIST", 4 + 8 + sizeof(avih) + 12 + 8 + sizeof(strh) + 8 + sizeof(strf));
+        ofs.write("hdrl", 4);
+        WriteTag(ofs, "avih", sizeof(avih));
+        ofs.write(reinterpret_cast<const char*>(&avih), sizeof(avih));
+        WriteTag(ofs, "LIST", 4 + 8 + sizeof(strh) + 8 + sizeof(strf));
+        ofs.write("strl", 4);
+        WriteTag(ofs, "strh", sizeof(strh));
+        ofs.write(reinterpret_cast<const char*>(&strh), sizeof(strh));
+        WriteTag(ofs, "strf", sizeof(strf));
+        ofs.write(reinterpret_cast<const char*>(&strf), sizeof(strf));
+        WriteTag(ofs, "LIST", static_cast<uint32_t>(moviSize));
+        ofs.write("movi", 4);
+    }
+
+    void AviWriter::WriteFrame(const ImageRgba8 & frame)
+    {
+        if (!ofs.is_open()) {
+            throw std::runtime_error("unable to write frame, AVI file has been closed");
+        }
+
+        if (width == 0) {
+            if (frame.GetWidth() > INT16_MAX || frame.GetHeight() > INT16_MAX) {
+                throw std::domain_error("Frame dimensions exceed the limits of AVI files");
+            }
+
+            // Rows are padded to four bytes, the size of a single frame
+            // might already exceed the 32-bit sizes of AVI files.
+            const uint64_t rowBytes = (static_cast<uint64_t>(frame.GetWidth()) * 3 + 3) & ~uint64_t(3);
+            const uint64_t frameBytes = rowBytes * frame.GetHeight();
+            if (frameBytes > UINT32_MAX) {
+                throw std::runtime_error("AVI file size limit of 4 GB exceeded");
+            }
+
+            width = frame.GetWidth();
+            height = frame.GetHeight();
+            frameSize = static_cast<uint32_t>(frameBytes);
+            WriteHeader();
+            moviOffset = AVI_HEADER_SIZE + 8;
+        } else {
+            ValidateDimensions(frame, width, height);
+        }
+
+        const uint64_t offset = 4 + static_cast<uint64_t>(frameOffsets.size()) * (8 + frameSize);
+        const uint64_t fileSize = moviOffset + offset + 8 + frameSize
+            + 8 + (frameOffsets.size() + 1) * sizeof(AviIndexEntry);
+        if (fileSize > UINT32_MAX) {
+            throw std::runtime_error("AVI file size limit of 4 GB exceeded");
+        }
+
+        // Rows are stored bottom-up as BGR triples padded to four bytes.
+        const size_t rowSize = frameSize / height;
+        buffer.assign(frameSize, 0);
+        for (int y = 0; y < height; ++y) {
+            const Rgba8* src = frame.GetRow(height - 1 - y);
+            uint8_t* dst = buffer.data() + y * rowSize;
+            for (int x = 0; x < width; ++x) {
+                dst[x * 3] = src[x].b;
+                dst[x * 3 + 1] = src[x].g;
+                dst[x * 3 + 2] = src[x].r;
+            }
+        }
+
+        WriteTag(ofs, "00db", frameSize);
+        ofs.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        if (!ofs) {
+            throw std::runtime_error("unable to write frame to AVI file");
+        }
+        frameOffsets.push_back(static_cast<uint32_t>(offset));
+    }
+
+    void AviWriter::Close()
+    {
+        if (!ofs.is_open()) {
+            return;
+        }
+
+        if (width > 0) {
+            vector<AviIndexEntry> index(frameOffsets.size());
+            for (size_t i = 0; i < index.size(); ++i) {
+                std::memcpy(index[i].chunkId, "00db", 4);
+                index[i].flags = AVIIF_KEYFRAME;
+                index[i].offset = frameOffsets[i];
+                index[i].size = frameSize;
+            }
+
+            WriteTag(ofs, "idx1", static_cast<uint32_t>(index.size() * sizeof(AviIndexEntry)));
+            ofs.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(AviIndexEntry));
+
+            // Complete the header now that the number of frames is known.
+            WriteHeader();
+        }
+
+        ofs.close();
+        if (!ofs) {
+            throw std::runtime_error("unable to write AVI file");
+        }
+    }
+
+    /////////////////////////////////////////////////
+    /////// AsyncFrameSink
+    /////////////////////////////////////////////////
+
+    AsyncFrameSink::AsyncFrameSink(std::unique_ptr<FrameSink> sink, size_t capacity)
+        : sink(std::move(sink))
+        , head(0)
+        , count(0)
+        , closing(false)
+        , closed(false)
+    {
+        if (capacity == 0) {
+            throw std::domain_error("Capacity of frame buffer must be greater zero");
+        }
+
+        slots.resize(capacity);
+        writer = std::thread(&AsyncFrameSink::RunWriter, this);
+    }
+
+    AsyncFrameSink::~AsyncFrameSink()
+    {
+        try {
+            Close();
+        } catch (const std::exception & e) {
+            cerr << "Unable to write frames: " << e.what() << endl;
+        }
+    }
+
+    void AsyncFrameSink::WriteFrame(const ImageRgba8 & frame)
+    {
+        unique_lock<std::mutex> lock(mutex);
+        if (closing) {
+            throw std::runtime_error("unable to write frame, frame sink has been closed");
+        }
+
+        notFull.wait(lock, [this]() { return count < slots.size() || error; });
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        // Slots are reused, copying a frame does not allocate memory
+        // as long as the frame dimensions do not change.
+        auto & slot = slots[(head + count) % slots.size()];
+        lock.unlock();
+        if (!slot || slot->GetWidth() != frame.GetWidth() || slot->GetHeight() != frame.GetHeight()) {
+            slot = std::make_unique<ImageRgba8>(frame.GetWidth(), frame.GetHeight());
+        }
+        std::memcpy(slot->GetPixels(), frame.GetPixels(), frame.NumberOfPixels() * sizeof(Rgba8));
+        lock.lock();
+
+        ++count;
+        notEmpty.notify_one();
+    }
+
+    void AsyncFrameSink::Close()
+    {
+        {
+            lock_guard<std::mutex> lock(mutex);
+            if (closed) {
+                return;
+            }
+            closing = true;
+            closed = true;
+        }
+        notEmpty.notify_one();
+        writer.join();
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        sink->Close();
+    }
+
+    void AsyncFrameSink::RunWriter()
+    {
+        unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            notEmpty.wait(lock, [this]() { return count > 0 || closing; });
+            if (count == 0) {
+                return;
+            }
+
+            // The slot stays occupied while being written.
+            const ImageRgba8 & frame = *slots[head];
+            lock.unlock();
+            try {
+                sink->WriteFrame(frame);
+            } catch (...) {
+                lock.lock();
+                error = std::current_exception();
+                notFull.notify_all();
+                return;
+            }
+            lock.lock();
+
+            head = (head + 1) % slots.size();
+            --count;
+            notFull.notify_one();
+        }
+    }
+
+} // end of namespace
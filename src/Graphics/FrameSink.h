@@ -0,0 +1,252 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+#pragma once
+
+// C++ Standard Library includes
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Local includes
+#include "Graphics/PixelImage.h"
+
+namespace astu {
+
+    /**
+     * Interface for consumers of frame sequences, e.g., video files.
+     *
+     * Frames are written in presentation order. All frames of a sequence
+     * must have the same dimensions.
+     */
+    class FrameSink {
+    public:
+
+        /**
+         * Virtual destructor.
+         */
+        virtual ~FrameSink() {}
+
+        /**
+         * Writes the next frame of the sequence.
+         *
+         * @param frame the frame to write
+         * @throws std::domain_error in case the frame dimensions differ
+         *      from the dimensions of the first frame
+         * @throws std::runtime_error in case of an I/O error
+         */
+        virtual void WriteFrame(const ImageRgba8 & frame) = 0;
+
+        /**
+         * Finishes the sequence.
+         *
+         * No frames must be written after the sink has been closed.
+         * Closing a sink more than once has no effect.
+         *
+         * @throws std::runtime_error in case of an I/O error
+         */
+        virtual void Close() = 0;
+    };
+
+    /**
+     * Writes frames as raw YUV4MPEG2 (Y4M) stream.
+     *
+     * Y4M files can be fed directly to most video encoders, e.g.,
+     * `ffmpeg -i frames.y4m out.mp4`. The frames are converted to
+     * YCbCr (ITU-R BT.601, limited range), the alpha channel is ignored.
+     * The stream header is written together with the first frame.
+     */
+    class Y4mWriter : public FrameSink {
+    public:
+
+        /**
+         * Constructor.
+         *
+         * @param filename          the filename including the file path
+         * @param frameRate         the number of frames per second
+         * @param subsampleChroma   whether to use 4:2:0 chroma subsampling,
+         *                          which is expected by most encoders,
+         *                          instead of 4:4:4
+         * @throws std::domain_error in case the frame rate is invalid
+         * @throws std::runtime_error in case the file cannot be created
+         */
+        Y4mWriter(const std::string & filename, double frameRate, bool subsampleChroma = true);
+
+        /**
+         * Destructor, closes the file.
+         */
+        virtual ~Y4mWriter();
+
+        // Inherited via FrameSink
+        virtual void WriteFrame(const ImageRgba8 & frame) override;
+        virtual void Close() override;
+
+    private:
+        /** The output file. */
+        std::ofstream ofs;
+
+        /** The frame rate as rational number. */
+        uint32_t rateNum, rateDen;
+
+        /** Whether chroma planes are subsampled. */
+        bool subsampleChroma;
+
+        /** The frame dimensions, zero before the first frame. */
+        int width, height;
+
+        /** Holds the planes of one frame. */
+        std::vector<uint8_t> planes;
+    };
+
+    /**
+     * Writes frames as uncompressed AVI file (24-bit RGB).
+     *
+     * The file is a plain RIFF AVI file which is limited to 4 GB, longer
+     * sequences should be written as Y4M stream. The header is written
+     * together with the first frame and completed when the writer gets
+     * closed.
+     */
+    class AviWriter : public FrameSink {
+    public:
+
+        /**
+         * Constructor.
+         *
+         * @param filename  the filename including the file path
+         * @param frameRate the number of frames per second
+         * @throws std::domain_error in case the frame rate is invalid
+         * @throws std::runtime_error in case the file cannot be created
+         */
+        AviWriter(const std::string & filename, double frameRate);
+
+        /**
+         * Destructor, closes the file.
+         */
+        virtual ~AviWriter();
+
+        // Inherited via FrameSink
+        virtual void WriteFrame(const ImageRgba8 & frame) override;
+        virtual void Close() override;
+
+    private:
+        /** The output file. */
+        std::ofstream ofs;
+
+        /** The frame rate as rational number. */
+        uint32_t rateNum, rateDen;
+
+        /** The frame dimensions, zero before the first frame. */
+        int width, height;
+
+        /** The number of bytes of one frame including row padding. */
+        uint32_t frameSize;
+
+        /** The file offset of the frame data list. */
+        uint64_t moviOffset;
+
+        /** The file offsets of the frames relative to the frame data list. */
+        std::vector<uint32_t> frameOffsets;
+
+        /** Holds the pixels of one frame. */
+        std::vector<uint8_t> buffer;
+
+        void WriteHeader();
+    };
+
+    /**
+     * Decouples the production of frames from writing them.
+     *
+     * Frames are copied into a ring buffer of preallocated frames and
+     * passed to the wrapped sink by a background thread. Writing a frame
+     * blocks only if the ring buffer is full. Errors of the wrapped sink
+     * are reported by the next call to WriteFrame() or Close().
+     *
+     * **Example**
+     *
+     * ```
+     * AsyncFrameSink sink(std::make_unique<Y4mWriter>("out.y4m", 25));
+     * for (...) {
+     *     // ... render frame
+     *     sink.WriteFrame(frame);
+     * }
+     * sink.Close();
+     * ```
+     */
+    class AsyncFrameSink : public FrameSink {
+    public:
+
+        /**
+         * Constructor.
+         *
+         * @param sink      the sink which receives the frames
+         * @param capacity  the maximum number of buffered frames
+         * @throws std::domain_error in case the capacity is zero
+         */
+        AsyncFrameSink(std::unique_ptr<FrameSink> sink, size_t capacity = 8);
+
+        /**
+         * Destructor, closes this sink.
+         */
+        virtual ~AsyncFrameSink();
+
+        /** Copying is not allowed. */
+        AsyncFrameSink(const AsyncFrameSink&) = delete;
+
+        /** Copy assignment is not allowed. */
+        AsyncFrameSink& operator=(const AsyncFrameSink&) = delete;
+
+        // Inherited via FrameSink
+        virtual void WriteFrame(const ImageRgba8 & frame) override;
+        virtual void Close() override;
+
+    private:
+        /** The sink which receives the frames. */
+        std::unique_ptr<FrameSink> sink;
+
+        /** The ring buffer of frames. */
+        std::vector<std::unique_ptr<ImageRgba8>> slots;
+
+        /** The index of the oldest buffered frame. */
+        size_t head;
+
+        /** The number of buffered frames. */
+        size_t count;
+
+        /** Whether no more frames will be written. */
+        bool closing;
+
+        /** Whether this sink has been closed. */
+        bool closed;
+
+        /** The first error reported by the wrapped sink. */
+        std::exception_ptr error;
+
+        /** Protects the ring buffer. */
+        std::mutex mutex;
+
+        /** Signals buffered frames to the writer thread. */
+        std::condition_variable notEmpty;
+
+        /** Signals free slots to producers. */
+        std::condition_variable notFull;
+
+        /** The thread which writes the frames. */
+        std::thread writer;
+
+        /**
+         * The main loop of the writer thread.
+         */
+        void RunWriter();
+    };
+
+} // end of namespace
@@ -0,0 +1,472 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+// Local includes
+#include "Graphics/ImageProcessor.h"
+#include "Graphics/ColorHsv.h"
+#include "Math/MathUtils.h"
+#include "Util/ThreadPool.h"
+
+// C++ Standard Library includes
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+/** The minimum number of rows processed by one task. */
+#define ROWS_PER_TASK 16
+
+/** The number of lobes of the Lanczos filter. */
+#define LANCZOS_LOBES 3
+
+namespace astu {
+
+    /////////////////////////////////////////////////
+    /////// Helper functions
+    /////////////////////////////////////////////////
+
+    static void ValidateSameDimensions(const Image & src, const Image & dst)
+    {
+        if (src.GetWidth() != dst.GetWidth() || src.GetHeight() != dst.GetHeight()) {
+            throw std::domain_error("Dimensions of source and destination image differ, got "
+                + to_string(src.GetWidth()) + "x" + to_string(src.GetHeight()) + " and "
+                + to_string(dst.GetWidth()) + "x" + to_string(dst.GetHeight()));
+        }
+    }
+
+    static inline int Clamp(int x, int lo, int hi)
+    {
+        return x < lo ? lo : (x > hi ? hi : x);
+    }
+
+    /**
+     * Copies a row into a buffer and replicates the border pixels.
+     */
+    static void PadRow(const Color4d* row, int w, int r, vector<double> & pad)
+    {
+        pad.resize(static_cast<size_t>(w + 2 * r) * 4);
+        const double* src = &row->r;
+        for (int i = 0; i < r; ++i) {
+            std::copy(src, src + 4, pad.data() + i * 4);
+            std::copy(src + (w - 1) * 4, src + w * 4, pad.data() + (r + w + i) * 4);
+        }
+        std::copy(src, src + static_cast<size_t>(w) * 4, pad.data() + r * 4);
+    }
+
+    /**
+     * Evaluates the resampling filter.
+     */
+    static double EvalFilter(ResizeFilter filter, double x)
+    {
+        x = std::abs(x);
+        switch (filter) {
+        case ResizeFilter::Bilinear:
+            return x < 1 ? 1 - x : 0;
+
+        case ResizeFilter::Lanczos:
+            if (x < 1e-8) {
+                return 1;
+            }
+            if (x >= LANCZOS_LOBES) {
+                return 0;
+            } else {
+                const double px = MathUtils::PId * x;
+                return LANCZOS_LOBES * std::sin(px) * std::sin(px / LANCZOS_LOBES) / (px * px);
+            }
+        }
+        return 0;
+    }
+
+    /** The range of source pixels contributing to one target pixel. */
+    struct Contribution {
+        int first;
+        int count;
+        size_t offset;
+    };
+
+    /**
+     * Computes the normalized filter weights for resampling one axis.
+     */
+    static void CalcContributions(
+        ResizeFilter filter, int srcSize, int dstSize,
+        vector<Contribution> & contribs, vector<double> & weights)
+    {
+        const double scale = static_cast<double>(srcSize) / dstSize;
+        const double filterScale = std::max(1.0, scale);
+        const double support = (filter == ResizeFilter::Bilinear ? 1.0 : LANCZOS_LOBES) * filterScale;
+
+        contribs.resize(dstSize);
+        weights.clear();
+        for (int i = 0; i < dstSize; ++i) {
+            const double center = (i + 0.5) * scale - 0.5;
+            const int first = std::max(0, static_cast<int>(std::floor(center - support)) + 1);
+            const int last = std::min(srcSize - 1, static_cast<int>(std::floor(center + support)));
+
+            Contribution & c = contribs[i];
+            c.offset = weights.size();
+            double sum = 0;
+            for (int j = first; j <= last; ++j) {
+                const double w = EvalFilter(filter, (j - center) / filterScale);
+                weights.push_back(w);
+                sum += w;
+            }
+
+            if (sum == 0) {
+                // Degenerated case, use the nearest pixel.
+                weights.resize(c.offset);
+                c.first = Clamp(static_cast<int>(std::floor(center + 0.5)), 0, srcSize - 1);
+                c.count = 1;
+                weights.push_back(1);
+                continue;
+            }
+
+            c.first = first;
+            c.count = last - first + 1;
+            for (int j = 0; j < c.count; ++j) {
+                weights[c.offset + j] /= sum;
+            }
+        }
+    }
+
+    /////////////////////////////////////////////////
+    /////// ImageProcessor
+    /////////////////////////////////////////////////
+
+    ImageProcessor::ImageProcessor(size_t numThreads)
+        : numThreads(numThreads)
+    {
+        // Intentionally left empty.
+    }
+
+    ImageProcessor::~ImageProcessor()
+    {
+        // Intentionally left empty.
+    }
+
+    void ImageProcessor::SetNumThreads(size_t n)
+    {
+        if (n != numThreads) {
+            numThreads = n;
+            threadPool = nullptr;
+        }
+    }
+
+    void ImageProcessor::ProcessRows(int numRows, const std::function<void(int, int)> & func)
+    {
+        if (numThreads == 1 || numRows <= ROWS_PER_TASK) {
+            func(0, numRows);
+            return;
+        }
+
+        if (!threadPool) {
+            // The calling thread processes one chunk itself.
+            threadPool = std::make_unique<ThreadPool>(
+                numThreads == 0 ? 0 : numThreads - 1);
+        }
+
+        threadPool->ParallelFor(0, numRows,
+            [&func](size_t y0, size_t y1) {
+                func(static_cast<int>(y0), static_cast<int>(y1));
+            },
+            ROWS_PER_TASK);
+    }
+
+    // All loops below treat rows as flat arrays of color components,
+    // which allows the compiler to vectorize them.
+
+    void ImageProcessor::ConvolveSeparable(
+        const Image & src, Image & dst, const vector<double> & kernel)
+    {
+        const int w = src.GetWidth();
+        const int h = src.GetHeight();
+        const int r = static_cast<int>(kernel.size() / 2);
+        const size_t n = static_cast<size_t>(w) * 4;
+        scratch.resize(static_cast<size_t>(w) * h);
+
+        // Horizontal pass into the scratch buffer.
+        ProcessRows(h, [&](int y0, int y1) {
+            vector<double> pad;
+            for (int y = y0; y < y1; ++y) {
+                PadRow(src.GetRow(y), w, r, pad);
+                double* out = &scratch[static_cast<size_t>(y) * w].r;
+                std::fill(out, out + n, 0.0);
+                for (size_t k = 0; k < kernel.size(); ++k) {
+                    const double wk = kernel[k];
+                    const double* in = pad.data() + k * 4;
+                    for (size_t i = 0; i < n; ++i) {
+                        out[i] += wk * in[i];
+                    }
+                }
+            }
+        });
+
+        // Vertical pass into the destination image.
+        ProcessRows(h, [&](int y0, int y1) {
+            for (int y = y0; y < y1; ++y) {
+                double* out = &dst.GetRow(y)->r;
+                std::fill(out, out + n, 0.0);
+                for (int k = -r; k <= r; ++k) {
+                    const double wk = kernel[k + r];
+                    const double* in = &scratch[static_cast<size_t>(Clamp(y + k, 0, h - 1)) * w].r;
+                    for (size_t i = 0; i < n; ++i) {
+                        out[i] += wk * in[i];
+                    }
+                }
+            }
+        });
+    }
+
+    void ImageProcessor::GaussianBlur(const Image & src, Image & dst, double sigma)
+    {
+        ValidateSameDimensions(src, dst);
+        if (sigma <= 0) {
+            throw std::domain_error("Sigma of Gaussian blur must be greater zero, got "
+                + to_string(sigma));
+        }
+
+        const int r = std::max(1, static_cast<int>(std::ceil(3 * sigma)));
+        vector<double> kernel(2 * r + 1);
+        double sum = 0;
+        for (int i = -r; i <= r; ++i) {
+            kernel[i + r] = std::exp(-(i * i) / (2 * sigma * sigma));
+            sum += kernel[i + r];
+        }
+
+        for (auto & k : kernel) {
+            k /= sum;
+        }
+
+        ConvolveSeparable(src, dst, kernel);
+    }
+
+    void ImageProcessor::BoxBlur(const Image & src, Image & dst, int radius)
+    {
+        ValidateSameDimensions(src, dst);
+        if (radius < 0) {
+            throw std::domain_error("Radius of box blur must not be negative, got "
+                + to_string(radius));
+        }
+
+        const int w = src.GetWidth();
+        const int h = src.GetHeight();
+        if (radius == 0) {
+            if (&src != &dst) {
+                std::copy(src.GetPixels(), src.GetPixels() + src.NumberOfPixels(), dst.GetPixels());
+            }
+            return;
+        }
+
+        const size_t n = static_cast<size_t>(w) * 4;
+        const double scale = 1.0 / (2 * radius + 1);
+        scratch.resize(static_cast<size_t>(w) * h);
+
+        // Horizontal pass using a running sum per color component.
+        ProcessRows(h, [&](int y0, int y1) {
+            vector<double> pad;
+            for (int y = y0; y < y1; ++y) {
+                PadRow(src.GetRow(y), w, radius, pad);
+                double* out = &scratch[static_cast<size_t>(y) * w].r;
+                double sum[4] = {0, 0, 0, 0};
+                for (int k = 0; k <= 2 * radius; ++k) {
+                    for (int c = 0; c < 4; ++c) {
+                        sum[c] += pad[k * 4 + c];
+                    }
+                }
+
+                for (int x = 0; x < w; ++x) {
+                    for (int c = 0; c < 4; ++c) {
+                        out[x * 4 + c] = sum[c] * scale;
+                    }
+
+                    if (x + 1 < w) {
+                        for (int c = 0; c < 4; ++c) {
+                            sum[c] += pad[(x + 2 * radius + 1) * 4 + c] - pad[x * 4 + c];
+                        }
+                    }
+                }
+            }
+        });
+
+        // Vertical pass using a running sum of rows.
+        ProcessRows(h, [&](int y0, int y1) {
+            vector<double> sum(n, 0.0);
+            for (int k = y0 - radius; k <= y0 + radius; ++k) {
+                const double* in = &scratch[static_cast<size_t>(Clamp(k, 0, h - 1)) * w].r;
+                for (size_t i = 0; i < n; ++i) {
+                    sum[i] += in[i];
+                }
+            }
+
+            for (int y = y0; y < y1; ++y) {
+                double* out = &dst.GetRow(y)->r;
+                for (size_t i = 0; i < n; ++i) {
+                    out[i] = sum[i] * scale;
+                }
+
+                const double* add = &scratch[static_cast<size_t>(Clamp(y + radius + 1, 0, h - 1)) * w].r;
+                const double* sub = &scratch[static_cast<size_t>(Clamp(y - radius, 0, h - 1)) * w].r;
+                for (size_t i = 0; i < n; ++i) {
+                    sum[i] += add[i] - sub[i];
+                }
+            }
+        });
+    }
+
+    void ImageProcessor::Resize(const Image & src, Image & dst, ResizeFilter filter)
+    {
+        if (&src == &dst) {
+            throw std::domain_error("Source and destination of resize must be different images");
+        }
+
+        const int sw = src.GetWidth();
+        const int sh = src.GetHeight();
+        const int dw = dst.GetWidth();
+        const int dh = dst.GetHeight();
+
+        vector<Contribution> hContribs, vContribs;
+        vector<double> hWeights, vWeights;
+        CalcContributions(filter, sw, dw, hContribs, hWeights);
+        CalcContributions(filter, sh, dh, vContribs, vWeights);
+
+        // Horizontal pass, source rows are resampled to the target width.
+        scratch.resize(static_cast<size_t>(dw) * sh);
+        ProcessRows(sh, [&](int y0, int y1) {
+            for (int y = y0; y < y1; ++y) {
+                const double* in = &src.GetRow(y)->r;
+                double* out = &scratch[static_cast<size_t>(y) * dw].r;
+                for (int x = 0; x < dw; ++x) {
+                    const Contribution & c = hContribs[x];
+                    const double* wts = hWeights.data() + c.offset;
+                    const double* px = in + static_cast<size_t>(c.first) * 4;
+                    double acc[4] = {0, 0, 0, 0};
+                    for (int j = 0; j < c.count; ++j) {
+                        for (int k = 0; k < 4; ++k) {
+                            acc[k] += wts[j] * px[j * 4 + k];
+                        }
+                    }
+                    std::copy(acc, acc + 4, out + x * 4);
+                }
+            }
+        });
+
+        // Vertical pass, weighted sums of entire rows.
+        const size_t n = static_cast<size_t>(dw) * 4;
+        ProcessRows(dh, [&](int y0, int y1) {
+            for (int y = y0; y < y1; ++y) {
+                const Contribution & c = vContribs[y];
+                double* out = &dst.GetRow(y)->r;
+                std::fill(out, out + n, 0.0);
+                for (int j = 0; j < c.count; ++j) {
+                    const double wj = vWeights[c.offset + j];
+                    const double* in = &scratch[static_cast<size_t>(c.first + j) * dw].r;
+                    for (size_t i = 0; i < n; ++i) {
+                        out[i] += wj * in[i];
+                    }
+                }
+            }
+        });
+    }
+
+    void ImageProcessor::AdjustHsv(const Image & src, Image & dst,
+        double hueShift, double saturationFactor, double valueFactor)
+    {
+        ValidateSameDimensions(src, dst);
+        const int w = src.GetWidth();
+
+        ProcessRows(src.GetHeight(), [&](int y0, int y1) {
+            ColorHsv hsv;
+            for (int y = y0; y < y1; ++y) {
+                const Color4d* in = src.GetRow(y);
+                Color4d* out = dst.GetRow(y);
+                for (int x = 0; x < w; ++x) {
+                    const double alpha = in[x].a;
+                    hsv.Set(in[x]);
+
+                    // Black pixels have no hue.
+                    if (hsv.h >= 0) {
+                        hsv.h = std::fmod(hsv.h + hueShift, 360.0);
+                        if (hsv.h < 0) {
+                            hsv.h += 360.0;
+                        }
+                        if (hsv.h >= 360.0) {
+                            hsv.h = 0;
+                        }
+                    }
+                    hsv.s = std::min(1.0, std::max(0.0, hsv.s * saturationFactor));
+                    hsv.v *= valueFactor;
+
+                    out[x] = hsv.ToRgb();
+                    out[x].a = alpha;
+                }
+            }
+        });
+    }
+
+    void ImageProcessor::Composite(const Image & src, Image & dst, int x, int y, double opacity)
+    {
+        if (&src == &dst) {
+            throw std::domain_error("Source and destination of composite must be different images");
+        }
+
+        // Clip the source image against the destination image.
+        const int sx0 = std::max(0, -x);
+        const int sy0 = std::max(0, -y);
+        const int sx1 = std::min(src.GetWidth(), dst.GetWidth() - x);
+        const int sy1 = std::min(src.GetHeight(), dst.GetHeight() - y);
+        if (sx0 >= sx1 || sy0 >= sy1) {
+            return;
+        }
+
+        ProcessRows(sy1 - sy0, [&](int r0, int r1) {
+            for (int row = r0; row < r1; ++row) {
+                const Color4d* in = src.GetRow(sy0 + row) + sx0;
+                Color4d* out = dst.GetRow(sy0 + row + y) + sx0 + x;
+                for (int i = 0; i < sx1 - sx0; ++i) {
+                    const double sa = in[i].a * opacity;
+                    const double da = out[i].a * (1.0 - sa);
+                    const double a = sa + da;
+                    if (a <= 0) {
+                        out[i].Set(0, 0, 0, 0);
+                        continue;
+                    }
+
+                    const double ia = 1.0 / a;
+                    out[i].r = (in[i].r * sa + out[i].r * da) * ia;
+                    out[i].g = (in[i].g * sa + out[i].g * da) * ia;
+                    out[i].b = (in[i].b * sa + out[i].b * da) * ia;
+                    out[i].a = a;
+                }
+            }
+        });
+    }
+
+    void ImageProcessor::ApplyGamma(const Image & src, Image & dst, double gamma)
+    {
+        ValidateSameDimensions(src, dst);
+        if (gamma <= 0) {
+            throw std::domain_error("Gamma must be greater zero, got " + to_string(gamma));
+        }
+
+        const double exponent = 1.0 / gamma;
+        const int w = src.GetWidth();
+        ProcessRows(src.GetHeight(), [&](int y0, int y1) {
+            for (int y = y0; y < y1; ++y) {
+                const Color4d* in = src.GetRow(y);
+                Color4d* out = dst.GetRow(y);
+                for (int x = 0; x < w; ++x) {
+                    out[x].r = std::pow(std::max(0.0, in[x].r), exponent);
+                    out[x].g = std::pow(std::max(0.0, in[x].g), exponent);
+                    out[x].b = std::pow(std::max(0.0, in[x].b), exponent);
+                    out[x].a = in[x].a;
+                }
+            }
+        });
+    }
+
+} // end of namespace
@@ -14,6 +14,7 @@
 // Local includes
 #include "Graphics/ImageRenderer.h"
 #include "Graphics/PatternRenderer.h"
+#include "Graphics/CoverageRasterizer.h"
 #include "Graphics/Quadtree.h"
 #include "Graphics/Pattern.h"
 #include "Graphics/WebColors.h"
@@ -21,14 +22,70 @@
 #include "Math/MathUtils.h"
 
 // C++ Standard Library includes
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <stdexcept>
 #include <string>
+#include <vector>
+
+/** 
+ * The distance in pixels up to which a graphical element can affect
+ * pixels, covers the radius of the anti-aliasing kernels and the 
+ * neighborhood used by adaptive sampling.
+ */
+#define DIRTY_MARGIN 2.0
 
 namespace astu {
 
+    /**
+     * The patterns are stored in contiguous arrays, which are reserved 
+     * before the patterns are added. The quadtree references them by 
+     * non-owning shared pointers, their lifetime is controlled by the
+     * image renderer.
+     */
+    struct ImageRenderer::PatternStorage {
+        std::vector<RectanglePattern> rectangles;
+        std::vector<CirclePattern> circles;
+        std::vector<UnicolorPattern> colors;
+
+        /** The pattern of each element, nullptr if the element has none. */
+        std::vector<Pattern*> byShape;
+
+        /** The index of the pattern of each element within the quadtree. */
+        std::vector<uint32_t> treeIndex;
+
+        void Clear() {
+            rectangles.clear();
+            circles.clear();
+            colors.clear();
+            byShape.clear();
+            treeIndex.clear();
+        }
+    };
+
+    /**
+     * Creates a shared pointer which does not own the pattern.
+     */
+    static std::shared_ptr<Pattern> Unowned(Pattern & pattern)
+    {
+        return std::shared_ptr<Pattern>(std::shared_ptr<Pattern>(), &pattern);
+    }
+
     ImageRenderer::ImageRenderer(unsigned int maxDepth)
-        : root(std::make_unique<UnionPattern>())
+        : renderMethod(RenderMethod::Sampling)
+        , root(std::make_unique<UnionPattern>())
+        , rasterizer(std::make_unique<CoverageRasterizer>())
         , quadtreeDepth(maxDepth)
+        , numThreads(0)
+        , adaptiveSampling(false)
+        , tileSize(TiledPatternRenderer::DEFAULT_TILE_SIZE)
+        , patterns(std::make_unique<PatternStorage>())
+        , patternsValid(false)
+        , rasterizerValid(false)
+        , fullRedraw(true)
+        , renderedWidth(0)
+        , renderedHeight(0)
     {
         SetRenderQuality(RenderQuality::Good);
         SetDrawColor(WebColors::Black);
@@ -41,12 +98,24 @@ namespace astu {
         // Intentionally left empty.
     }
 
+    /**
+     * Creates an anti-aliasing pattern renderer.
+     */
+    static std::unique_ptr<TiledPatternRenderer> CreateAntialiasingRenderer(
+        AntialiasingLevel level, bool adaptive)
+    {
+        auto result = std::make_unique<AntiAlisaingPatternRenderer>(level);
+        result->SetAdaptive(adaptive);
+        return result;
+    }
+
     void ImageRenderer::SetRenderQuality(RenderQuality quality)
     {
         if (this->quality == quality && renderer != nullptr) {
             return;
         }
         this->quality = quality;
+        fullRedraw = true;
 
         switch (quality) {
 
@@ -55,21 +124,65 @@ namespace astu {
             break;
 
         case RenderQuality::Simple:
-            renderer = std::make_unique<AntiAlisaingPatternRenderer>(AntialiasingLevel::Simple);
+            renderer = CreateAntialiasingRenderer(AntialiasingLevel::Simple, adaptiveSampling);
             break;
 
         case RenderQuality::Good:
-            renderer = std::make_unique<AntiAlisaingPatternRenderer>(AntialiasingLevel::Good);
+            renderer = CreateAntialiasingRenderer(AntialiasingLevel::Good, adaptiveSampling);
             break;
 
         case RenderQuality::Beautiful:
-            renderer = std::make_unique<AntiAlisaingPatternRenderer>(AntialiasingLevel::Beautiful);
+            renderer = CreateAntialiasingRenderer(AntialiasingLevel::Beautiful, adaptiveSampling);
             break;
 
         case RenderQuality::Insane:
-            renderer = std::make_unique<AntiAlisaingPatternRenderer>(AntialiasingLevel::Insane);
+            renderer = CreateAntialiasingRenderer(AntialiasingLevel::Insane, adaptiveSampling);
             break;
         }
+
+        renderer->SetNumThreads(numThreads);
+        renderer->SetTileSize(tileSize);
+        renderer->SetProgressCallback(progressCallback);
+    }
+
+    void ImageRenderer::SetNumThreads(size_t n)
+    {
+        numThreads = n;
+        rasterizer->SetNumThreads(n);
+        if (renderer) {
+            renderer->SetNumThreads(n);
+        }
+    }
+
+    void ImageRenderer::SetAdaptiveSampling(bool b)
+    {
+        fullRedraw |= adaptiveSampling != b;
+        adaptiveSampling = b;
+        auto aaRenderer = dynamic_cast<AntiAlisaingPatternRenderer*>(renderer.get());
+        if (aaRenderer) {
+            aaRenderer->SetAdaptive(b);
+        }
+    }
+
+    void ImageRenderer::SetTileSize(int size)
+    {
+        if (size < 1) {
+            throw std::domain_error("Tile size must be greater zero, got " 
+                + std::to_string(size));
+        }
+
+        tileSize = size;
+        if (renderer) {
+            renderer->SetTileSize(size);
+        }
+    }
+
+    void ImageRenderer::SetProgressCallback(std::function<void(double)> callback)
+    {
+        progressCallback = callback;
+        if (renderer) {
+            renderer->SetProgressCallback(callback);
+        }
     }
 
     void ImageRenderer::SetDrawColor(const Color4d & c) noexcept
@@ -85,6 +198,7 @@ namespace astu {
     void ImageRenderer::SetBackgroundColor(const Color4d & c) noexcept
     {
         backgroundColor = c;
+        fullRedraw = true;
         if (background) {
             background->SetColor(c);
         }
@@ -100,41 +214,333 @@ namespace astu {
         root->Clear();
         root->Add(background = std::make_shared<UnicolorPattern>(backgroundColor));
         root->Add(quadtree = std::make_shared<Quadtree>(5, static_cast<int>(quadtreeDepth)));
+        rasterizer->Clear();
+        patterns->Clear();
+
+        lines.clear();
+        circles.clear();
+        rectangles.clear();
+        order.clear();
+        dirtyRegions.clear();
+        patternsValid = rasterizerValid = true;
+        fullRedraw = true;
+    }
+
+    void ImageRenderer::Reserve(size_t numLines, size_t numCircles, size_t numRectangles)
+    {
+        lines.reserve(numLines);
+        circles.reserve(numCircles);
+        rectangles.reserve(numRectangles);
+        order.reserve(numLines + numCircles + numRectangles);
+    }
+
+    // Drawing calls only record the graphical elements, patterns and
+    // rasterizer shapes are created when the image gets rendered.
+
+    size_t ImageRenderer::DrawCircle(double x, double y, double r)
+    {
+        if (r <= 0) {
+            throw std::domain_error("Circle radius must be greater zero, got " + std::to_string(r));
+        }
+
+        circles.push_back({x, y, r, drawColor});
+        return AddShape(ShapeType::Circle, circles.size() - 1);
+    }
+
+    size_t ImageRenderer::DrawLine(double x0, double y0, double x1, double y1, double w)
+    {
+        if (w <= 0) {
+            throw std::domain_error("Line width must be greater zero, got " + std::to_string(w));
+        }
+
+        lines.push_back({x0, y0, x1, y1, w, drawColor});
+        return AddShape(ShapeType::Line, lines.size() - 1);
     }
 
-    void ImageRenderer::DrawCircle(double x, double y, double r)
+    size_t ImageRenderer::DrawRectangle(double cx, double cy, double w, double h, double phi)
     {
-        auto circle = std::make_shared<CirclePattern>(r);
-        circle->Translate(x, y);
-        circle->SetPattern(std::make_shared<UnicolorPattern>(drawColor));
-        quadtree->Add(circle);
+        if (w <= 0 || h <= 0) {
+            throw std::domain_error("Width and height of rectangle must be greater zero, got " 
+                + std::to_string(w) + " x " + std::to_string(h));
+        }
+
+        rectangles.push_back({cx, cy, w, h, phi, drawColor});
+        return AddShape(ShapeType::Rectangle, rectangles.size() - 1);
+    }
+
+    size_t ImageRenderer::AddShape(ShapeType type, size_t index)
+    {
+        order.push_back({type, static_cast<uint32_t>(index), false});
+        MarkDirty(order.back());
+        patternsValid = rasterizerValid = false;
+        return order.size() - 1;
+    }
+
+    ImageRenderer::ShapeRef & ImageRenderer::GetShape(size_t id)
+    {
+        if (id >= order.size() || order[id].removed) {
+            throw std::out_of_range("Invalid shape identifier " + std::to_string(id));
+        }
+        return order[id];
     }
 
-    void ImageRenderer::DrawLine(double x0, double y0, double x1, double y1, double w)
+    void ImageRenderer::MoveShape(size_t id, double dx, double dy)
     {
-        Vector2<double> v(x1 - x0, y1 - y0);
+        const auto & ref = GetShape(id);
 
-        double lng = v.Length();
-        if (lng <= 0) {
+        // The union of the old and the new position must be rendered again.
+        MarkDirty(ref);
+        switch (ref.type) {
+
+        case ShapeType::Line: {
+            auto & line = lines[ref.index];
+            line.x0 += dx;
+            line.y0 += dy;
+            line.x1 += dx;
+            line.y1 += dy;
+            break;
+        }
+
+        case ShapeType::Circle:
+            circles[ref.index].cx += dx;
+            circles[ref.index].cy += dy;
+            break;
+
+        case ShapeType::Rectangle:
+            rectangles[ref.index].cx += dx;
+            rectangles[ref.index].cy += dy;
+            break;
+        }
+        MarkDirty(ref);
+        UpdatePattern(id);
+        rasterizerValid = false;
+    }
+
+    void ImageRenderer::RemoveShape(size_t id)
+    {
+        auto & ref = GetShape(id);
+        MarkDirty(ref);
+        ref.removed = true;
+        UpdatePattern(id);
+        rasterizerValid = false;
+    }
+
+    void ImageRenderer::UpdatePattern(size_t id)
+    {
+        if (!patternsValid) {
             return;
         }
 
-        double a = v.Angle(Vector2<double>(1, 0));
+        // Only the leaves of the quadtree referencing the element get
+        // updated, the tree is rebuilt if the element left its bounds.
+        Pattern* pattern = patterns->byShape[id];
+        if (!pattern) {
+            return;
+        }
 
-        auto rect = std::make_shared<RectanglePattern>(lng, w);
-        rect->Translate((x1 + x0) / 2, (y1 + y0) / 2);
-        rect->Rotate(-a);
-        rect->SetPattern(std::make_shared<UnicolorPattern>(drawColor));
-        quadtree->Add(rect);
+        const auto & ref = order[id];
+        if (ref.removed) {
+            patterns->byShape[id] = nullptr;
+            patternsValid = quadtree->RemoveShape(patterns->treeIndex[id]);
+        } else {
+            PlacePattern(ref, *pattern);
+            patternsValid = quadtree->UpdateShape(patterns->treeIndex[id]);
+        }
     }
 
-    void ImageRenderer::DrawRectangle(double cx, double cy, double w, double h, double phi)
+    void ImageRenderer::MarkDirty(const ShapeRef & ref)
     {
-        auto rect = std::make_shared<RectanglePattern>(w, h);
-        rect->Translate(cx, cy);
-        rect->Rotate(ToRadians(phi));
-        rect->SetPattern(std::make_shared<UnicolorPattern>(drawColor));
-        quadtree->Add(rect);
+        DirtyRegion region;
+        switch (ref.type) {
+
+        case ShapeType::Line: {
+            const auto & line = lines[ref.index];
+            const double hw = line.w / 2;
+            region.minX = std::min(line.x0, line.x1) - hw;
+            region.maxX = std::max(line.x0, line.x1) + hw;
+            region.minY = std::min(line.y0, line.y1) - hw;
+            region.maxY = std::max(line.y0, line.y1) + hw;
+            break;
+        }
+
+        case ShapeType::Circle: {
+            const auto & circle = circles[ref.index];
+            region.minX = circle.cx - circle.r;
+            region.maxX = circle.cx + circle.r;
+            region.minY = circle.cy - circle.r;
+            region.maxY = circle.cy + circle.r;
+            break;
+        }
+
+        case ShapeType::Rectangle: {
+            const auto & rectangle = rectangles[ref.index];
+            const double phi = ToRadians(rectangle.phi);
+            const double c = std::abs(std::cos(phi));
+            const double s = std::abs(std::sin(phi));
+            const double ex = (rectangle.w * c + rectangle.h * s) / 2;
+            const double ey = (rectangle.w * s + rectangle.h * c) / 2;
+            region.minX = rectangle.cx - ex;
+            region.maxX = rectangle.cx + ex;
+            region.minY = rectangle.cy - ey;
+            region.maxY = rectangle.cy + ey;
+            break;
+        }
+        }
+
+        if (!fullRedraw) {
+            dirtyRegions.push_back(region);
+        }
+    }
+
+    void ImageRenderer::BuildPatterns()
+    {
+        // The quadtree must release the patterns before they get destroyed.
+        quadtree->Clear();
+        patterns->Clear();
+
+        // Reserving the exact sizes ensures that the patterns do not move.
+        patterns->rectangles.reserve(lines.size() + rectangles.size());
+        patterns->circles.reserve(circles.size());
+        patterns->colors.reserve(order.size());
+        patterns->byShape.assign(order.size(), nullptr);
+        patterns->treeIndex.assign(order.size(), 0);
+
+        uint32_t numPatterns = 0;
+        for (size_t id = 0; id < order.size(); ++id) {
+            const auto & ref = order[id];
+            if (ref.removed) {
+                continue;
+            }
+
+            Pattern* pattern = nullptr;
+            switch (ref.type) {
+
+            case ShapeType::Line: {
+                const auto & line = lines[ref.index];
+                const double dx = line.x1 - line.x0;
+                const double dy = line.y1 - line.y0;
+                if (dx * dx + dy * dy <= 0) {
+                    break;
+                }
+
+                patterns->colors.emplace_back(line.color);
+                patterns->rectangles.emplace_back();
+                patterns->rectangles.back().SetPattern(Unowned(patterns->colors.back()));
+                pattern = &patterns->rectangles.back();
+                break;
+            }
+
+            case ShapeType::Circle:
+                patterns->colors.emplace_back(circles[ref.index].color);
+                patterns->circles.emplace_back();
+                patterns->circles.back().SetPattern(Unowned(patterns->colors.back()));
+                pattern = &patterns->circles.back();
+                break;
+
+            case ShapeType::Rectangle:
+                patterns->colors.emplace_back(rectangles[ref.index].color);
+                patterns->rectangles.emplace_back();
+                patterns->rectangles.back().SetPattern(Unowned(patterns->colors.back()));
+                pattern = &patterns->rectangles.back();
+                break;
+            }
+
+            if (pattern) {
+                PlacePattern(ref, *pattern);
+                patterns->byShape[id] = pattern;
+                patterns->treeIndex[id] = numPatterns++;
+                quadtree->Add(Unowned(*pattern));
+            }
+        }
+
+        if (!quadtree->IsEmpty()) {
+            quadtree->BuildTree();
+        }
+        patternsValid = true;
+    }
+
+    void ImageRenderer::PlacePattern(const ShapeRef & ref, Pattern & pattern) const
+    {
+        // Patterns accumulate transformations, hence the pattern gets
+        // replaced by a newly placed one.
+        switch (ref.type) {
+
+        case ShapeType::Line: {
+            const auto & line = lines[ref.index];
+            Vector2<double> v(line.x1 - line.x0, line.y1 - line.y0);
+            double a = v.Angle(Vector2<double>(1, 0));
+
+            auto & rect = static_cast<RectanglePattern&>(pattern);
+            auto color = rect.GetPattern();
+            rect = RectanglePattern(v.Length(), line.w);
+            rect.Translate((line.x1 + line.x0) / 2, (line.y1 + line.y0) / 2);
+            rect.Rotate(-a);
+            rect.SetPattern(color);
+            break;
+        }
+
+        case ShapeType::Circle: {
+            const auto & circle = circles[ref.index];
+            auto & circ = static_cast<CirclePattern&>(pattern);
+            auto color = circ.GetPattern();
+            circ = CirclePattern(circle.r);
+            circ.Translate(circle.cx, circle.cy);
+            circ.SetPattern(color);
+            break;
+        }
+
+        case ShapeType::Rectangle: {
+            const auto & rectangle = rectangles[ref.index];
+            auto & rect = static_cast<RectanglePattern&>(pattern);
+            auto color = rect.GetPattern();
+            rect = RectanglePattern(rectangle.w, rectangle.h);
+            rect.Translate(rectangle.cx, rectangle.cy);
+            rect.Rotate(ToRadians(rectangle.phi));
+            rect.SetPattern(color);
+            break;
+        }
+        }
+    }
+
+    void ImageRenderer::BuildRasterizer()
+    {
+        rasterizer->Clear();
+        for (const auto & ref : order) {
+            if (ref.removed) {
+                continue;
+            }
+
+            switch (ref.type) {
+
+            case ShapeType::Line: {
+                const auto & line = lines[ref.index];
+                const double dx = line.x1 - line.x0;
+                const double dy = line.y1 - line.y0;
+                if (dx * dx + dy * dy <= 0) {
+                    break;
+                }
+                const double lng = std::sqrt(dx * dx + dy * dy);
+                rasterizer->AddRectangle((line.x1 + line.x0) / 2, (line.y1 + line.y0) / 2, 
+                    lng, line.w, dx / lng, dy / lng, line.color);
+                break;
+            }
+
+            case ShapeType::Circle: {
+                const auto & circle = circles[ref.index];
+                rasterizer->AddCircle(circle.cx, circle.cy, circle.r, circle.color);
+                break;
+            }
+
+            case ShapeType::Rectangle: {
+                const auto & rectangle = rectangles[ref.index];
+                const double phi = ToRadians(rectangle.phi);
+                rasterizer->AddRectangle(rectangle.cx, rectangle.cy, rectangle.w, rectangle.h, 
+                    std::cos(phi), std::sin(phi), rectangle.color);
+                break;
+            }
+            }
+        }
+        rasterizerValid = true;
     }
 
     void ImageRenderer::SetQuadtreeDepth(unsigned int depth)
@@ -152,10 +558,80 @@ namespace astu {
         assert(renderer);
         assert(quadtree);
 
-        if (!quadtree->IsEmpty()) {
-            quadtree->BuildTree();
+        dirtyRegions.clear();
+        fullRedraw = false;
+        renderedWidth = img.GetWidth();
+        renderedHeight = img.GetHeight();
+
+        if (renderMethod == RenderMethod::Coverage) {
+            if (!rasterizerValid) {
+                BuildRasterizer();
+            }
+            rasterizer->Render(backgroundColor, img);
+            return;
+        }
+
+        if (!patternsValid) {
+            BuildPatterns();
         }
         renderer->Render(*root, img);
     }
 
+    void ImageRenderer::RenderIncremental(Image & img)
+    {
+        const int w = img.GetWidth();
+        const int h = img.GetHeight();
+        if (fullRedraw || w != renderedWidth || h != renderedHeight) {
+            Render(img);
+            return;
+        }
+
+        if (dirtyRegions.empty()) {
+            return;
+        }
+
+        // Collect the tiles touched by the dirty regions.
+        const int nx = (w + tileSize - 1) / tileSize;
+        const int ny = (h + tileSize - 1) / tileSize;
+        std::vector<uint8_t> dirtyTiles(static_cast<size_t>(nx) * ny, 0);
+        for (const auto & region : dirtyRegions) {
+            const double tx0 = std::floor((region.minX - DIRTY_MARGIN) / tileSize);
+            const double tx1 = std::floor((region.maxX + DIRTY_MARGIN) / tileSize);
+            const double ty0 = std::floor((region.minY - DIRTY_MARGIN) / tileSize);
+            const double ty1 = std::floor((region.maxY + DIRTY_MARGIN) / tileSize);
+            if (!(tx1 >= 0 && ty1 >= 0 && tx0 < nx && ty0 < ny)) {
+                continue;
+            }
+
+            const int x0 = static_cast<int>(std::max(0.0, tx0));
+            const int x1 = static_cast<int>(std::min(nx - 1.0, tx1));
+            const int y0 = static_cast<int>(std::max(0.0, ty0));
+            const int y1 = static_cast<int>(std::min(ny - 1.0, ty1));
+            for (int ty = y0; ty <= y1; ++ty) {
+                std::fill_n(&dirtyTiles[static_cast<size_t>(ty) * nx + x0], x1 - x0 + 1, 1);
+            }
+        }
+        dirtyRegions.clear();
+
+        std::vector<size_t> tiles;
+        for (size_t i = 0; i < dirtyTiles.size(); ++i) {
+            if (dirtyTiles[i]) {
+                tiles.push_back(i);
+            }
+        }
+
+        if (renderMethod == RenderMethod::Coverage) {
+            if (!rasterizerValid) {
+                BuildRasterizer();
+            }
+            rasterizer->RenderTiles(backgroundColor, img, tileSize, tiles);
+            return;
+        }
+
+        if (!patternsValid) {
+            BuildPatterns();
+        }
+        renderer->RenderTiles(*root, img, tiles);
+    }
+
 } // end of namespace
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include <cassert>
 #include <stdexcept>
 #include <algorithm>
+#include <string>
 
 namespace astu {
 
@@ -74,6 +75,34 @@ namespace astu {
         return e1->color.Lerp(e2->color, t);
     }
 
+    void Palette::GetColors(const double* t, Color4d* out, size_t n) const
+    {
+        // Consecutive positions often lie within the same section of the
+        // palette (e.g., neighboring pixels), hence the last section is
+        // checked before searching for a new one.
+        const Entry *e1 = nullptr, *e2 = nullptr;
+        for (size_t i = 0; i < n; ++i) {
+            double ti = (t[i] < 0.0) ? 0.0 : (1.0 < t[i]) ? 1.0 : t[i];
+            if (!e1 || ti < e1->pos || ti >= e2->pos) {
+                FindBoundaries(ti, e1, e2);
+            }
+
+            ti -= e1->pos;
+            ti /= e2->pos - e1->pos;
+            out[i] = e1->color.Lerp(e2->color, ti);
+        }
+    }
+
+    BakedPalette Palette::Bake(size_t resolution) const
+    {
+        if (resolution < 2) {
+            throw std::domain_error("Resolution of baked palette must be at least two, got "
+                + std::to_string(resolution));
+        }
+
+        return BakedPalette(*this, resolution);
+    }
+
     size_t Palette::size() const
     {
         return entries.size();
@@ -97,15 +126,15 @@ namespace astu {
         assert(entries[0].pos <= t);
         assert(entries.back().pos >= t);
 
-        const Entry *prev = nullptr;
-        for (const auto & entry : entries) {
-			if (entry.pos > t) {
-                assert(prev != nullptr);  // would violate the precondition
-                e1 = prev;
-                e2 = &entry;
-                return;
-            }
-            prev = &entry;
+        // Entries are sorted, the first entry behind t is found by binary search.
+        auto it = std::upper_bound(entries.begin(), entries.end(), t, 
+            [](double pos, const Entry & entry) { return pos < entry.pos; });
+
+        if (it != entries.end()) {
+            assert(it != entries.begin());  // would violate the precondition
+            e1 = &*(it - 1);
+            e2 = &*it;
+            return;
         }
 
         // Must a must be exactly the first element.
@@ -131,5 +160,52 @@ namespace astu {
         return pos < rhs.pos;
     }
 
+    /////////////////////////////////////////////////
+    /////// BakedPalette
+    /////////////////////////////////////////////////
+
+    BakedPalette::BakedPalette(const Palette & palette, size_t resolution)
+        : colors(resolution)
+        , colors8(resolution)
+        , scale(static_cast<double>(resolution - 1))
+    {
+        std::vector<double> t(resolution);
+        for (size_t i = 0; i < resolution; ++i) {
+            t[i] = i / scale;
+        }
+
+        std::vector<Color4d> samples(resolution);
+        palette.GetColors(t.data(), samples.data(), resolution);
+        ConvertPixels(samples.data(), colors.data(), resolution);
+        ConvertPixels(samples.data(), colors8.data(), resolution);
+    }
+
+    // The batch lookups consist of a clamp, a conversion and a gather, 
+    // without branches on the palette sections.
+
+    void BakedPalette::GetColors(const double* t, Color4d* out, size_t n) const
+    {
+        const Color4f* lut = colors.data();
+        for (size_t i = 0; i < n; ++i) {
+            const Color4f & c = lut[ToIndex(t[i])];
+            out[i].Set(c.r, c.g, c.b, c.a);
+        }
+    }
+
+    void BakedPalette::GetColors(const double* t, Color4f* out, size_t n) const
+    {
+        const Color4f* lut = colors.data();
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = lut[ToIndex(t[i])];
+        }
+    }
+
+    void BakedPalette::GetColors(const double* t, Rgba8* out, size_t n) const
+    {
+        const Rgba8* lut = colors8.data();
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = lut[ToIndex(t[i])];
+        }
+    }
 
 } // end of namespace
@@ -5,6 +5,7 @@
  * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
  */
 
+#include <algorithm>
 #include <stdexcept>
 #include <string>
 #include <cmath>
@@ -44,6 +45,33 @@ namespace astu {
         return GetColorTransformed(transform.TransformPoint(p), c);
     }
 
+    void Pattern::GetColors(
+        const double* xs, const double* ys, Color4d* out, uint8_t* mask, size_t n) const
+    {
+        const double m0 = transform[0], m1 = transform[1];
+        const double m3 = transform[3], m4 = transform[4];
+        const double m6 = transform[6], m7 = transform[7];
+
+        double tx[PACKET_SIZE];
+        double ty[PACKET_SIZE];
+        for (size_t i = 0; i < n; i += PACKET_SIZE) {
+            const size_t k = std::min(PACKET_SIZE, n - i);
+            for (size_t j = 0; j < k; ++j) {
+                tx[j] = m0 * xs[i + j] + m3 * ys[i + j] + m6;
+                ty[j] = m1 * xs[i + j] + m4 * ys[i + j] + m7;
+            }
+            GetColorsTransformed(tx, ty, out + i, mask + i, k);
+        }
+    }
+
+    void Pattern::GetColorsTransformed(
+        const double* xs, const double* ys, Color4d* out, uint8_t* mask, size_t n) const
+    {
+        for (size_t i = 0; i < n; ++i) {
+            mask[i] = GetColorTransformed(Vector2<double>(xs[i], ys[i]), out[i]) ? 1 : 0;
+        }
+    }
+
     BoundingBox Pattern::GetBoundingBox() const
     {
         if (dirty) {
@@ -82,6 +110,27 @@ namespace astu {
         return false;
     }
 
+    void CirclePattern::GetColorsTransformed(
+        const double* xs, const double* ys, Color4d* out, uint8_t* mask, size_t n) const
+    {
+        uint8_t inside[PACKET_SIZE];
+        uint8_t any = 0;
+        for (size_t i = 0; i < n; ++i) {
+            inside[i] = xs[i] * xs[i] + ys[i] * ys[i] <= radiusSquared;
+            any |= inside[i];
+        }
+
+        if (!pattern || !any) {
+            std::fill(mask, mask + n, 0);
+            return;
+        }
+
+        pattern->GetColors(xs, ys, out, mask, n);
+        for (size_t i = 0; i < n; ++i) {
+            mask[i] &= inside[i];
+        }
+    }
+
     BoundingBox CirclePattern::GetLocalBoundingBox() const 
     {
         return BoundingBox(radius * 2, radius * 2);
@@ -130,6 +179,28 @@ namespace astu {
         return false;
     }
 
+    void RectanglePattern::GetColorsTransformed(
+        const double* xs, const double* ys, Color4d* out, uint8_t* mask, size_t n) const
+    {
+        uint8_t inside[PACKET_SIZE];
+        uint8_t any = 0;
+        for (size_t i = 0; i < n; ++i) {
+            inside[i] = (xs[i] <= hRadius) & (xs[i] >= -hRadius) 
+                & (ys[i] <= vRadius) & (ys[i] >= -vRadius);
+            any |= inside[i];
+        }
+
+        if (!pattern || !any) {
+            std::fill(mask, mask + n, 0);
+            return;
+        }
+
+        pattern->GetColors(xs, ys, out, mask, n);
+        for (size_t i = 0; i < n; ++i) {
+            mask[i] &= inside[i];
+        }
+    }
+
     BoundingBox RectanglePattern::GetLocalBoundingBox() const 
     {
         return BoundingBox(width, height);
@@ -158,7 +229,7 @@ namespace astu {
     bool UnionPattern::GetColorTransformed(const Vector2<double> &pt, Color4d & c) const
     {
         bool hasColor = false;
-        for (auto pattern : children) {
+        for (const auto & pattern : children) {
             Color4d localColor;
             if (pattern->GetColor(pt, localColor)) {
                 if (hasColor) {
@@ -173,6 +244,30 @@ namespace astu {
         return hasColor;
     }
 
+    void UnionPattern::GetColorsTransformed(
+        const double* xs, const double* ys, Color4d* out, uint8_t* mask, size_t n) const
+    {
+        Color4d localColors[PACKET_SIZE];
+        uint8_t localMask[PACKET_SIZE];
+
+        std::fill(mask, mask + n, 0);
+        for (const auto & pattern : children) {
+            pattern->GetColors(xs, ys, localColors, localMask, n);
+            for (size_t i = 0; i < n; ++i) {
+                if (!localMask[i]) {
+                    continue;
+                }
+
+                if (mask[i]) {
+                    Blend(out[i], localColors[i]);
+                } else {
+                    mask[i] = 1;
+                    out[i] = localColors[i];
+                }
+            }
+        }
+    }
+
     void UnionPattern::Blend(Color4d & a, const Color4d & b) const
     {
         double iba = 1.0 - b.a;
@@ -14,6 +14,8 @@
 #include "BoundingBox.h"
 
 // C++ Standard Library includes
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -36,10 +38,43 @@ namespace astu {
         BoundingBox GetBoundingBox() const;
         virtual bool GetColor(const Vector2<double> &p, Color4d & c) const;
 
+        /** The maximum number of points processed at once by GetColors(). */
+        static constexpr size_t PACKET_SIZE = 32;
+
+        /**
+         * Evaluates this pattern for several points at once.
+         * 
+         * The points are processed in packets using tight loops over
+         * separate coordinate arrays, which the compiler can vectorize.
+         * 
+         * @param xs    the x-coordinates of the points
+         * @param ys    the y-coordinates of the points
+         * @param out   receives the colors of the points
+         * @param mask  receives 1 for each point with a valid color, else 0
+         * @param n     the number of points
+         */
+        virtual void GetColors(
+            const double* xs, const double* ys, Color4d* out, uint8_t* mask, size_t n) const;
+
     protected:
         virtual bool GetColorTransformed(const Vector2<double> &pt, Color4d & c) const = 0;
         virtual BoundingBox GetLocalBoundingBox() const = 0;
 
+        /**
+         * Evaluates this pattern for a packet of already transformed points.
+         * 
+         * The default implementation calls GetColorTransformed() for each
+         * point.
+         * 
+         * @param xs    the x-coordinates of the points
+         * @param ys    the y-coordinates of the points
+         * @param out   receives the colors of the points
+         * @param mask  receives 1 for each point with a valid color, else 0
+         * @param n     the number of points, at most PACKET_SIZE
+         */
+        virtual void GetColorsTransformed(
+            const double* xs, const double* ys, Color4d* out, uint8_t* mask, size_t n) const;
+
     private:
         mutable bool dirty;
         mutable BoundingBox boundingBox;
@@ -65,6 +100,14 @@ namespace astu {
             return true;
         }
 
+        virtual void GetColors(
+            const double*, const double*, Color4d* out, uint8_t* mask, size_t n) const override 
+        {
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = color;
+                mask[i] = 1;
+            }
+        }
 
     protected:
 
@@ -118,6 +161,8 @@ namespace astu {
     protected:
         virtual bool GetColorTransformed(const Vector2<double> &pt, Color4d & c) const override;
         virtual BoundingBox GetLocalBoundingBox() const override;
+        virtual void GetColorsTransformed(
+            const double* xs, const double* ys, Color4d* out, uint8_t* mask, size_t n) const override;
 
     private:
         double width;
@@ -152,6 +197,8 @@ namespace astu {
     protected:
         virtual bool GetColorTransformed(const Vector2<double> &pt, Color4d & c) const override;
         virtual BoundingBox GetLocalBoundingBox() const override;
+        virtual void GetColorsTransformed(
+            const double* xs, const double* ys, Color4d* out, uint8_t* mask, size_t n) const override;
 
     private:
         double radius;
@@ -202,6 +249,8 @@ namespace astu {
     protected:
         virtual bool GetColorTransformed(const Vector2<double> &pt, Color4d & c) const override;
         virtual BoundingBox GetLocalBoundingBox() const override;
+        virtual void GetColorsTransformed(
+            const double* xs, const double* ys, Color4d* out, uint8_t* mask, size_t n) const override;
 
     private:
         void Blend(Color4d & a, const Color4d & b) const;
@@ -10,45 +10,162 @@
 #include "Graphics/Color.h"
 #include "Graphics/Image.h"
 #include "Graphics/Pattern.h"
+#include "Util/ThreadPool.h"
 
 // C++ Standard Library includes
-#include <iostream>
-#include <iomanip>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <future>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 using namespace std;
 
+/** The maximum size of an antialiasing kernel in one dimension. */
+#define MAX_KERNEL_SIZE 9
+
 namespace astu {
 
-    void SimplePatternRenderer::Render(const Pattern & pattern, Image & result)
+    /////////////////////////////////////////////////
+    /////// TiledPatternRenderer
+    /////////////////////////////////////////////////
+
+    TiledPatternRenderer::TiledPatternRenderer()
+        : tileSize(DEFAULT_TILE_SIZE)
+        , numThreads(0)
+    {
+        // Intentionally left empty.
+    }
+
+    TiledPatternRenderer::~TiledPatternRenderer()
+    {
+        // Intentionally left empty.
+    }
+
+    void TiledPatternRenderer::SetTileSize(int size)
+    {
+        if (size < 1) {
+            throw std::domain_error("Tile size must be greater zero, got " 
+                + std::to_string(size));
+        }
+        tileSize = size;
+    }
+
+    void TiledPatternRenderer::SetNumThreads(size_t n)
+    {
+        if (n != numThreads) {
+            numThreads = n;
+            threadPool = nullptr;
+        }
+    }
+
+    void TiledPatternRenderer::Render(const Pattern & pattern, Image & result)
+    {
+        const int nx = (result.GetWidth() + tileSize - 1) / tileSize;
+        const int ny = (result.GetHeight() + tileSize - 1) / tileSize;
+
+        vector<size_t> tiles(static_cast<size_t>(nx) * ny);
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            tiles[i] = i;
+        }
+        RenderTiles(pattern, result, tiles);
+    }
+
+    void TiledPatternRenderer::RenderTiles(
+        const Pattern & pattern, Image & result, const std::vector<size_t> & tiles)
+    {
+        const int w = result.GetWidth();
+        const int h = result.GetHeight();
+        const int nx = (w + tileSize - 1) / tileSize;
+        const size_t numTiles = tiles.size();
+
+        if (progressCallback) {
+            progressCallback(0.0);
+        }
+
+        if (numThreads == 1) {
+            for (size_t i = 0; i < numTiles; ++i) {
+                const int x0 = static_cast<int>(tiles[i] % nx) * tileSize;
+                const int y0 = static_cast<int>(tiles[i] / nx) * tileSize;
+                RenderTile(pattern, result, x0, y0, 
+                    std::min(x0 + tileSize, w), std::min(y0 + tileSize, h));
+
+                if (progressCallback) {
+                    progressCallback(static_cast<double>(i + 1) / numTiles);
+                }
+            }
+            return;
+        }
+
+        if (!threadPool) {
+            threadPool = std::make_unique<ThreadPool>(numThreads);
+        }
+
+        vector<future<void>> futures;
+        futures.reserve(numTiles);
+        for (size_t i = 0; i < numTiles; ++i) {
+            const int x0 = static_cast<int>(tiles[i] % nx) * tileSize;
+            const int y0 = static_cast<int>(tiles[i] / nx) * tileSize;
+            const int x1 = std::min(x0 + tileSize, w);
+            const int y1 = std::min(y0 + tileSize, h);
+            futures.push_back(threadPool->Submit(
+                [this, &pattern, &result, x0, y0, x1, y1]() {
+                    RenderTile(pattern, result, x0, y0, x1, y1);
+                }));
+        }
+
+        // Tiles are collected in order, which keeps progress reports 
+        // monotonic and on the calling thread.
+        exception_ptr error;
+        for (size_t i = 0; i < numTiles; ++i) {
+            try {
+                futures[i].get();
+            } catch (...) {
+                if (!error) {
+                    error = current_exception();
+                }
+            }
+
+            if (progressCallback && !error) {
+                progressCallback(static_cast<double>(i + 1) / numTiles);
+            }
+        }
+
+        if (error) {
+            rethrow_exception(error);
+        }
+    }
+
+    /////////////////////////////////////////////////
+    /////// SimplePatternRenderer
+    /////////////////////////////////////////////////
+
+    void SimplePatternRenderer::RenderTile(
+        const Pattern & pattern, 
+        Image & result, 
+        int x0, 
+        int y0, 
+        int x1, 
+        int y1) const
     {
-        double dx = 1.0;
-        double startX = dx / 2.0;
-        double dy = 1.0;
-        double startY = dy / 2.0;
-
-        Vector2<double> p(0, startY);
-        Color4d c1 = Color4d(0, 0, 0);
-        Color4d c2 = Color4d(1, 1, 1);
-
-        cout << " 0 %";
-        for (int j = 0; j < result.GetHeight(); ++j) {
-            p.x = startX;
-            for (int i = 0; i < result.GetWidth(); ++i) {
+        const int w = result.GetWidth();
+        Color4d* pixels = result.GetPixels();
+
+        Vector2<double> p;
+        for (int j = y0; j < y1; ++j) {
+            p.y = j + 0.5;
+            Color4d* row = pixels + static_cast<size_t>(j) * w;
+            for (int i = x0; i < x1; ++i) {
+                p.x = i + 0.5;
                 Color4d c;
                 if (pattern.GetColor(p, c)) {
-                    c.Saturate();
-                    result.SetPixel(i, j, c);
+                    row[i] = c.Saturate();
                 }
-                p.x += dx;
             }
-            p.y += dy;
-
-            std::cout << "\b" << "\b" << "\b" << "\b";
-            std::cout << std::setw(2) << static_cast<int>((static_cast<double>(j) / result.GetHeight()) * 100) << " %";
-            std::cout.flush();
         }
-        std::cout << endl;
     }
 
     /////////////////////////////////////////////////
@@ -281,62 +398,171 @@ namespace astu {
         : kKernelRadius(GetKernelRadius(aaLevel))
         , kKernelSize(GetKernelSize(aaLevel))
         , kernel(GetKernel(aaLevel))
+        , kernelSum(0)
+        , adaptive(false)
+        , tolerance(1.0 / 512.0)
     {
-        // Intentionally left empty.
+        // Probes are at least as dense as the kernel samples.
+        probesPerPixel = static_cast<int>(std::ceil(kKernelSize / (2 * kKernelRadius)));
+
+        for (unsigned int i = 0; i < kKernelSize * kKernelSize; ++i) {
+            kernelSum += kernel[i];
+        }
+    }
+
+    void AntiAlisaingPatternRenderer::RenderTile(
+        const Pattern & pattern, 
+        Image & result, 
+        int x0, 
+        int y0, 
+        int x1, 
+        int y1) const
+    {
+        if (adaptive) {
+            RenderTileAdaptive(pattern, result, x0, y0, x1, y1);
+            return;
+        }
+
+        const int w = result.GetWidth();
+        Color4d* pixels = result.GetPixels();
+
+        Vector2<double> p;
+        for (int j = y0; j < y1; ++j) {
+            p.y = j + 0.5;
+            Color4d* row = pixels + static_cast<size_t>(j) * w;
+            for (int i = x0; i < x1; ++i) {
+                p.x = i + 0.5;
+                row[i] = CalcColor(p, pattern);
+            }
+        }
     }
 
-    void AntiAlisaingPatternRenderer::Render(const Pattern & pattern, Image & result)
+    void AntiAlisaingPatternRenderer::RenderTileAdaptive(
+        const Pattern & pattern, 
+        Image & result, 
+        int x0, 
+        int y0, 
+        int x1, 
+        int y1) const
     {
-        double dx = 1.0;
-        double startX = dx / 2.0;
-        double dy = 1.0;
-        double startY = dy / 2.0;
-
-        Vector2<double> p(0, startY);
-        Color4d c1 = Color4d(0, 0, 0);
-        Color4d c2 = Color4d(1, 1, 1);
-
-        cout << " 0 %";
-        for (int j = 0; j < result.GetHeight(); ++j) {
-            p.x = startX;
-            for (int i = 0; i < result.GetWidth(); ++i) {
-                result.SetPixel(i, j, CalcColor(p, pattern));
-                p.x += dx;
+        // Probes are placed on a grid as fine as the kernel, including a 
+        // border which covers the kernel of the pixels along the tile edges.
+        // The probe representing a pixel is the one next to its center, the
+        // kernel area is extended by their distance.
+        const int border = static_cast<int>(std::ceil(kKernelRadius)) + 1;
+        const int center = probesPerPixel / 2;
+        const double offset = 0.5 - static_cast<double>(center) / probesPerPixel;
+        const int reach = static_cast<int>(
+            std::ceil((kKernelRadius + offset) * probesPerPixel));
+        const size_t nx = static_cast<size_t>((x1 - x0 + 2 * border) * probesPerPixel + 1);
+        const size_t ny = static_cast<size_t>((y1 - y0 + 2 * border) * probesPerPixel + 1);
+        const double ox = x0 - border;
+        const double oy = y0 - border;
+
+        std::vector<Color4d> probes(nx * ny);
+        std::vector<double> xs(nx);
+        std::vector<double> ys(nx);
+        std::vector<uint8_t> mask(nx);
+        for (size_t i = 0; i < nx; ++i) {
+            xs[i] = ox + static_cast<double>(i) / probesPerPixel;
+        }
+
+        for (size_t j = 0; j < ny; ++j) {
+            std::fill(ys.begin(), ys.end(), oy + static_cast<double>(j) / probesPerPixel);
+            Color4d* row = &probes[j * nx];
+            pattern.GetColors(xs.data(), ys.data(), row, mask.data(), nx);
+            for (size_t i = 0; i < nx; ++i) {
+                if (!mask[i]) {
+                    row[i].Set(0, 0, 0, 0);
+                }
             }
-            p.y += dy;
+        }
 
-            std::cout << "\b" << "\b" << "\b" << "\b";
-            std::cout << std::setw(2) << static_cast<int>((static_cast<double>(j) / result.GetHeight()) * 100) << " %";
-            std::cout.flush();
+        // Summed-area table of probes which differ from their right or 
+        // lower neighbor, used to test the kernel area of each pixel.
+        const size_t sx = nx + 1;
+        std::vector<uint32_t> table(sx * (ny + 1), 0);
+        for (size_t j = 0; j < ny; ++j) {
+            uint32_t rowSum = 0;
+            for (size_t i = 0; i < nx; ++i) {
+                const Color4d& c = probes[j * nx + i];
+                if ((i + 1 < nx && Differs(c, probes[j * nx + i + 1])) 
+                    || (j + 1 < ny && Differs(c, probes[(j + 1) * nx + i]))) 
+                {
+                    ++rowSum;
+                }
+                table[(j + 1) * sx + i + 1] = table[j * sx + i + 1] + rowSum;
+            }
+        }
+
+        const int w = result.GetWidth();
+        Color4d* pixels = result.GetPixels();
+        Vector2<double> p;
+        for (int j = y0; j < y1; ++j) {
+            p.y = j + 0.5;
+            Color4d* row = pixels + static_cast<size_t>(j) * w;
+            const size_t cy = static_cast<size_t>((j - y0 + border) * probesPerPixel + center);
+            const size_t ja = cy - reach;
+            const size_t jb = cy + reach;
+            for (int i = x0; i < x1; ++i) {
+                const size_t cx = static_cast<size_t>((i - x0 + border) * probesPerPixel + center);
+                const size_t ia = cx - reach;
+                const size_t ib = cx + reach;
+                const uint32_t numEdges = table[(jb + 1) * sx + ib + 1] - table[ja * sx + ib + 1]
+                    - table[(jb + 1) * sx + ia] + table[ja * sx + ia];
+
+                if (numEdges == 0) {
+                    row[i] = probes[cy * nx + cx] * kernelSum;
+                    row[i].Saturate();
+                } else {
+                    p.x = i + 0.5;
+                    row[i] = CalcColor(p, pattern);
+                }
+            }
         }
-        std::cout << endl;
     }
 
-    Color4d AntiAlisaingPatternRenderer::CalcColor(const Vector2<double> & p, const Pattern & pattern)
+    bool AntiAlisaingPatternRenderer::Differs(const Color4d& c1, const Color4d& c2) const
+    {
+        return std::abs(c1.r - c2.r) > tolerance 
+            || std::abs(c1.g - c2.g) > tolerance 
+            || std::abs(c1.b - c2.b) > tolerance 
+            || std::abs(c1.a - c2.a) > tolerance;
+    }
+
+    Color4d AntiAlisaingPatternRenderer::CalcColor(const Vector2<double> & p, const Pattern & pattern) const
     {
         const double dx = (kKernelRadius * 2) / kKernelSize;
         double startX = p.x - kKernelRadius;
         double dy = (kKernelRadius * 2) / kKernelSize;
         double startY = p.y - kKernelRadius;
 
-        const Color4d c1 = Color4d(1, 1, 1);
-        const Color4d c2 = Color4d(0, 0, 0);
+        // Generate all sample points and evaluate them as one batch.
+        assert(kKernelSize <= MAX_KERNEL_SIZE);
+        double xs[MAX_KERNEL_SIZE * MAX_KERNEL_SIZE] = {};
+        double ys[MAX_KERNEL_SIZE * MAX_KERNEL_SIZE] = {};
+        Color4d colors[MAX_KERNEL_SIZE * MAX_KERNEL_SIZE];
+        uint8_t mask[MAX_KERNEL_SIZE * MAX_KERNEL_SIZE];
 
-        Color4d c;
-        Vector2<double> aa(0, startY);
-        const double *k = kernel;
+        size_t n = 0;
+        double y = startY;
         for (unsigned int j = 0; j < kKernelSize; ++j) {
-            aa.x = startX;
+            double x = startX;
             for (unsigned int i = 0; i < kKernelSize; ++i) {
-                aa.x += dx;
-                Color4d localColor;
-                if (pattern.GetColor(aa, localColor)) {
-                    c += localColor * (*k++);
-                } else {
-                    ++k;
-                }
+                x += dx;
+                xs[n] = x;
+                ys[n++] = y;
+            }
+            y += dy;
+        }
+
+        pattern.GetColors(xs, ys, colors, mask, n);
+
+        Color4d c;
+        for (size_t i = 0; i < n; ++i) {
+            if (mask[i]) {
+                c += colors[i] * kernel[i];
             }
-            aa.y += dy;
         }
 
         c.Saturate();
@@ -13,12 +13,16 @@
 #include "Graphics/RenderQuality.h"
 
 // C++ Standard Library includes
+#include <functional>
 #include <map>
+#include <memory>
+#include <vector>
 
 namespace astu {
 
     class Pattern;
     class Image;
+    class ThreadPool;
 
     class IPatternRenderer {
     public:
@@ -31,14 +35,144 @@ namespace astu {
         virtual void Render(const Pattern & pattern, Image & result) = 0;
     };
 
-    class SimplePatternRenderer final : public IPatternRenderer {
+    /**
+     * Base class for pattern renderers which split the image into tiles
+     * and render the tiles concurrently.
+     * 
+     * The color of each pixel is computed independently, hence the 
+     * result does not depend on the tile size or the number of threads.
+     */
+    class TiledPatternRenderer : public IPatternRenderer {
     public:
 
+        /** 
+         * Type alias for progress callbacks. The progress is reported as
+         * value within the range [0, 1] on the thread which called Render().
+         */
+        using ProgressCallback = std::function<void(double)>;
+
+        /** The default size of the tiles in pixels. */
+        static const int DEFAULT_TILE_SIZE = 64;
+
+        /**
+         * Constructor.
+         */
+        TiledPatternRenderer();
+
+        /**
+         * Virtual destructor.
+         */
+        virtual ~TiledPatternRenderer();
+
+        /**
+         * Sets the edge length of the square tiles.
+         * 
+         * @param size  the tile size in pixels
+         * @throws std::domain_error in case the size is less than one
+         */
+        void SetTileSize(int size);
+
+        /**
+         * Returns the edge length of the square tiles.
+         * 
+         * @return the tile size in pixels
+         */
+        int GetTileSize() const {
+            return tileSize;
+        }
+
+        /**
+         * Sets the number of threads used for rendering.
+         * 
+         * @param n the number of threads, zero selects the number of
+         *          hardware threads, one renders on the calling thread
+         */
+        void SetNumThreads(size_t n);
+
+        /**
+         * Returns the number of threads used for rendering.
+         * 
+         * @return the number of threads, zero means hardware threads
+         */
+        size_t GetNumThreads() const {
+            return numThreads;
+        }
+
+        /**
+         * Sets the callback which receives progress updates.
+         * 
+         * @param callback  the progress callback or `nullptr`
+         */
+        void SetProgressCallback(ProgressCallback callback) {
+            progressCallback = callback;
+        }
+
         // Inherited via IPatternRenderer
         virtual void Render(const Pattern & pattern, Image & result) override;
+
+        /**
+         * Renders a subset of the tiles of the image.
+         * 
+         * Tiles are numbered row by row, starting with the upper left 
+         * tile. Pixels outside the specified tiles remain unchanged.
+         * 
+         * @param pattern   the pattern to render
+         * @param result    the image receiving the rendered pixels
+         * @param tiles     the indices of the tiles to render
+         */
+        void RenderTiles(const Pattern & pattern, Image & result, const std::vector<size_t> & tiles);
+
+    protected:
+
+        /**
+         * Renders a rectangular region of the image.
+         * 
+         * This method gets called concurrently for different tiles and 
+         * must not modify the state of this renderer.
+         * 
+         * @param pattern   the pattern to render
+         * @param result    the image receiving the rendered pixels
+         * @param x0        the first column of the tile
+         * @param y0        the first row of the tile
+         * @param x1        the column one past the last column of the tile
+         * @param y1        the row one past the last row of the tile
+         */
+        virtual void RenderTile(
+            const Pattern & pattern, 
+            Image & result, 
+            int x0, 
+            int y0, 
+            int x1, 
+            int y1) const = 0;
+
+    private:
+        /** The edge length of the tiles in pixels. */
+        int tileSize;
+
+        /** The number of threads, zero means hardware threads. */
+        size_t numThreads;
+
+        /** Receives progress updates, might be empty. */
+        ProgressCallback progressCallback;
+
+        /** The thread pool used for rendering, created on demand. */
+        std::unique_ptr<ThreadPool> threadPool;
     };
 
-    class AntiAlisaingPatternRenderer final : public IPatternRenderer {
+    class SimplePatternRenderer final : public TiledPatternRenderer {
+    protected:
+
+        // Inherited via TiledPatternRenderer
+        virtual void RenderTile(
+            const Pattern & pattern, 
+            Image & result, 
+            int x0, 
+            int y0, 
+            int x1, 
+            int y1) const override;
+    };
+
+    class AntiAlisaingPatternRenderer final : public TiledPatternRenderer {
     public:
 
         /** Used to map aa levels to kernels. */
@@ -57,8 +191,49 @@ namespace astu {
          */
         AntiAlisaingPatternRenderer(AntialiasingLevel aaLevel = AntialiasingLevel::Good);
 
-        // Inherited via IPatternRenderer
-        virtual void Render(const Pattern & pattern, Image & result) override;        
+        /**
+         * Enables or disables adaptive supersampling.
+         * 
+         * In adaptive mode, the pattern is first probed on a grid with the
+         * spacing of the kernel samples. The full kernel is only evaluated
+         * for pixels whose kernel area contains probes differing by more
+         * than the tolerance, all other pixels receive the color of their
+         * center probe. Features smaller than the spacing might get lost.
+         * 
+         * @param b set to `true` to enable adaptive supersampling
+         */
+        void SetAdaptive(bool b) {
+            adaptive = b;
+        }
+
+        /**
+         * Returns whether adaptive supersampling is enabled.
+         * 
+         * @return `true` if adaptive supersampling is enabled
+         */
+        bool IsAdaptive() const {
+            return adaptive;
+        }
+
+        /**
+         * Sets the tolerance used to decide whether probes differ.
+         * 
+         * @param tol   the maximum difference of color components
+         */
+        void SetAdaptiveTolerance(double tol) {
+            tolerance = tol;
+        }
+
+    protected:
+
+        // Inherited via TiledPatternRenderer
+        virtual void RenderTile(
+            const Pattern & pattern, 
+            Image & result, 
+            int x0, 
+            int y0, 
+            int x1, 
+            int y1) const override;
 
     private:
 
@@ -83,13 +258,35 @@ namespace astu {
         /** The kernel data. */
         double const * const kernel;
 
+        /** The sum of all kernel weights. */
+        double kernelSum;
+
+        /** Whether adaptive supersampling is enabled. */
+        bool adaptive;
+
+        /** The tolerance used for adaptive supersampling. */
+        double tolerance;
+
+        /** The number of probes per pixel and dimension. */
+        int probesPerPixel;
+
         static const double* GetKernel(AntialiasingLevel level);
         static unsigned int GetKernelSize(AntialiasingLevel level);
         static double GetKernelRadius(AntialiasingLevel level);
 
         // static unsigned int QualityToRadius(AntialiasingLevel level);
 
-        Color4d CalcColor(const Vector2<double> & p, const Pattern & shape);
+        Color4d CalcColor(const Vector2<double> & p, const Pattern & shape) const;
+
+        void RenderTileAdaptive(
+            const Pattern & pattern, 
+            Image & result, 
+            int x0, 
+            int y0, 
+            int x1, 
+            int y1) const;
+
+        bool Differs(const Color4d& c1, const Color4d& c2) const;
     };
 
     class StochasticAntiAlisaingPatternRenderer : public IPatternRenderer {
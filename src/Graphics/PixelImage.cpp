@@ -0,0 +1,206 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+// Local includes
+#include "Graphics/PixelImage.h"
+
+// C++ Standard Library includes
+#include <algorithm>
+#include <cstring>
+
+namespace astu {
+
+    /**
+     * Converts a normalized component to an 8-bit value.
+     */
+    template <typename T>
+    static inline uint8_t ToByte(T v)
+    {
+        return static_cast<uint8_t>(std::min(T(1), std::max(T(0), v)) * T(255) + T(0.5));
+    }
+
+    /**
+     * Converts a single-precision number to half-precision, rounding to
+     * the nearest even value.
+     */
+    static inline uint16_t FloatToHalf(float f)
+    {
+        uint32_t x;
+        std::memcpy(&x, &f, sizeof(x));
+        const uint32_t sign = x & 0x80000000u;
+        x ^= sign;
+
+        uint32_t o;
+        if (x >= 0x47800000u) {
+            // Overflow, infinity or NaN.
+            o = x > 0x7f800000u ? 0x7e00 : 0x7c00;
+        } else if (x < 0x38800000u) {
+            // Zero or denormal, let the FPU do the rounding.
+            const uint32_t magicBits = 126u << 23;
+            float magic;
+            std::memcpy(&magic, &magicBits, sizeof(magic));
+            float fx;
+            std::memcpy(&fx, &x, sizeof(fx));
+            fx += magic;
+            std::memcpy(&o, &fx, sizeof(o));
+            o -= magicBits;
+        } else {
+            const uint32_t mantissaOdd = (x >> 13) & 1;
+            x += (static_cast<uint32_t>(15 - 127) << 23) + 0xfff;
+            x += mantissaOdd;
+            o = x >> 13;
+        }
+
+        return static_cast<uint16_t>(o | (sign >> 16));
+    }
+
+    /**
+     * Converts a half-precision number to single-precision.
+     */
+    static inline float HalfToFloat(uint16_t h)
+    {
+        const uint32_t shiftedExp = 0x7c00u << 13;
+        uint32_t o = (h & 0x7fffu) << 13;
+        const uint32_t exp = shiftedExp & o;
+        o += static_cast<uint32_t>(127 - 15) << 23;
+
+        float f;
+        if (exp == shiftedExp) {
+            // Infinity or NaN.
+            o += static_cast<uint32_t>(128 - 16) << 23;
+            std::memcpy(&f, &o, sizeof(f));
+        } else if (exp == 0) {
+            // Zero or denormal, renormalize.
+            const uint32_t magicBits = 113u << 23;
+            float magic;
+            std::memcpy(&magic, &magicBits, sizeof(magic));
+            o += 1u << 23;
+            std::memcpy(&f, &o, sizeof(f));
+            f -= magic;
+        } else {
+            std::memcpy(&f, &o, sizeof(f));
+        }
+
+        return (h & 0x8000u) ? -f : f;
+    }
+
+    // The conversions treat the pixels as flat arrays of components, 
+    // which allows the compiler to vectorize the loops.
+    static_assert(sizeof(Color4d) == 4 * sizeof(double), "Color4d must consist of four doubles");
+    static_assert(sizeof(Color4f) == 4 * sizeof(float), "Color4f must consist of four floats");
+    static_assert(sizeof(Rgba8) == 4 * sizeof(uint8_t), "Rgba8 must consist of four bytes");
+    static_assert(sizeof(Rgba16f) == 4 * sizeof(uint16_t), "Rgba16f must consist of four halfs");
+
+    void ConvertPixels(const Color4d* src, Rgba8* dst, size_t n)
+    {
+        const double* s = &src->r;
+        uint8_t* d = &dst->r;
+        for (size_t i = 0; i < n * 4; ++i) {
+            d[i] = ToByte(s[i]);
+        }
+    }
+
+    void ConvertPixels(const Rgba8* src, Color4d* dst, size_t n)
+    {
+        const uint8_t* s = &src->r;
+        double* d = &dst->r;
+        for (size_t i = 0; i < n * 4; ++i) {
+            d[i] = s[i] * (1.0 / 255.0);
+        }
+    }
+
+    void ConvertPixels(const Color4d* src, Rgba16f* dst, size_t n)
+    {
+        const double* s = &src->r;
+        uint16_t* d = &dst->r;
+        for (size_t i = 0; i < n * 4; ++i) {
+            d[i] = FloatToHalf(static_cast<float>(s[i]));
+        }
+    }
+
+    void ConvertPixels(const Rgba16f* src, Color4d* dst, size_t n)
+    {
+        const uint16_t* s = &src->r;
+        double* d = &dst->r;
+        for (size_t i = 0; i < n * 4; ++i) {
+            d[i] = HalfToFloat(s[i]);
+        }
+    }
+
+    void ConvertPixels(const Color4d* src, Color4f* dst, size_t n)
+    {
+        const double* s = &src->r;
+        float* d = &dst->r;
+        for (size_t i = 0; i < n * 4; ++i) {
+            d[i] = static_cast<float>(s[i]);
+        }
+    }
+
+    void ConvertPixels(const Color4f* src, Color4d* dst, size_t n)
+    {
+        const float* s = &src->r;
+        double* d = &dst->r;
+        for (size_t i = 0; i < n * 4; ++i) {
+            d[i] = s[i];
+        }
+    }
+
+    void ConvertPixels(const Color4f* src, Rgba8* dst, size_t n)
+    {
+        const float* s = &src->r;
+        uint8_t* d = &dst->r;
+        for (size_t i = 0; i < n * 4; ++i) {
+            d[i] = ToByte(s[i]);
+        }
+    }
+
+    void ConvertPixels(const Rgba8* src, Color4f* dst, size_t n)
+    {
+        const uint8_t* s = &src->r;
+        float* d = &dst->r;
+        for (size_t i = 0; i < n * 4; ++i) {
+            d[i] = s[i] * (1.0f / 255.0f);
+        }
+    }
+
+    void ConvertPixels(const Color4f* src, Rgba16f* dst, size_t n)
+    {
+        const float* s = &src->r;
+        uint16_t* d = &dst->r;
+        for (size_t i = 0; i < n * 4; ++i) {
+            d[i] = FloatToHalf(s[i]);
+        }
+    }
+
+    void ConvertPixels(const Rgba16f* src, Color4f* dst, size_t n)
+    {
+        const uint16_t* s = &src->r;
+        float* d = &dst->r;
+        for (size_t i = 0; i < n * 4; ++i) {
+            d[i] = HalfToFloat(s[i]);
+        }
+    }
+
+    void ConvertPixels(const Rgba8* src, Rgba16f* dst, size_t n)
+    {
+        const uint8_t* s = &src->r;
+        uint16_t* d = &dst->r;
+        for (size_t i = 0; i < n * 4; ++i) {
+            d[i] = FloatToHalf(s[i] * (1.0f / 255.0f));
+        }
+    }
+
+    void ConvertPixels(const Rgba16f* src, Rgba8* dst, size_t n)
+    {
+        const uint16_t* s = &src->r;
+        uint8_t* d = &dst->r;
+        for (size_t i = 0; i < n * 4; ++i) {
+            d[i] = ToByte(HalfToFloat(s[i]));
+        }
+    }
+
+} // end of namespace
@@ -0,0 +1,673 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+// Local includes
+#include "Graphics/PngCodec.h"
+#include "Graphics/Deflate.h"
+#include "Graphics/Image.h"
+#include "Graphics/PixelImage.h"
+
+// C++ Standard Library includes
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+/** The maximum number of bytes stored in one IDAT chunk. */
+#define MAX_IDAT_SIZE (1 << 20)
+
+#define COLOR_TYPE_GRAY         0
+#define COLOR_TYPE_RGB          2
+#define COLOR_TYPE_PALETTE      3
+#define COLOR_TYPE_GRAY_ALPHA   4
+#define COLOR_TYPE_RGBA         6
+
+#define FILTER_NONE     0
+#define FILTER_SUB      1
+#define FILTER_UP       2
+#define FILTER_AVERAGE  3
+#define FILTER_PAETH    4
+
+/** The eight bytes every PNG file starts with. */
+static const unsigned char kPngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+namespace astu {
+
+    /////////////////////////////////////////////////
+    /////// Utility functions
+    /////////////////////////////////////////////////
+
+    static inline void PutUint32(unsigned char* p, uint32_t v)
+    {
+        p[0] = static_cast<unsigned char>(v >> 24);
+        p[1] = static_cast<unsigned char>(v >> 16);
+        p[2] = static_cast<unsigned char>(v >> 8);
+        p[3] = static_cast<unsigned char>(v);
+    }
+
+    static inline uint32_t GetUint32(const unsigned char* p)
+    {
+        return (static_cast<uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+    }
+
+    static inline unsigned char Paeth(int a, int b, int c)
+    {
+        const int p = a + b - c;
+        const int pa = std::abs(p - a);
+        const int pb = std::abs(p - b);
+        const int pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc) {
+            return static_cast<unsigned char>(a);
+        }
+        return static_cast<unsigned char>(pb <= pc ? b : c);
+    }
+
+    /////////////////////////////////////////////////
+    /////// PngEncoder
+    /////////////////////////////////////////////////
+
+    PngEncoder::PngEncoder()
+        : compressionLevel(6)
+    {
+        // Intentionally left empty.
+    }
+
+    int PngEncoder::GetCompressionLevel() const
+    {
+        return compressionLevel;
+    }
+
+    void PngEncoder::SetCompressionLevel(int level)
+    {
+        if (level < 0 || level > 9) {
+            throw std::domain_error("Compression level must be within [0, 9], got "
+                + std::to_string(level));
+        }
+        compressionLevel = level;
+    }
+
+    /**
+     * Writes one chunk including its length and checksum.
+     */
+    static void WriteChunk(std::ostream& os, const char* type, const unsigned char* data, size_t n)
+    {
+        unsigned char header[8];
+        PutUint32(header, static_cast<uint32_t>(n));
+        std::memcpy(header + 4, type, 4);
+
+        uint32_t crc = UpdateCrc32(0, header + 4, 4);
+        crc = UpdateCrc32(crc, data, n);
+        unsigned char trailer[4];
+        PutUint32(trailer, crc);
+
+        os.write(reinterpret_cast<const char*>(header), sizeof(header));
+        os.write(reinterpret_cast<const char*>(data), n);
+        os.write(reinterpret_cast<const char*>(trailer), sizeof(trailer));
+    }
+
+    /**
+     * Applies the specified filter to one row of pixel data.
+     */
+    static void FilterRow(int filter, const unsigned char* row, const unsigned char* prior,
+        size_t n, int bpp, unsigned char* out)
+    {
+        switch (filter) {
+        case FILTER_NONE:
+            std::memcpy(out, row, n);
+            break;
+
+        case FILTER_SUB:
+            std::memcpy(out, row, bpp);
+            for (size_t i = bpp; i < n; ++i) {
+                out[i] = row[i] - row[i - bpp];
+            }
+            break;
+
+        case FILTER_UP:
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = row[i] - prior[i];
+            }
+            break;
+
+        case FILTER_AVERAGE:
+            for (int i = 0; i < bpp; ++i) {
+                out[i] = row[i] - (prior[i] >> 1);
+            }
+            for (size_t i = bpp; i < n; ++i) {
+                out[i] = row[i] - ((row[i - bpp] + prior[i]) >> 1);
+            }
+            break;
+
+        case FILTER_PAETH:
+            for (int i = 0; i < bpp; ++i) {
+                out[i] = row[i] - prior[i];
+            }
+            for (size_t i = bpp; i < n; ++i) {
+                out[i] = row[i] - Paeth(row[i - bpp], prior[i], prior[i - bpp]);
+            }
+            break;
+        }
+    }
+
+    /**
+     * Returns the sum of the absolute values of filtered bytes, interpreted
+     * as signed values. Smaller sums tend to compress better.
+     */
+    static uint32_t FilterCost(const unsigned char* data, size_t n)
+    {
+        uint32_t sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += std::abs(static_cast<int>(static_cast<int8_t>(data[i])));
+        }
+        return sum;
+    }
+
+    void PngEncoder::Encode(const ImageRgba8 & image, std::ostream& os) const
+    {
+        const size_t width = image.GetWidth();
+        const size_t height = image.GetHeight();
+        const size_t numPixels = image.NumberOfPixels();
+
+        // Store the alpha channel only if required.
+        bool opaque = true;
+        const Rgba8* pixels = image.GetPixels();
+        for (size_t i = 0; i < numPixels && opaque; ++i) {
+            opaque = pixels[i].a == 255;
+        }
+        const int bpp = opaque ? 3 : 4;
+        const size_t rowSize = width * bpp;
+
+        // Filter all rows, each row is preceded by its filter type.
+        std::vector<unsigned char> filtered((rowSize + 1) * height);
+        std::vector<unsigned char> rows[2];
+        rows[0].assign(rowSize, 0);
+        rows[1].assign(rowSize, 0);
+        std::vector<unsigned char> candidate(rowSize);
+
+        for (size_t y = 0; y < height; ++y) {
+            unsigned char* row = rows[y & 1].data();
+            const unsigned char* prior = rows[(y + 1) & 1].data();
+            const Rgba8* src = image.GetRow(static_cast<int>(y));
+            if (opaque) {
+                for (size_t x = 0; x < width; ++x) {
+                    row[x * 3] = src[x].r;
+                    row[x * 3 + 1] = src[x].g;
+                    row[x * 3 + 2] = src[x].b;
+                }
+            } else {
+                std::memcpy(row, src, rowSize);
+            }
+
+            unsigned char* out = filtered.data() + y * (rowSize + 1);
+            if (compressionLevel == 0) {
+                out[0] = FILTER_NONE;
+                std::memcpy(out + 1, row, rowSize);
+                continue;
+            }
+
+            uint32_t bestCost = UINT32_MAX;
+            for (int filter = FILTER_NONE; filter <= FILTER_PAETH; ++filter) {
+                FilterRow(filter, row, prior, rowSize, bpp, candidate.data());
+                const uint32_t cost = FilterCost(candidate.data(), rowSize);
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    out[0] = static_cast<unsigned char>(filter);
+                    std::memcpy(out + 1, candidate.data(), rowSize);
+                }
+            }
+        }
+
+        std::vector<unsigned char> compressed;
+        ZlibCompress(filtered.data(), filtered.size(), compressionLevel, compressed);
+
+        unsigned char ihdr[13];
+        PutUint32(ihdr, static_cast<uint32_t>(width));
+        PutUint32(ihdr + 4, static_cast<uint32_t>(height));
+        ihdr[8] = 8;
+        ihdr[9] = opaque ? COLOR_TYPE_RGB : COLOR_TYPE_RGBA;
+        ihdr[10] = 0;
+        ihdr[11] = 0;
+        ihdr[12] = 0;
+
+        os.write(reinterpret_cast<const char*>(kPngSignature), sizeof(kPngSignature));
+        WriteChunk(os, "IHDR", ihdr, sizeof(ihdr));
+        for (size_t pos = 0; pos < compressed.size(); pos += MAX_IDAT_SIZE) {
+            WriteChunk(os, "IDAT", compressed.data() + pos,
+                std::min<size_t>(MAX_IDAT_SIZE, compressed.size() - pos));
+        }
+        WriteChunk(os, "IEND", nullptr, 0);
+    }
+
+    void PngEncoder::Encode(const Image & image, std::ostream& os) const
+    {
+        ImageRgba8 compact(image.GetWidth(), image.GetHeight());
+        ConvertImage(image, compact);
+        Encode(compact, os);
+    }
+
+    /**
+     * Creates a file and encodes an image.
+     */
+    template <typename I>
+    static void EncodeFile(const PngEncoder & encoder, const I & image, const char * filename)
+    {
+        // Create file.
+        std::ofstream ofs(filename, std::ios::out | std::ios::binary);
+        if (!ofs) {
+            throw std::runtime_error(std::string("unable to open PNG file for writing '")
+                + filename + "'");
+        }
+
+        encoder.Encode(image, ofs);
+        ofs.close();
+        if (!ofs) {
+            throw std::runtime_error(std::string("unable to write PNG file '")
+                + filename + "'");
+        }
+    }
+
+    void PngEncoder::Encode(const Image & image, const char * filename) const
+    {
+        EncodeFile(*this, image, filename);
+    }
+
+    void PngEncoder::Encode(const ImageRgba8 & image, const char * filename) const
+    {
+        EncodeFile(*this, image, filename);
+    }
+
+    /////////////////////////////////////////////////
+    /////// PngDecoder
+    /////////////////////////////////////////////////
+
+    /** The properties of a PNG image gathered from its header chunks. */
+    struct PngInfo {
+        uint32_t width;
+        uint32_t height;
+        int bitDepth;
+        int colorType;
+        int channels;
+
+        /** The palette entries, if any. */
+        Rgba8 palette[256];
+
+        /** The number of palette entries. */
+        int paletteSize;
+
+        /** Whether a transparent color key is defined (gray or RGB images). */
+        bool hasKey;
+
+        /** The transparent color key, in units of the bit depth. */
+        uint16_t key[3];
+    };
+
+    /**
+     * Reads exactly the specified number of bytes.
+     */
+    static void ReadBytes(std::istream& is, unsigned char* data, size_t n)
+    {
+        is.read(reinterpret_cast<char*>(data), n);
+        if (!is || static_cast<size_t>(is.gcount()) != n) {
+            throw std::runtime_error("unable to read PNG data, unexpected end of file");
+        }
+    }
+
+    static void ReadHeader(const unsigned char* data, size_t n, PngInfo& info)
+    {
+        if (n != 13) {
+            throw std::runtime_error("invalid PNG header");
+        }
+
+        info.width = GetUint32(data);
+        info.height = GetUint32(data + 4);
+        info.bitDepth = data[8];
+        info.colorType = data[9];
+
+        if (info.width == 0 || info.height == 0 || info.width > INT_MAX || info.height > INT_MAX) {
+            throw std::runtime_error("invalid PNG image dimensions");
+        }
+
+        if (data[10] != 0 || data[11] != 0) {
+            throw std::runtime_error("unsupported PNG compression or filter method");
+        }
+
+        if (data[12] != 0) {
+            throw std::runtime_error("interlaced PNG images are not supported");
+        }
+
+        const int d = info.bitDepth;
+        switch (info.colorType) {
+        case COLOR_TYPE_GRAY:
+            info.channels = 1;
+            if (d != 1 && d != 2 && d != 4 && d != 8 && d != 16) {
+                throw std::runtime_error("invalid PNG bit depth");
+            }
+            break;
+
+        case COLOR_TYPE_PALETTE:
+            info.channels = 1;
+            if (d != 1 && d != 2 && d != 4 && d != 8) {
+                throw std::runtime_error("invalid PNG bit depth");
+            }
+            break;
+
+        case COLOR_TYPE_RGB:
+        case COLOR_TYPE_GRAY_ALPHA:
+        case COLOR_TYPE_RGBA:
+            info.channels = info.colorType == COLOR_TYPE_RGB ? 3 : (info.colorType == COLOR_TYPE_RGBA ? 4 : 2);
+            if (d != 8 && d != 16) {
+                throw std::runtime_error("invalid PNG bit depth");
+            }
+            break;
+
+        default:
+            throw std::runtime_error("invalid PNG color type");
+        }
+    }
+
+    static void ReadPalette(const unsigned char* data, size_t n, PngInfo& info)
+    {
+        if (n % 3 != 0 || n / 3 > 256 || n == 0) {
+            throw std::runtime_error("invalid PNG palette");
+        }
+
+        info.paletteSize = static_cast<int>(n / 3);
+        for (int i = 0; i < info.paletteSize; ++i) {
+            info.palette[i] = {data[i * 3], data[i * 3 + 1], data[i * 3 + 2], 255};
+        }
+    }
+
+    static void ReadTransparency(const unsigned char* data, size_t n, PngInfo& info)
+    {
+        switch (info.colorType) {
+        case COLOR_TYPE_PALETTE:
+            if (n > static_cast<size_t>(info.paletteSize)) {
+                throw std::runtime_error("invalid PNG transparency chunk");
+            }
+            for (size_t i = 0; i < n; ++i) {
+                info.palette[i].a = data[i];
+            }
+            break;
+
+        case COLOR_TYPE_GRAY:
+        case COLOR_TYPE_RGB: {
+            const size_t numKeys = info.colorType == COLOR_TYPE_GRAY ? 1 : 3;
+            if (n != numKeys * 2) {
+                throw std::runtime_error("invalid PNG transparency chunk");
+            }
+            for (size_t i = 0; i < numKeys; ++i) {
+                info.key[i] = static_cast<uint16_t>((data[i * 2] << 8) | data[i * 2 + 1]);
+            }
+            info.hasKey = true;
+            break;
+        }
+
+        default:
+            throw std::runtime_error("PNG transparency chunk not allowed for color type");
+        }
+    }
+
+    /**
+     * Reverses the filter of one row in place.
+     */
+    static void UnfilterRow(int filter, unsigned char* row, const unsigned char* prior, size_t n, int bpp)
+    {
+        switch (filter) {
+        case FILTER_NONE:
+            break;
+
+        case FILTER_SUB:
+            for (size_t i = bpp; i < n; ++i) {
+                row[i] += row[i - bpp];
+            }
+            break;
+
+        case FILTER_UP:
+            for (size_t i = 0; i < n; ++i) {
+                row[i] += prior[i];
+            }
+            break;
+
+        case FILTER_AVERAGE:
+            for (int i = 0; i < bpp; ++i) {
+                row[i] += prior[i] >> 1;
+            }
+            for (size_t i = bpp; i < n; ++i) {
+                row[i] += (row[i - bpp] + prior[i]) >> 1;
+            }
+            break;
+
+        case FILTER_PAETH:
+            for (int i = 0; i < bpp; ++i) {
+                row[i] += prior[i];
+            }
+            for (size_t i = bpp; i < n; ++i) {
+                row[i] += Paeth(row[i - bpp], prior[i], prior[i - bpp]);
+            }
+            break;
+
+        default:
+            throw std::runtime_error("invalid PNG filter type");
+        }
+    }
+
+    /**
+     * Converts one unfiltered row to 8-bit RGBA pixels.
+     */
+    static void ExpandRow(const PngInfo& info, const unsigned char* row, Rgba8* dst)
+    {
+        const size_t width = info.width;
+        const int depth = info.bitDepth;
+
+        if (info.colorType == COLOR_TYPE_PALETTE || (info.colorType == COLOR_TYPE_GRAY && depth < 16)) {
+            const int maxValue = (1 << depth) - 1;
+            const int scale = 255 / maxValue;
+            for (size_t x = 0; x < width; ++x) {
+                int v;
+                if (depth == 8) {
+                    v = row[x];
+                } else {
+                    const size_t bit = x * depth;
+                    v = (row[bit >> 3] >> (8 - depth - (bit & 7))) & maxValue;
+                }
+
+                if (info.colorType == COLOR_TYPE_PALETTE) {
+                    if (v >= info.paletteSize) {
+                        throw std::runtime_error("invalid PNG palette index");
+                    }
+                    dst[x] = info.palette[v];
+                } else {
+                    const uint8_t g = static_cast<uint8_t>(v * scale);
+                    const uint8_t a = info.hasKey && v == info.key[0] ? 0 : 255;
+                    dst[x] = {g, g, g, a};
+                }
+            }
+            return;
+        }
+
+        // Remaining formats use 8 or 16 bits per sample, only the most
+        // significant byte is kept.
+        const int bytesPerSample = depth / 8;
+        const int step = info.channels * bytesPerSample;
+        for (size_t x = 0; x < width; ++x) {
+            const unsigned char* p = row + x * step;
+            uint16_t s[4];
+            for (int c = 0; c < info.channels; ++c) {
+                s[c] = bytesPerSample == 2 ? static_cast<uint16_t>((p[c * 2] << 8) | p[c * 2 + 1]) : p[c];
+            }
+            const int shift = bytesPerSample == 2 ? 8 : 0;
+
+            switch (info.colorType) {
+            case COLOR_TYPE_GRAY: {
+                const uint8_t g = static_cast<uint8_t>(s[0] >> shift);
+                dst[x] = {g, g, g, static_cast<uint8_t>(info.hasKey && s[0] == info.key[0] ? 0 : 255)};
+                break;
+            }
+
+            case COLOR_TYPE_GRAY_ALPHA: {
+                const uint8_t g = static_cast<uint8_t>(s[0] >> shift);
+                dst[x] = {g, g, g, static_cast<uint8_t>(s[1] >> shift)};
+                break;
+            }
+
+            case COLOR_TYPE_RGB: {
+                const bool transparent = info.hasKey
+                    && s[0] == info.key[0] && s[1] == info.key[1] && s[2] == info.key[2];
+                dst[x] = {static_cast<uint8_t>(s[0] >> shift), static_cast<uint8_t>(s[1] >> shift),
+                    static_cast<uint8_t>(s[2] >> shift), static_cast<uint8_t>(transparent ? 0 : 255)};
+                break;
+            }
+
+            case COLOR_TYPE_RGBA:
+                dst[x] = {static_cast<uint8_t>(s[0] >> shift), static_cast<uint8_t>(s[1] >> shift),
+                    static_cast<uint8_t>(s[2] >> shift), static_cast<uint8_t>(s[3] >> shift)};
+                break;
+            }
+        }
+    }
+
+    static std::unique_ptr<ImageRgba8> ReadPng(std::istream& is)
+    {
+        unsigned char signature[8];
+        ReadBytes(is, signature, sizeof(signature));
+        if (std::memcmp(signature, kPngSignature, sizeof(signature)) != 0) {
+            throw std::runtime_error("invalid PNG signature");
+        }
+
+        PngInfo info = {};
+        bool hasHeader = false;
+        std::vector<unsigned char> idat;
+        std::vector<unsigned char> chunk;
+
+        while (true) {
+            unsigned char header[8];
+            ReadBytes(is, header, sizeof(header));
+            const uint32_t length = GetUint32(header);
+            if (length > INT_MAX) {
+                throw std::runtime_error("invalid PNG chunk length");
+            }
+
+            chunk.resize(length);
+            if (length > 0) {
+                ReadBytes(is, chunk.data(), length);
+            }
+
+            unsigned char trailer[4];
+            ReadBytes(is, trailer, sizeof(trailer));
+            uint32_t crc = UpdateCrc32(0, header + 4, 4);
+            crc = UpdateCrc32(crc, chunk.data(), length);
+            if (crc != GetUint32(trailer)) {
+                throw std::runtime_error("invalid PNG chunk checksum");
+            }
+
+            const std::string type(reinterpret_cast<const char*>(header + 4), 4);
+            if (!hasHeader && type != "IHDR") {
+                throw std::runtime_error("invalid PNG file, missing header chunk");
+            }
+
+            if (type == "IHDR") {
+                ReadHeader(chunk.data(), length, info);
+                hasHeader = true;
+            } else if (type == "PLTE") {
+                ReadPalette(chunk.data(), length, info);
+            } else if (type == "tRNS") {
+                ReadTransparency(chunk.data(), length, info);
+            } else if (type == "IDAT") {
+                idat.insert(idat.end(), chunk.begin(), chunk.end());
+            } else if (type == "IEND") {
+                break;
+            } else if (!(header[4] & 0x20)) {
+                throw std::runtime_error("unsupported critical PNG chunk '" + type + "'");
+            }
+        }
+
+        if (info.colorType == COLOR_TYPE_PALETTE && info.paletteSize == 0) {
+            throw std::runtime_error("invalid PNG file, missing palette");
+        }
+
+        const size_t width = info.width;
+        const size_t height = info.height;
+        const int bitsPerPixel = info.channels * info.bitDepth;
+        const int bpp = std::max(1, bitsPerPixel / 8);
+        const size_t rowSize = (width * bitsPerPixel + 7) / 8;
+
+        std::vector<unsigned char> data;
+        ZlibDecompress(idat.data(), idat.size(), data);
+        if (data.size() < (rowSize + 1) * height) {
+            throw std::runtime_error("invalid PNG file, insufficient pixel data");
+        }
+
+        auto result = std::make_unique<ImageRgba8>(static_cast<int>(width), static_cast<int>(height));
+        std::vector<unsigned char> zeros(rowSize, 0);
+        const unsigned char* prior = zeros.data();
+        for (size_t y = 0; y < height; ++y) {
+            unsigned char* row = data.data() + y * (rowSize + 1);
+            UnfilterRow(row[0], row + 1, prior, rowSize, bpp);
+            ExpandRow(info, row + 1, result->GetRow(static_cast<int>(y)));
+            prior = row + 1;
+        }
+
+        return result;
+    }
+
+    PngDecoder::PngDecoder()
+    {
+        // Intentionally left empty.
+    }
+
+    std::unique_ptr<ImageRgba8> PngDecoder::DecodeRgba8(std::istream& is) const
+    {
+        return ReadPng(is);
+    }
+
+    std::unique_ptr<Image> PngDecoder::Decode(std::istream& is) const
+    {
+        auto compact = ReadPng(is);
+        auto result = std::make_unique<Image>(compact->GetWidth(), compact->GetHeight());
+        ConvertImage(*compact, *result);
+        return result;
+    }
+
+    /**
+     * Opens a file for reading and decodes an image.
+     */
+    template <typename I>
+    static std::unique_ptr<I> DecodeFile(const PngDecoder & decoder, const char * filename)
+    {
+        // Open file.
+        std::ifstream ifs(filename, std::ios::in | std::ios::binary);
+        if (!ifs) {
+            throw std::runtime_error(std::string("unable to open PNG file '")
+                + filename + "' for reading");
+        }
+
+        std::unique_ptr<I> result;
+        if constexpr (std::is_same<I, Image>::value) {
+            result = decoder.Decode(ifs);
+        } else {
+            result = decoder.DecodeRgba8(ifs);
+        }
+        ifs.close();
+        return result;
+    }
+
+    std::unique_ptr<Image> PngDecoder::Decode(const char *filename) const
+    {
+        return DecodeFile<Image>(*this, filename);
+    }
+
+    std::unique_ptr<ImageRgba8> PngDecoder::DecodeRgba8(const char *filename) const
+    {
+        return DecodeFile<ImageRgba8>(*this, filename);
+    }
+
+}
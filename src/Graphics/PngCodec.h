@@ -0,0 +1,163 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+#pragma once
+
+#include <memory>
+#include <iostream>
+
+// Local includes
+#include "Graphics/PixelImage.h"
+
+namespace astu {
+
+    // Forward declaration.
+    class Image;
+
+    /**
+     * Converts images into PNG files.
+     *
+     * Images are stored with 8 bits per component. The alpha channel is
+     * only stored if at least one pixel is not fully opaque. The filter
+     * of each row is chosen heuristically and the filtered data is
+     * compressed using the in-tree deflate implementation. Encoders do
+     * not keep any state while encoding and can be used by several
+     * threads concurrently.
+     */
+    class PngEncoder {
+    public:
+
+        /**
+         * Constructor.
+         */
+        PngEncoder();
+
+        /**
+         * Encodes the specified image to the given output stream.
+         *
+         * This method will not close the given output stream.
+         *
+         * @param image the image to be encoded
+         * @param os    the output stream
+         */
+        void Encode(const Image & image, std::ostream& os) const;
+
+        /**
+         * Convenient method to write an image directly into a file.
+         *
+         * @param image     the image to be encoded
+         * @param filename  the filename including the file path
+         * @throws std::runtime_error in case of an I/O error
+         */
+        void Encode(const Image & image, const char * filename) const;
+
+        /**
+         * Encodes the specified 8-bit image to the given output stream.
+         *
+         * This method will not close the given output stream.
+         *
+         * @param image the image to be encoded
+         * @param os    the output stream
+         */
+        void Encode(const ImageRgba8 & image, std::ostream& os) const;
+
+        /**
+         * Convenient method to write an 8-bit image directly into a file.
+         *
+         * @param image     the image to be encoded
+         * @param filename  the filename including the file path
+         * @throws std::runtime_error in case of an I/O error
+         */
+        void Encode(const ImageRgba8 & image, const char * filename) const;
+
+        /**
+         * Returns the compression level.
+         *
+         * @return the compression level within the range [0, 9]
+         */
+        int GetCompressionLevel() const;
+
+        /**
+         * Sets the compression level.
+         *
+         * Level zero stores the pixel data uncompressed and skips row
+         * filtering, level nine yields the smallest files. The default
+         * compression level is six.
+         *
+         * @param level the compression level within the range [0, 9]
+         * @throws std::domain_error in case the level is invalid
+         */
+        void SetCompressionLevel(int level);
+
+    private:
+        /** The compression level used for the pixel data. */
+        int compressionLevel;
+    };
+
+    /**
+     * Decodes PNG files to images.
+     *
+     * Supports all color types with bit depths up to 8 bits per component,
+     * 16-bit components are reduced to 8 bits. Transparency information
+     * (tRNS chunks) is taken into account. Interlaced images are not
+     * supported. Decoders do not keep any state while decoding and can be
+     * used by several threads concurrently.
+     */
+    class PngDecoder {
+    public:
+
+        /**
+         * Constructor.
+         */
+        PngDecoder();
+
+        /**
+         * Decodes a PNG file from an input stream.
+         *
+         * This method will not close the given input stream.
+         *
+         * @param is    the input stream
+         * @return the newly created image containing the PNG data
+         * @throws std::runtime_error in case of i/o problem or if the
+         *      input stream does not contain a valid PNG file
+         */
+        std::unique_ptr<Image> Decode(std::istream& is) const;
+
+        /**
+         * Convenient method to read an image directly from a file.
+         *
+         * @param filename  the filename including the file path
+         * @return the newly created image containing the PNG data
+         * @throws std::runtime_error in case of i/o problem or if the
+         *      input file does not contain a valid PNG file
+         */
+        std::unique_ptr<Image> Decode(const char * filename) const;
+
+        /**
+         * Decodes a PNG file from an input stream into an 8-bit image.
+         *
+         * This method will not close the given input stream.
+         *
+         * @param is    the input stream
+         * @return the newly created image containing the PNG data
+         * @throws std::runtime_error in case of i/o problem or if the
+         *      input stream does not contain a valid PNG file
+         */
+        std::unique_ptr<ImageRgba8> DecodeRgba8(std::istream& is) const;
+
+        /**
+         * Convenient method to read an 8-bit image directly from a file.
+         *
+         * @param filename  the filename including the file path
+         * @return the newly created image containing the PNG data
+         * @throws std::runtime_error in case of i/o problem or if the
+         *      input file does not contain a valid PNG file
+         */
+        std::unique_ptr<ImageRgba8> DecodeRgba8(const char * filename) const;
+    };
+
+}
@@ -0,0 +1,340 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+// Local includes
+#include "Graphics/QoiCodec.h"
+#include "Graphics/Image.h"
+#include "Graphics/PixelImage.h"
+
+// C++ Standard Library includes
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#define QOI_OP_INDEX    0x00
+#define QOI_OP_DIFF     0x40
+#define QOI_OP_LUMA     0x80
+#define QOI_OP_RUN      0xc0
+#define QOI_OP_RGB      0xfe
+#define QOI_OP_RGBA     0xff
+#define QOI_MASK_2      0xc0
+
+#define QOI_HEADER_SIZE 14
+#define QOI_MAX_RUN     62
+
+/** The maximum number of pixels of QOI images according to the specification. */
+#define QOI_PIXELS_MAX  400000000u
+
+/** The eight bytes which terminate every QOI file. */
+static const unsigned char kQoiPadding[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+
+namespace astu {
+
+    static inline int QoiHash(const Rgba8& p)
+    {
+        return (p.r * 3 + p.g * 5 + p.b * 7 + p.a * 11) & 63;
+    }
+
+    static inline bool operator==(const Rgba8& a, const Rgba8& b)
+    {
+        return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    }
+
+    /////////////////////////////////////////////////
+    /////// QoiEncoder
+    /////////////////////////////////////////////////
+
+    QoiEncoder::QoiEncoder()
+    {
+        // Intentionally left empty.
+    }
+
+    void QoiEncoder::Encode(const ImageRgba8 & image, std::ostream& os) const
+    {
+        const size_t numPixels = image.NumberOfPixels();
+        const Rgba8* pixels = image.GetPixels();
+
+        bool opaque = true;
+        for (size_t i = 0; i < numPixels && opaque; ++i) {
+            opaque = pixels[i].a == 255;
+        }
+
+        // Worst case is one RGBA operation of five bytes per pixel.
+        std::vector<unsigned char> buf(QOI_HEADER_SIZE + numPixels * 5 + sizeof(kQoiPadding));
+        unsigned char* out = buf.data();
+
+        const uint32_t w = image.GetWidth();
+        const uint32_t h = image.GetHeight();
+        *out++ = 'q';
+        *out++ = 'o';
+        *out++ = 'i';
+        *out++ = 'f';
+        for (uint32_t v : {w, h}) {
+            *out++ = static_cast<unsigned char>(v >> 24);
+            *out++ = static_cast<unsigned char>(v >> 16);
+            *out++ = static_cast<unsigned char>(v >> 8);
+            *out++ = static_cast<unsigned char>(v);
+        }
+        *out++ = opaque ? 3 : 4;
+        *out++ = 0;
+
+        Rgba8 index[64] = {};
+        Rgba8 prev = {0, 0, 0, 255};
+        int run = 0;
+
+        for (size_t i = 0; i < numPixels; ++i) {
+            const Rgba8 px = pixels[i];
+            if (px == prev) {
+                if (++run == QOI_MAX_RUN || i + 1 == numPixels) {
+                    *out++ = static_cast<unsigned char>(QOI_OP_RUN | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run > 0) {
+                *out++ = static_cast<unsigned char>(QOI_OP_RUN | (run - 1));
+                run = 0;
+            }
+
+            const int hash = QoiHash(px);
+            if (index[hash] == px) {
+                *out++ = static_cast<unsigned char>(QOI_OP_INDEX | hash);
+            } else {
+                index[hash] = px;
+
+                if (px.a == prev.a) {
+                    const int8_t vr = static_cast<int8_t>(px.r - prev.r);
+                    const int8_t vg = static_cast<int8_t>(px.g - prev.g);
+                    const int8_t vb = static_cast<int8_t>(px.b - prev.b);
+                    const int8_t vgr = static_cast<int8_t>(vr - vg);
+                    const int8_t vgb = static_cast<int8_t>(vb - vg);
+
+                    if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                        *out++ = static_cast<unsigned char>(QOI_OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2));
+                    } else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8) {
+                        *out++ = static_cast<unsigned char>(QOI_OP_LUMA | (vg + 32));
+                        *out++ = static_cast<unsigned char>((vgr + 8) << 4 | (vgb + 8));
+                    } else {
+                        *out++ = QOI_OP_RGB;
+                        *out++ = px.r;
+                        *out++ = px.g;
+                        *out++ = px.b;
+                    }
+                } else {
+                    *out++ = QOI_OP_RGBA;
+                    *out++ = px.r;
+                    *out++ = px.g;
+                    *out++ = px.b;
+                    *out++ = px.a;
+                }
+            }
+            prev = px;
+        }
+
+        std::memcpy(out, kQoiPadding, sizeof(kQoiPadding));
+        out += sizeof(kQoiPadding);
+
+        os.write(reinterpret_cast<const char*>(buf.data()), out - buf.data());
+    }
+
+    void QoiEncoder::Encode(const Image & image, std::ostream& os) const
+    {
+        ImageRgba8 compact(image.GetWidth(), image.GetHeight());
+        ConvertImage(image, compact);
+        Encode(compact, os);
+    }
+
+    /**
+     * Creates a file and encodes an image.
+     */
+    template <typename I>
+    static void EncodeFile(const QoiEncoder & encoder, const I & image, const char * filename)
+    {
+        // Create file.
+        std::ofstream ofs(filename, std::ios::out | std::ios::binary);
+        if (!ofs) {
+            throw std::runtime_error(std::string("unable to open QOI file for writing '")
+                + filename + "'");
+        }
+
+        encoder.Encode(image, ofs);
+        ofs.close();
+        if (!ofs) {
+            throw std::runtime_error(std::string("unable to write QOI file '")
+                + filename + "'");
+        }
+    }
+
+    void QoiEncoder::Encode(const Image & image, const char * filename) const
+    {
+        EncodeFile(*this, image, filename);
+    }
+
+    void QoiEncoder::Encode(const ImageRgba8 & image, const char * filename) const
+    {
+        EncodeFile(*this, image, filename);
+    }
+
+    /////////////////////////////////////////////////
+    /////// QoiDecoder
+    /////////////////////////////////////////////////
+
+    static std::unique_ptr<ImageRgba8> ReadQoi(std::istream& is)
+    {
+        unsigned char header[QOI_HEADER_SIZE];
+        is.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (!is || std::memcmp(header, "qoif", 4) != 0) {
+            throw std::runtime_error("invalid QOI file header");
+        }
+
+        const uint32_t w = (static_cast<uint32_t>(header[4]) << 24) | (header[5] << 16) | (header[6] << 8) | header[7];
+        const uint32_t h = (static_cast<uint32_t>(header[8]) << 24) | (header[9] << 16) | (header[10] << 8) | header[11];
+        if (w == 0 || h == 0 || w > INT_MAX || h > INT_MAX || (header[12] != 3 && header[12] != 4)) {
+            throw std::runtime_error("invalid QOI file header");
+        }
+
+        const uint64_t numPixels = static_cast<uint64_t>(w) * h;
+        if (numPixels > QOI_PIXELS_MAX) {
+            throw std::runtime_error("invalid QOI file header, image exceeds "
+                + std::to_string(QOI_PIXELS_MAX) + " pixels");
+        }
+
+        // The buffer is padded, operations which exceed the end of the
+        // data read zeros and are detected by the next iteration.
+        std::vector<unsigned char> data(
+            (std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+        const size_t size = data.size();
+        data.resize(size + 5, 0);
+        const unsigned char* in = data.data();
+        const unsigned char* end = in + size;
+
+        // Each byte encodes at most one run of pixels, which rejects
+        // truncated files before the image gets allocated.
+        if (numPixels > static_cast<uint64_t>(QOI_MAX_RUN) * size) {
+            throw std::runtime_error("unable to read QOI data, unexpected end of file");
+        }
+
+        auto result = std::make_unique<ImageRgba8>(static_cast<int>(w), static_cast<int>(h));
+        Rgba8* pixels = result->GetPixels();
+
+        Rgba8 index[64] = {};
+        Rgba8 px = {0, 0, 0, 255};
+        size_t i = 0;
+
+        while (i < numPixels) {
+            if (in >= end) {
+                throw std::runtime_error("unable to read QOI data, unexpected end of file");
+            }
+
+            const unsigned char b1 = *in++;
+            if (b1 == QOI_OP_RGB) {
+                px.r = in[0];
+                px.g = in[1];
+                px.b = in[2];
+                in += 3;
+            } else if (b1 == QOI_OP_RGBA) {
+                px.r = in[0];
+                px.g = in[1];
+                px.b = in[2];
+                px.a = in[3];
+                in += 4;
+            } else {
+                switch (b1 & QOI_MASK_2) {
+                case QOI_OP_INDEX:
+                    px = index[b1];
+                    break;
+
+                case QOI_OP_DIFF:
+                    px.r += ((b1 >> 4) & 0x03) - 2;
+                    px.g += ((b1 >> 2) & 0x03) - 2;
+                    px.b += (b1 & 0x03) - 2;
+                    break;
+
+                case QOI_OP_LUMA: {
+                    const unsigned char b2 = *in++;
+                    const int vg = (b1 & 0x3f) - 32;
+                    px.r += vg - 8 + ((b2 >> 4) & 0x0f);
+                    px.g += vg;
+                    px.b += vg - 8 + (b2 & 0x0f);
+                    break;
+                }
+
+                case QOI_OP_RUN: {
+                    const size_t run = std::min<size_t>((b1 & 0x3f) + 1, numPixels - i);
+                    std::fill(pixels + i, pixels + i + run, px);
+                    i += run;
+                    continue;
+                }
+                }
+            }
+
+            index[QoiHash(px)] = px;
+            pixels[i++] = px;
+        }
+
+        return result;
+    }
+
+    QoiDecoder::QoiDecoder()
+    {
+        // Intentionally left empty.
+    }
+
+    std::unique_ptr<ImageRgba8> QoiDecoder::DecodeRgba8(std::istream& is) const
+    {
+        return ReadQoi(is);
+    }
+
+    std::unique_ptr<Image> QoiDecoder::Decode(std::istream& is) const
+    {
+        auto compact = ReadQoi(is);
+        auto result = std::make_unique<Image>(compact->GetWidth(), compact->GetHeight());
+        ConvertImage(*compact, *result);
+        return result;
+    }
+
+    /**
+     * Opens a file for reading and decodes an image.
+     */
+    template <typename I>
+    static std::unique_ptr<I> DecodeFile(const QoiDecoder & decoder, const char * filename)
+    {
+        // Open file.
+        std::ifstream ifs(filename, std::ios::in | std::ios::binary);
+        if (!ifs) {
+            throw std::runtime_error(std::string("unable to open QOI file '")
+                + filename + "' for reading");
+        }
+
+        std::unique_ptr<I> result;
+        if constexpr (std::is_same<I, Image>::value) {
+            result = decoder.Decode(ifs);
+        } else {
+            result = decoder.DecodeRgba8(ifs);
+        }
+        ifs.close();
+        return result;
+    }
+
+    std::unique_ptr<Image> QoiDecoder::Decode(const char *filename) const
+    {
+        return DecodeFile<Image>(*this, filename);
+    }
+
+    std::unique_ptr<ImageRgba8> QoiDecoder::DecodeRgba8(const char *filename) const
+    {
+        return DecodeFile<ImageRgba8>(*this, filename);
+    }
+
+}
@@ -0,0 +1,135 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+#pragma once
+
+#include <memory>
+#include <iostream>
+
+// Local includes
+#include "Graphics/PixelImage.h"
+
+namespace astu {
+
+    // Forward declaration.
+    class Image;
+
+    /**
+     * Converts images into QOI files ("Quite OK Image Format").
+     *
+     * QOI is a lossless format which encodes and decodes considerably
+     * faster than PNG at a moderately lower compression ratio. Images are
+     * stored with 8 bits per component. Encoders do not keep any state
+     * while encoding and can be used by several threads concurrently.
+     */
+    class QoiEncoder {
+    public:
+
+        /**
+         * Constructor.
+         */
+        QoiEncoder();
+
+        /**
+         * Encodes the specified image to the given output stream.
+         *
+         * This method will not close the given output stream.
+         *
+         * @param image the image to be encoded
+         * @param os    the output stream
+         */
+        void Encode(const Image & image, std::ostream& os) const;
+
+        /**
+         * Convenient method to write an image directly into a file.
+         *
+         * @param image     the image to be encoded
+         * @param filename  the filename including the file path
+         * @throws std::runtime_error in case of an I/O error
+         */
+        void Encode(const Image & image, const char * filename) const;
+
+        /**
+         * Encodes the specified 8-bit image to the given output stream.
+         *
+         * This method will not close the given output stream.
+         *
+         * @param image the image to be encoded
+         * @param os    the output stream
+         */
+        void Encode(const ImageRgba8 & image, std::ostream& os) const;
+
+        /**
+         * Convenient method to write an 8-bit image directly into a file.
+         *
+         * @param image     the image to be encoded
+         * @param filename  the filename including the file path
+         * @throws std::runtime_error in case of an I/O error
+         */
+        void Encode(const ImageRgba8 & image, const char * filename) const;
+    };
+
+    /**
+     * Decodes QOI files to images.
+     *
+     * Decoders do not keep any state while decoding and can be used by
+     * several threads concurrently.
+     */
+    class QoiDecoder {
+    public:
+
+        /**
+         * Constructor.
+         */
+        QoiDecoder();
+
+        /**
+         * Decodes a QOI file from an input stream.
+         *
+         * This method will not close the given input stream.
+         *
+         * @param is    the input stream
+         * @return the newly created image containing the QOI data
+         * @throws std::runtime_error in case of i/o problem or if the
+         *      input stream does not contain a valid QOI file
+         */
+        std::unique_ptr<Image> Decode(std::istream& is) const;
+
+        /**
+         * Convenient method to read an image directly from a file.
+         *
+         * @param filename  the filename including the file path
+         * @return the newly created image containing the QOI data
+         * @throws std::runtime_error in case of i/o problem or if the
+         *      input file does not contain a valid QOI file
+         */
+        std::unique_ptr<Image> Decode(const char * filename) const;
+
+        /**
+         * Decodes a QOI file from an input stream into an 8-bit image.
+         *
+         * This method will not close the given input stream.
+         *
+         * @param is    the input stream
+         * @return the newly created image containing the QOI data
+         * @throws std::runtime_error in case of i/o problem or if the
+         *      input stream does not contain a valid QOI file
+         */
+        std::unique_ptr<ImageRgba8> DecodeRgba8(std::istream& is) const;
+
+        /**
+         * Convenient method to read an 8-bit image directly from a file.
+         *
+         * @param filename  the filename including the file path
+         * @return the newly created image containing the QOI data
+         * @throws std::runtime_error in case of i/o problem or if the
+         *      input file does not contain a valid QOI file
+         */
+        std::unique_ptr<ImageRgba8> DecodeRgba8(const char * filename) const;
+    };
+
+}
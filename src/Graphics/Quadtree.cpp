@@ -1,96 +1,250 @@
 /*
  * ASTU - AST Utilities
  * A collection of Utilities for Applied Software Techniques (AST).
- * 
+ *
  * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
  */
 
+#include <algorithm>
 #include <cassert>
-#include <iostream>
+#include <limits>
 #include "Quadtree.h"
 
 using namespace std;
 
+/** Tolerance added to shape bounds to compensate for rounding errors. */
+#define BOUNDS_MARGIN 1e-6
+
 namespace astu {
 
     Quadtree::Quadtree(int _maxElems, int _maxDepth)
-        : maxElems(_maxElems)
+        : numUnused(0)
+        , maxElems(_maxElems)
         , maxDepth(_maxDepth)
-        , depth(0)
-        , leaf(false)
     {
         // Intentionally left empty.
     }
 
-    void printBox(const BoundingBox & box, const char *col)
+    void Quadtree::BuildTree()
     {
-        cout << "box(<" << box.GetCenter().x << ", " << box.GetCenter().y 
-        << ">, " << box.GetWidth() << ", " << box.GetHeight() << ", " << col << ");" << endl;
+        nodes.clear();
+        items.clear();
+        numUnused = 0;
+        shapes.clear();
+        shapeBounds.clear();
+
+        if (children.empty()) {
+            return;
+        }
+
+        const double inf = std::numeric_limits<double>::infinity();
+        vector<uint32_t> ids;
+        ids.reserve(children.size());
+        for (const auto & child : children) {
+            const auto & box = child->GetBoundingBox();
+            if (box.IsInfinite()) {
+                shapeBounds.push_back({-inf, -inf, inf, inf});
+            } else {
+                shapeBounds.push_back({
+                    box.GetLeftBound() - BOUNDS_MARGIN, box.GetLowerBound() - BOUNDS_MARGIN,
+                    box.GetRightBound() + BOUNDS_MARGIN, box.GetUpperBound() + BOUNDS_MARGIN});
+            }
+            ids.push_back(static_cast<uint32_t>(shapes.size()));
+            shapes.push_back(child.get());
+        }
+
+        nodes.push_back(Node());
+        const Bounds rootBox = {localBox.GetLeftBound(), localBox.GetLowerBound(),
+            localBox.GetRightBound(), localBox.GetUpperBound()};
+        BuildNode(0, rootBox, ids, 0);
     }
 
-    void Quadtree::BuildTree()
+    void Quadtree::BuildNode(uint32_t nodeIdx, const Bounds & box, vector<uint32_t> & ids, int depth)
     {
-        if (static_cast<int>(children.size()) < maxElems || depth >= maxDepth) {
-            leaf = true;
+        const double cx = (box.minX + box.maxX) / 2;
+        const double cy = (box.minY + box.maxY) / 2;
+        nodes[nodeIdx].cx = cx;
+        nodes[nodeIdx].cy = cy;
+        nodes[nodeIdx].firstChild = 0;
+        nodes[nodeIdx].firstItem = static_cast<uint32_t>(items.size());
+        nodes[nodeIdx].numItems = 0;
+
+        if (static_cast<int>(ids.size()) < maxElems || depth >= maxDepth) {
+            items.insert(items.end(), ids.begin(), ids.end());
+            nodes[nodeIdx].numItems = static_cast<uint32_t>(ids.size());
             return;
         }
-        leaf = false;
 
-        upperLeft = CreateNode(-localBox.GetHRadius() / 2, localBox.GetVRadius() / 2);
-        upperRight = CreateNode(localBox.GetHRadius() / 2, localBox.GetVRadius() / 2);
-        lowerLeft = CreateNode(-localBox.GetHRadius() / 2, -localBox.GetVRadius() / 2);
-        lowerRight = CreateNode(localBox.GetHRadius() / 2, -localBox.GetVRadius() / 2);
+        // Quadrants in the order upper right, lower right, upper left and
+        // lower left, matching the order used by FindLeaf().
+        const Bounds quadrants[4] = {
+            {cx, cy, box.maxX, box.maxY},
+            {cx, box.minY, box.maxX, cy},
+            {box.minX, cy, cx, box.maxY},
+            {box.minX, box.minY, cx, cy},
+        };
 
-        // printBox(upperLeft->localBox, "BLUE");
-        // printBox(upperRight->localBox, "GREEN");
-        // printBox(lowerLeft->localBox, "YELLOW");
-        // printBox(lowerRight->localBox, "ORANGE");
+        vector<uint32_t> quadrantIds[4];
+        bool progress = false;
+        for (int q = 0; q < 4; ++q) {
+            const Bounds & qb = quadrants[q];
+            for (auto id : ids) {
+                const Bounds & sb = shapeBounds[id];
+                if (sb.minX <= qb.maxX && sb.maxX >= qb.minX && sb.minY <= qb.maxY && sb.maxY >= qb.minY) {
+                    quadrantIds[q].push_back(id);
+                }
+            }
+            progress |= quadrantIds[q].size() < ids.size();
+        }
 
+        // Splitting does not pay off if all shapes overlap all quadrants.
+        if (!progress) {
+            items.insert(items.end(), ids.begin(), ids.end());
+            nodes[nodeIdx].numItems = static_cast<uint32_t>(ids.size());
+            return;
+        }
 
-        for (auto child : children) {
-            const auto & box = child->GetBoundingBox();
+        const uint32_t firstChild = static_cast<uint32_t>(nodes.size());
+        nodes[nodeIdx].firstChild = firstChild;
+        nodes.resize(nodes.size() + 4);
+        ids.clear();
+        ids.shrink_to_fit();
 
-            if (upperLeft->localBox.IsInside(box)) {
-                upperLeft->Add(child);
-                // cout << "upper left" << endl;
-                // printBox(upperLeft->localBox, "BLUE");
-                // printBox(box, "RED");
-            }
+        for (uint32_t q = 0; q < 4; ++q) {
+            BuildNode(firstChild + q, quadrants[q], quadrantIds[q], depth + 1);
+        }
+    }
 
-            if (upperRight->localBox.IsInside(box)) {
-                upperRight->Add(child);
-                // cout << "upper right" << endl;
-                // printBox(upperRight->localBox, "GREEN");
-                // printBox(box, "RED");
-            }
+    bool Quadtree::UpdateShape(size_t idx)
+    {
+        if (nodes.empty() || idx >= shapes.size()) {
+            return false;
+        }
 
-            if (lowerLeft->localBox.IsInside(box)) {
-                lowerLeft->Add(child);
-                // cout << "lower left" << endl;
-                // printBox(lowerLeft->localBox, "YELLOW");
-                // printBox(box, "RED");
-            }
+        const uint32_t id = static_cast<uint32_t>(idx);
+        RemoveReferences(id);
 
-            if (lowerRight->localBox.IsInside(box)) {
-                lowerRight->Add(child);
-                // cout << "lower right" << endl;
-                // printBox(lowerRight->localBox, "ORANGE");
-                // printBox(box, "RED");
-            }
+        const auto & box = shapes[id]->GetBoundingBox();
+        if (box.IsInfinite() 
+            || box.GetLeftBound() < localBox.GetLeftBound()
+            || box.GetRightBound() > localBox.GetRightBound()
+            || box.GetLowerBound() < localBox.GetLowerBound()
+            || box.GetUpperBound() > localBox.GetUpperBound()) 
+        {
+            return false;
         }
 
-        upperLeft->BuildTree();
-        upperRight->BuildTree();
-        lowerLeft->BuildTree();
-        lowerRight->BuildTree();
-        // children.clear();
+        shapeBounds[id] = {
+            box.GetLeftBound() - BOUNDS_MARGIN, box.GetLowerBound() - BOUNDS_MARGIN,
+            box.GetRightBound() + BOUNDS_MARGIN, box.GetUpperBound() + BOUNDS_MARGIN};
+
+        vector<uint32_t> leaves;
+        const Bounds rootBox = {localBox.GetLeftBound(), localBox.GetLowerBound(),
+            localBox.GetRightBound(), localBox.GetUpperBound()};
+        CollectLeaves(0, rootBox, shapeBounds[id], leaves);
+
+        // The references of a leaf are contiguous and sorted by shape index,
+        // hence the range of each leaf is moved to the end of the array with
+        // the new reference inserted at its position.
+        for (auto leafIdx : leaves) {
+            Node & leaf = nodes[leafIdx];
+            const size_t first = items.size();
+            items.resize(first + leaf.numItems + 1);
+
+            const uint32_t* src = items.data() + leaf.firstItem;
+            const uint32_t* srcEnd = src + leaf.numItems;
+            const uint32_t* pos = std::lower_bound(src, srcEnd, id);
+            uint32_t* dst = std::copy(src, pos, items.data() + first);
+            *dst++ = id;
+            std::copy(pos, srcEnd, dst);
+
+            numUnused += leaf.numItems;
+            leaf.firstItem = static_cast<uint32_t>(first);
+            ++leaf.numItems;
+        }
+
+        if (numUnused > items.size() / 2) {
+            CompactItems();
+        }
+
+        return true;
     }
 
-    void Quadtree::OnPatternAdded(Pattern & pattern)
+    bool Quadtree::RemoveShape(size_t idx)
+    {
+        if (nodes.empty() || idx >= shapes.size()) {
+            return false;
+        }
+
+        const uint32_t id = static_cast<uint32_t>(idx);
+        RemoveReferences(id);
+
+        // Empty bounds do not overlap any leaf.
+        const double inf = std::numeric_limits<double>::infinity();
+        shapeBounds[id] = {inf, inf, -inf, -inf};
+        return true;
+    }
+
+    void Quadtree::RemoveReferences(uint32_t idx)
+    {
+        vector<uint32_t> leaves;
+        const Bounds rootBox = {localBox.GetLeftBound(), localBox.GetLowerBound(),
+            localBox.GetRightBound(), localBox.GetUpperBound()};
+        CollectLeaves(0, rootBox, shapeBounds[idx], leaves);
+
+        for (auto leafIdx : leaves) {
+            Node & leaf = nodes[leafIdx];
+            uint32_t* first = items.data() + leaf.firstItem;
+            uint32_t* last = first + leaf.numItems;
+            uint32_t* it = std::lower_bound(first, last, idx);
+            if (it != last && *it == idx) {
+                std::copy(it + 1, last, it);
+                --leaf.numItems;
+                ++numUnused;
+            }
+        }
+    }
+
+    void Quadtree::CollectLeaves(uint32_t nodeIdx, const Bounds & box, const Bounds & sb, 
+        vector<uint32_t> & result) const
     {
-        if (leaf) {
+        if (sb.minX > box.maxX || sb.maxX < box.minX || sb.minY > box.maxY || sb.maxY < box.minY) {
             return;
         }
+
+        const Node & node = nodes[nodeIdx];
+        if (!node.firstChild) {
+            result.push_back(nodeIdx);
+            return;
+        }
+
+        // Same order of quadrants as used by BuildNode().
+        CollectLeaves(node.firstChild, {node.cx, node.cy, box.maxX, box.maxY}, sb, result);
+        CollectLeaves(node.firstChild + 1, {node.cx, box.minY, box.maxX, node.cy}, sb, result);
+        CollectLeaves(node.firstChild + 2, {box.minX, node.cy, node.cx, box.maxY}, sb, result);
+        CollectLeaves(node.firstChild + 3, {box.minX, box.minY, node.cx, node.cy}, sb, result);
+    }
+
+    void Quadtree::CompactItems()
+    {
+        vector<uint32_t> compacted;
+        compacted.reserve(items.size() - numUnused);
+        for (auto & node : nodes) {
+            if (node.firstChild) {
+                continue;
+            }
+
+            const uint32_t first = static_cast<uint32_t>(compacted.size());
+            compacted.insert(compacted.end(), 
+                items.begin() + node.firstItem, items.begin() + node.firstItem + node.numItems);
+            node.firstItem = first;
+        }
+        items.swap(compacted);
+        numUnused = 0;
+    }
+
+    void Quadtree::OnPatternAdded(Pattern & pattern)
+    {
         const auto & box = pattern.GetBoundingBox();
 
         if (localBox.IsZero() && !box.IsInfinite()) {
@@ -98,15 +252,17 @@ namespace astu {
         } else {
             localBox.Merge(box);
         }
+        nodes.clear();
     }
 
     void Quadtree::OnClear()
     {
         localBox.Reset();
-        upperLeft.reset();
-        upperRight.reset();
-        lowerLeft.reset();
-        lowerRight.reset();
+        nodes.clear();
+        items.clear();
+        numUnused = 0;
+        shapes.clear();
+        shapeBounds.clear();
     }
 
     BoundingBox Quadtree::GetLocalBoundingBox() const
@@ -120,34 +276,131 @@ namespace astu {
             return false;
         }
 
-        if (!leaf) {
-            if (pt.x > localBox.GetCenter().x) {
-                if (pt.y > localBox.GetCenter().y) {
-                    return upperRight->GetColorTransformed(pt, c);
-                } else {
-                    return lowerRight->GetColorTransformed(pt, c);
+        if (nodes.empty()) {
+            // Tree has not been built, test all children.
+            bool hasColor = false;
+            for (const auto & pattern : children) {
+                Color4d localColor;
+                if (pattern->GetColor(pt, localColor)) {
+                    if (hasColor) {
+                        c.Blend(localColor);
+                    } else {
+                        hasColor = true;
+                        c = localColor;
+                    }
                 }
-            } else {
-                if (pt.y > localBox.GetCenter().y) {
-                    return upperLeft->GetColorTransformed(pt, c);
-                } else {
-                    return lowerLeft->GetColorTransformed(pt, c);
+            }
+            return hasColor;
+        }
+
+        const Node & leaf = nodes[FindLeaf(0, pt.x, pt.y)];
+        return GetLocalColorTransformed(items.data() + leaf.firstItem, leaf.numItems, pt, c);
+    }
+
+    void Quadtree::GetColorsTransformed(
+        const double* xs, const double* ys, Color4d* out, uint8_t* mask, size_t n) const
+    {
+        if (nodes.empty()) {
+            Pattern::GetColorsTransformed(xs, ys, out, mask, n);
+            return;
+        }
+
+        const double left = localBox.GetLeftBound();
+        const double right = localBox.GetRightBound();
+        const double lower = localBox.GetLowerBound();
+        const double upper = localBox.GetUpperBound();
+
+        uint8_t inside[PACKET_SIZE];
+        uint8_t all = 1;
+        for (size_t i = 0; i < n; ++i) {
+            inside[i] = (xs[i] <= right) & (xs[i] >= left) & (ys[i] <= upper) & (ys[i] >= lower);
+            all &= inside[i];
+        }
+
+        // Descend with the whole packet as long as all points fall into the
+        // same quadrant.
+        uint32_t idx = 0;
+        while (all && nodes[idx].firstChild) {
+            const Node & node = nodes[idx];
+            const uint8_t right0 = xs[0] > node.cx;
+            const uint8_t upper0 = ys[0] > node.cy;
+            uint8_t coherent = 1;
+            for (size_t i = 0; i < n; ++i) {
+                coherent &= ((xs[i] > node.cx) == right0) & ((ys[i] > node.cy) == upper0);
+            }
+
+            if (!coherent) {
+                break;
+            }
+            idx = node.firstChild + (right0 ? 0 : 2) + (upper0 ? 0 : 1);
+        }
+
+        if (!all || nodes[idx].firstChild) {
+            // Packet straddles quadrants, evaluate the points one by one.
+            for (size_t i = 0; i < n; ++i) {
+                if (!inside[i]) {
+                    mask[i] = 0;
+                    continue;
                 }
+
+                const Node & leaf = nodes[FindLeaf(idx, xs[i], ys[i])];
+                mask[i] = GetLocalColorTransformed(items.data() + leaf.firstItem,
+                    leaf.numItems, Vector2<double>(xs[i], ys[i]), out[i]) ? 1 : 0;
             }
+            return;
+        }
 
-            return false;
+        // Shapes which do not overlap the bounding box of the packet are
+        // skipped.
+        double minX = xs[0], maxX = xs[0], minY = ys[0], maxY = ys[0];
+        for (size_t i = 1; i < n; ++i) {
+            minX = std::min(minX, xs[i]);
+            maxX = std::max(maxX, xs[i]);
+            minY = std::min(minY, ys[i]);
+            maxY = std::max(maxY, ys[i]);
         }
+        std::fill(mask, mask + n, 0);
 
+        Color4d localColors[PACKET_SIZE];
+        uint8_t localMask[PACKET_SIZE];
+        const Node & leaf = nodes[idx];
+        const uint32_t* it = items.data() + leaf.firstItem;
+        const uint32_t* end = it + leaf.numItems;
+        for (; it != end; ++it) {
+            const Bounds & sb = shapeBounds[*it];
+            if (sb.minX > maxX || sb.maxX < minX || sb.minY > maxY || sb.maxY < minY) {
+                continue;
+            }
+
+            shapes[*it]->GetColors(xs, ys, localColors, localMask, n);
+            for (size_t i = 0; i < n; ++i) {
+                if (!localMask[i]) {
+                    continue;
+                }
 
-        return GetLocalColorTransformed(pt, c);
+                if (mask[i]) {
+                    out[i].Blend(localColors[i]);
+                } else {
+                    mask[i] = 1;
+                    out[i] = localColors[i];
+                }
+            }
+        }
     }
 
-    bool Quadtree::GetLocalColorTransformed(const Vector2<double> &pt, Color4d & c) const
+    bool Quadtree::GetLocalColorTransformed(
+        const uint32_t* first, size_t n, const Vector2<double> &pt, Color4d & c) const
     {
         bool hasColor = false;
-        for (auto pattern : children) {
+        for (size_t i = 0; i < n; ++i) {
+            const uint32_t id = first[i];
+            const Bounds & sb = shapeBounds[id];
+            if (pt.x < sb.minX || pt.x > sb.maxX || pt.y < sb.minY || pt.y > sb.maxY) {
+                continue;
+            }
+
             Color4d localColor;
-            if (pattern->GetColor(pt, localColor)) {
+            if (shapes[id]->GetColor(pt, localColor)) {
                 if (hasColor) {
                     c.Blend(localColor);
                 } else {
@@ -160,16 +413,4 @@ namespace astu {
         return hasColor;
     }
 
-    std::unique_ptr<Quadtree> Quadtree::CreateNode(double dx, double dy)
-    {
-        auto result = std::make_unique<Quadtree>(maxElems, maxDepth);
-        result->leaf = true;
-        result->depth = depth + 1;
-        result->localBox.SetWidth(localBox.GetHRadius());
-        result->localBox.SetHeight(localBox.GetVRadius());
-        result->localBox.MoveCenter(dx, dy);
-        result->localBox.SetCenter(localBox.GetCenter() + Vector2<double>(dx, dy));
-        return result;
-    }
-
-}
\ No newline at end of file
+}
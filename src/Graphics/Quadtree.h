@@ -1,27 +1,44 @@
 /*
  * ASTU - AST Utilities
  * A collection of Utilities for Applied Software Techniques (AST).
- * 
+ *
  * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
  */
 
 #pragma once
 
-#include <memory>
-#include <array>
+#include <cstdint>
+#include <vector>
 
 #include "Pattern.h"
 
 namespace astu {
 
+    /**
+     * A compound pattern which uses a quadtree to speed up the lookup of
+     * the child patterns covering a point.
+     *
+     * The nodes of the tree are stored in one contiguous array, the four
+     * children of a node are stored next to each other and are referenced
+     * by index. Leaf nodes reference a range of shape indices, patterns
+     * straddling the boundaries of quadrants are referenced from every
+     * leaf they overlap. Child patterns are blended in the order in which
+     * they have been added.
+     *
+     * The tree must be rebuilt by calling BuildTree() after patterns have
+     * been added. Single child patterns which have been transformed or
+     * which are no longer required can be updated by UpdateShape() and
+     * RemoveShape() without rebuilding the tree. As long as the tree has
+     * not been built, all child patterns are tested.
+     */
     class Quadtree : public CompoundPattern {
     public:
 
         /**
          * Constructor.
-         * 
-         * @param maxElems  the maximum number of elements in one onde
-         * @param maxDepth  theh maximum depth of this tree
+         *
+         * @param maxElems  the maximum number of elements in one node
+         * @param maxDepth  the maximum depth of this tree
          */
         Quadtree(int maxElems = 5, int maxDepth = 5);
 
@@ -30,26 +47,96 @@ namespace astu {
          */
         void BuildTree();
 
+        /**
+         * Updates the leaves referencing a child pattern after it has been
+         * transformed.
+         * 
+         * The child pattern is removed from the leaves overlapping its
+         * previous bounds and added to the leaves overlapping its current
+         * bounds. The structure of the tree remains unchanged.
+         *
+         * @param idx   the index of the child pattern in the order of adding
+         * @return `false` if the tree has not been built or the child
+         *          pattern has left the bounds of this tree, in which case
+         *          the tree must be rebuilt
+         */
+        bool UpdateShape(size_t idx);
+
+        /**
+         * Removes all references to a child pattern from the leaves.
+         *
+         * The child pattern itself remains a child of this compound but is
+         * no longer considered during lookups.
+         *
+         * @param idx   the index of the child pattern in the order of adding
+         * @return `false` if the tree has not been built, in which case the
+         *          tree must be rebuilt
+         */
+        bool RemoveShape(size_t idx);
+
+        /**
+         * Returns the number of nodes of this tree.
+         *
+         * @return the number of nodes, zero if the tree has not been built
+         */
+        size_t NumberOfNodes() const {
+            return nodes.size();
+        }
+
+        /**
+         * Returns the number of shape references stored in the leaves.
+         *
+         * @return the number of shape references
+         */
+        size_t NumberOfReferences() const {
+            return items.size() - numUnused;
+        }
+
     protected:
 
         // Inherited via CompoundPattern
         virtual bool GetColorTransformed(const Vector2<double> &pt, Color4d & c) const override;
+        virtual void GetColorsTransformed(
+            const double* xs, const double* ys, Color4d* out, uint8_t* mask, size_t n) const override;
         virtual BoundingBox GetLocalBoundingBox() const override;
         virtual void OnPatternAdded(Pattern & pattern) override;
         virtual void OnClear() override;
 
     private:
-        /** The upper left child node of this node. */
-        std::unique_ptr<Quadtree> upperLeft;
+        /** A node of the flattened tree. */
+        struct Node {
+            /** The center of this node, used to select the quadrant. */
+            double cx, cy;
+
+            /** The index of the first of four children, zero for leaves. */
+            uint32_t firstChild;
+
+            /** The index of the first shape reference of a leaf. */
+            uint32_t firstItem;
+
+            /** The number of shape references of a leaf. */
+            uint32_t numItems;
+        };
+
+        /** The axis aligned bounds of a child pattern. */
+        struct Bounds {
+            double minX, minY, maxX, maxY;
+        };
 
-        /** The upper right child node of this node. */
-        std::unique_ptr<Quadtree> upperRight;
+        /** The nodes of this tree, the first node is the root. */
+        std::vector<Node> nodes;
 
-        /** The lower left child node of this node. */
-        std::unique_ptr<Quadtree> lowerLeft;
+        /** The shape indices referenced by the leaves. */
+        std::vector<uint32_t> items;
 
-        /** The lower right child node of this node. */
-        std::unique_ptr<Quadtree> lowerRight;
+        /** The number of entries in items no longer used by any leaf. */
+        size_t numUnused;
+
+        /** The child patterns, cached at build time. */
+        std::vector<const Pattern*> shapes;
+
+        /** The bounds of the child patterns, cached at build time. */
+        std::vector<Bounds> shapeBounds;
 
         /** The maximum number fo elements alowed for one single node. */
         int maxElems;
@@ -57,18 +144,70 @@ namespace astu {
         /** The maximum depth of this tree. */
         int maxDepth;
 
-        /** The depth level of this node. */
-        int depth;
+        /** The bounding box of this quadtree in local space. */
+        BoundingBox localBox;
 
-        /** Determines whether this node is a leaf node. */
-        bool leaf;
+        /**
+         * Builds a subtree.
+         *
+         * @param nodeIdx   the index of the node to build
+         * @param box       the bounds of the node
+         * @param ids       the indices of the shapes overlapping the node
+         * @param depth     the depth of the node
+         */
+        void BuildNode(uint32_t nodeIdx, const Bounds & box, std::vector<uint32_t> & ids, int depth);
 
-        /** The bounding box of this octree in local space. */
-        BoundingBox localBox;
+        /**
+         * Collects the leaves overlapping the specified bounds.
+         *
+         * @param nodeIdx   the index of the node to start the search
+         * @param box       the bounds of the node
+         * @param sb        the bounds to test
+         * @param result    receives the indices of the leaves
+         */
+        void CollectLeaves(uint32_t nodeIdx, const Bounds & box, const Bounds & sb, 
+            std::vector<uint32_t> & result) const;
+
+        /**
+         * Removes the references to a shape from the leaves overlapping its
+         * cached bounds.
+         *
+         * @param idx   the index of the shape
+         */
+        void RemoveReferences(uint32_t idx);
 
-        std::unique_ptr<Quadtree> CreateNode(double dx, double dy);
-        bool GetLocalColorTransformed(const Vector2<double> &pt, Color4d & c) const;
+        /**
+         * Moves the references of all leaves to the front of the reference
+         * array, dropping unused entries.
+         */
+        void CompactItems();
 
+        /**
+         * Returns the index of the leaf containing the specified point.
+         *
+         * @param idx   the index of the node to start the search
+         * @param x     the x-coordinate of the point
+         * @param y     the y-coordinate of the point
+         * @return the index of the leaf node
+         */
+        uint32_t FindLeaf(uint32_t idx, double x, double y) const {
+            while (nodes[idx].firstChild) {
+                const Node & node = nodes[idx];
+                idx = node.firstChild + (x > node.cx ? 0 : 2) + (y > node.cy ? 0 : 1);
+            }
+            return idx;
+        }
+
+        /**
+         * Blends the colors of a range of shapes at the specified point.
+         *
+         * @param first the first shape reference
+         * @param n     the number of shape references
+         * @param pt    the point
+         * @param c     receives the color
+         * @return `true` if at least one shape covers the point
+         */
+        bool GetLocalColorTransformed(const uint32_t* first, size_t n, const Vector2<double> &pt, Color4d & c) const;
     };
 
-}
\ No newline at end of file
+}
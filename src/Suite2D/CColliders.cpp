@@ -8,10 +8,130 @@
 // Local includes
 #include "Suite2D/CColliders.h"
 
+// C++ Standard Library includes
+#include <algorithm>
+#include <cmath>
+
 using namespace std;
 
+/** Normals with a smaller cross product are considered parallel. */
+#define PARALLEL_TOLERANCE 1e-6f
+
 namespace astu::suite2d {
 
+    /////////////////////////////////////////////////
+    /////// CPolygonCollider
+    /////////////////////////////////////////////////
+
+    shared_ptr<const CPolygonCollider::ConvexParts> CPolygonCollider::Preprocess(
+        const Polygon2f& poly, size_t maxVertices)
+    {
+        auto result = make_shared<ConvexParts>();
+        for (auto & part : poly.DecomposeConvex(maxVertices)) {
+            vector<Vector2f> normals;
+            for (size_t i = 0; i < part.NumEdges(); ++i) {
+                if (part.GetEdge(i).LengthSquared() == 0) {
+                    continue;
+                }
+
+                const auto n = part.GetEdgeNormal(i);
+                bool isParallel = false;
+                for (const auto & other : normals) {
+                    isParallel |= std::abs(n.Cross(other)) < PARALLEL_TOLERANCE;
+                }
+                if (!isParallel) {
+                    normals.push_back(n);
+                }
+            }
+
+            vector<Segment1f> extents(normals.size());
+            part.Project(normals.data(), normals.size(), extents.data());
+
+            Vector2f center(0, 0);
+            for (const auto & v : part.GetVertices()) {
+                center += v;
+            }
+            center /= static_cast<float>(part.NumVertices());
+
+            float radiusSquared = 0;
+            for (const auto & v : part.GetVertices()) {
+                radiusSquared = std::max(radiusSquared, (v - center).LengthSquared());
+            }
+
+            result->push_back({std::move(part), std::move(normals), std::move(extents),
+                center, std::sqrt(radiusSquared)});
+        }
+
+        return result;
+    }
+
+    void CPolygonCollider::SetPolygon(std::shared_ptr<const Polygon2f> poly)
+    {
+        SetPolygon(poly, poly ? Preprocess(*poly) : nullptr);
+    }
+
+    /**
+     * Tests whether the normals of part a separate it from part b.
+     * 
+     * @param a the part providing the separating axes
+     * @param b the other part
+     * @param c the cosine of the rotation of b relative to a
+     * @param s the sine of the rotation of b relative to a
+     * @param d the translation of b within the frame of a
+     */
+    static bool IsSeparated(const CPolygonCollider::ConvexPart& a, 
+        const CPolygonCollider::ConvexPart& b, float c, float s, const Vector2f& d)
+    {
+        for (size_t i = 0; i < a.normals.size(); ++i) {
+            const auto & n = a.normals[i];
+
+            // Projecting the vertices of b onto the axis rotated into the
+            // frame of b avoids transforming the vertices.
+            const auto ext = b.polygon.Project(Vector2f(c * n.x + s * n.y, c * n.y - s * n.x));
+            const float o = n.Dot(d);
+            if (ext.GetX1() + o < a.extents[i].GetX0() || ext.GetX0() + o > a.extents[i].GetX1()) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool CPolygonCollider::IsOverlapping(const Vector2f& pos, float angle, 
+        const CPolygonCollider& other, const Vector2f& otherPos, float otherAngle) const
+    {
+        const auto & partsA = GetConvexParts();
+        const auto & partsB = other.GetConvexParts();
+
+        // Polygons are compared within the frame of this polygon.
+        const float theta = otherAngle - angle;
+        const float c = std::cos(theta);
+        const float s = std::sin(theta);
+        const Vector2f d = Vector2f(otherPos - pos).Rotate(-angle) 
+            + Vector2f(other.GetOffset()).Rotate(theta) - GetOffset();
+        const Vector2f dInv = Vector2f(-d).Rotate(-theta);
+
+        for (const auto & a : partsA) {
+            for (const auto & b : partsB) {
+                const Vector2f cb = Vector2f(b.center).Rotate(theta) + d;
+                const float r = a.radius + b.radius;
+                if ((cb - a.center).LengthSquared() > r * r) {
+                    continue;
+                }
+
+                if (!IsSeparated(a, b, c, s, d) && !IsSeparated(b, a, c, -s, dInv)) {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    /////////////////////////////////////////////////
+    /////// Builders
+    /////////////////////////////////////////////////
+
     CCircleColliderBuilder::CCircleColliderBuilder(shared_ptr<CCircleColliderFactory> factory)
         : colliderFactory(factory)
     {
@@ -45,9 +165,14 @@ namespace astu::suite2d {
         if (!polygon) {
             throw std::logic_error("No polygon specified for polygon collider");
         }
+        if (!convexParts) {
+            // Decomposed once and shared by all colliders built from it.
+            convexParts = CPolygonCollider::Preprocess(*polygon, maxPartVertices);
+        }
+
         auto collider = colliderFactory->CreatePolygonCollider();
         Configure(*collider);
-        collider->SetPolygon(polygon);
+        collider->SetPolygon(polygon, convexParts);
 
         return collider;
 
@@ -63,6 +188,7 @@ namespace astu::suite2d {
         tempVertices.push_back(Vector2f(w / 2, h / 2));
         tempVertices.push_back(Vector2f(w / 2, -h / 2));
         polygon = make_shared<Polygon2f>(tempVertices);
+        convexParts = nullptr;
         tempVertices.clear();
         return *this;
     }
@@ -0,0 +1,326 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+// Local includes
+#include "Suite2D/ImageSceneRenderer2D.h"
+#include "Graphics/WebColors.h"
+
+// C++ Standard Library includes
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+#define ASSERT_VBUF(a) assert(dynamic_cast<ImageVertexBuffer2D*>(&a))
+#define VBUF(a) static_cast<const ImageVertexBuffer2D&>(a)
+
+namespace astu::suite2d {
+
+    /////////////////////////////////////////////////
+    /////// ImageVertexBufferBuilderService2D
+    /////////////////////////////////////////////////
+
+    ImageVertexBufferBuilderService2D::ImageVertexBufferBuilderService2D()
+        : Service("Image Vertex Buffer 2D Builder Service")
+    {
+        Reset();
+    }
+
+    VertexBufferBuilder2f& ImageVertexBufferBuilderService2D::AddVertex(float x, float y)
+    {
+        vertices.push_back({x, y});
+        return *this;
+    }
+
+    const Vector2f& ImageVertexBufferBuilderService2D::GetVertex(size_t idx) const
+    {
+        return vertices.at(idx);
+    }
+
+    VertexBufferBuilder2f& ImageVertexBufferBuilderService2D::SetVertex(size_t idx, float x, float y)
+    {
+        vertices.at(idx).Set(x, y);
+        return *this;
+    }
+
+    size_t ImageVertexBufferBuilderService2D::GetNumVertices() const
+    {
+        return vertices.size();
+    }
+
+    VertexBufferBuilder2f& ImageVertexBufferBuilderService2D::Reset()
+    {
+        vertices.clear();
+        return *this;
+    }
+
+    std::shared_ptr<VertexBuffer2f> ImageVertexBufferBuilderService2D::Build()
+    {
+        auto result = std::make_shared<ImageVertexBuffer2D>();
+        result->vertices = vertices;
+        return result;
+    }
+
+    /////////////////////////////////////////////////
+    /////// ImageSceneRenderer2D
+    /////////////////////////////////////////////////
+
+    ImageSceneRenderer2D::ImageSceneRenderer2D(int w, int h)
+        : width(w)
+        , height(h)
+        , backgroundColor(WebColors::Black)
+        , antialiasing(true)
+    {
+        if (w <= 0) {
+            throw std::domain_error("Framebuffer width must be greater zero, got "
+                + std::to_string(w));
+        }
+
+        if (h <= 0) {
+            throw std::domain_error("Framebuffer height must be greater zero, got "
+                + std::to_string(h));
+        }
+
+        framebuffer.resize(static_cast<size_t>(width) * height * 4);
+        Clear();
+    }
+
+    void ImageSceneRenderer2D::Clear()
+    {
+        Color4f c = backgroundColor;
+        c.Saturate();
+
+        const uint8_t rgba[4] = {
+            static_cast<uint8_t>(c.r * 255 + 0.5f),
+            static_cast<uint8_t>(c.g * 255 + 0.5f),
+            static_cast<uint8_t>(c.b * 255 + 0.5f),
+            static_cast<uint8_t>(c.a * 255 + 0.5f),
+        };
+
+        for (size_t i = 0; i < framebuffer.size(); i += 4) {
+            framebuffer[i + 0] = rgba[0];
+            framebuffer[i + 1] = rgba[1];
+            framebuffer[i + 2] = rgba[2];
+            framebuffer[i + 3] = rgba[3];
+        }
+    }
+
+    void ImageSceneRenderer2D::CopyTo(Image& image) const
+    {
+        if (image.GetWidth() != width || image.GetHeight() != height) {
+            throw std::domain_error(
+                "Image dimensions do not match framebuffer dimensions");
+        }
+
+        ConvertPixels(reinterpret_cast<const Rgba8*>(framebuffer.data()),
+            image.GetPixels(), image.NumberOfPixels());
+    }
+
+    void ImageSceneRenderer2D::CopyTo(ImageRgba8& image) const
+    {
+        if (image.GetWidth() != width || image.GetHeight() != height) {
+            throw std::domain_error(
+                "Image dimensions do not match framebuffer dimensions");
+        }
+
+        std::memcpy(image.GetPixels(), framebuffer.data(), framebuffer.size());
+    }
+
+    void ImageSceneRenderer2D::Render(Polyline& polyline, float alpha)
+    {
+        ASSERT_VBUF(polyline.GetVertexBuffer());
+
+        const auto & vertices = VBUF(polyline.GetVertexBuffer()).vertices;
+        if (vertices.size() < 2) {
+            return;
+        }
+
+        const auto c = Color4f(polyline.GetColor()).SetAlpha(polyline.GetColor().a * alpha);
+        const auto & tx = viewMatrix * polyline.GetWorldMatrix();
+
+        auto it = vertices.cbegin();
+        const auto first = tx.TransformPoint(*it);
+        auto p1 = first;
+
+        while (++it != vertices.cend()) {
+            const auto p2 = tx.TransformPoint(*it);
+            DrawLine(p1, p2, c);
+            p1 = p2;
+        }
+
+        if (polyline.IsClosed()) {
+            DrawLine(p1, first, c);
+        }
+    }
+
+    void ImageSceneRenderer2D::DrawLine(const Vector2f& p0, const Vector2f& p1, const Color4f& c)
+    {
+        Color4f sc = c;
+        sc.Saturate();
+        const int rgba[4] = {
+            static_cast<int>(sc.r * 255 + 0.5f),
+            static_cast<int>(sc.g * 255 + 0.5f),
+            static_cast<int>(sc.b * 255 + 0.5f),
+            static_cast<int>(sc.a * 255 + 0.5f),
+        };
+
+        if (rgba[3] == 0) {
+            return;
+        }
+
+        float x0 = p0.x, y0 = p0.y, x1 = p1.x, y1 = p1.y;
+        if (!ClipLine(x0, y0, x1, y1)) {
+            return;
+        }
+
+        if (antialiasing) {
+            DrawLineWu(x0, y0, x1, y1, rgba);
+        } else {
+            DrawLineBresenham(x0, y0, x1, y1, rgba);
+        }
+    }
+
+    bool ImageSceneRenderer2D::ClipLine(float& x0, float& y0, float& x1, float& y1) const
+    {
+        // Liang-Barsky line clipping, using a margin of one pixel to
+        // allow antialiased lines to fade out at the borders.
+        const float xMin = -1.0f;
+        const float yMin = -1.0f;
+        const float xMax = static_cast<float>(width);
+        const float yMax = static_cast<float>(height);
+
+        const float dx = x1 - x0;
+        const float dy = y1 - y0;
+        const float p[4] = {-dx, dx, -dy, dy};
+        const float q[4] = {x0 - xMin, xMax - x0, y0 - yMin, yMax - y0};
+
+        float t0 = 0.0f;
+        float t1 = 1.0f;
+        for (int i = 0; i < 4; ++i) {
+            if (p[i] == 0.0f) {
+                if (q[i] < 0.0f) {
+                    return false;
+                }
+            } else {
+                const float t = q[i] / p[i];
+                if (p[i] < 0.0f) {
+                    t0 = std::max(t0, t);
+                } else {
+                    t1 = std::min(t1, t);
+                }
+            }
+        }
+
+        if (t0 > t1) {
+            return false;
+        }
+
+        x1 = x0 + t1 * dx;
+        y1 = y0 + t1 * dy;
+        x0 = x0 + t0 * dx;
+        y0 = y0 + t0 * dy;
+
+        return true;
+    }
+
+    void ImageSceneRenderer2D::DrawLineBresenham(float fx0, float fy0, float fx1, float fy1, const int rgba[4])
+    {
+        int x0 = static_cast<int>(std::floor(fx0 + 0.5f));
+        int y0 = static_cast<int>(std::floor(fy0 + 0.5f));
+        const int x1 = static_cast<int>(std::floor(fx1 + 0.5f));
+        const int y1 = static_cast<int>(std::floor(fy1 + 0.5f));
+
+        const int dx = std::abs(x1 - x0);
+        const int dy = -std::abs(y1 - y0);
+        const int sx = x0 < x1 ? 1 : -1;
+        const int sy = y0 < y1 ? 1 : -1;
+        int err = dx + dy;
+
+        while (true) {
+            BlendPixel(x0, y0, rgba, 255);
+            if (x0 == x1 && y0 == y1) {
+                break;
+            }
+
+            const int e2 = 2 * err;
+            if (e2 >= dy) {
+                err += dy;
+                x0 += sx;
+            }
+            if (e2 <= dx) {
+                err += dx;
+                y0 += sy;
+            }
+        }
+    }
+
+    void ImageSceneRenderer2D::DrawLineWu(float x0, float y0, float x1, float y1, const int rgba[4])
+    {
+        const bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+        if (steep) {
+            std::swap(x0, y0);
+            std::swap(x1, y1);
+        }
+
+        if (x0 > x1) {
+            std::swap(x0, x1);
+            std::swap(y0, y1);
+        }
+
+        const float dx = x1 - x0;
+        const float gradient = dx == 0.0f ? 1.0f : (y1 - y0) / dx;
+
+        // Plots a pixel with the specified intensity, taking into account
+        // whether x and y have been swapped.
+        auto plot = [this, steep, rgba](int x, int y, float intensity) {
+            const int coverage = static_cast<int>(intensity * 255 + 0.5f);
+            if (steep) {
+                BlendPixel(y, x, rgba, coverage);
+            } else {
+                BlendPixel(x, y, rgba, coverage);
+            }
+        };
+
+        // First end point.
+        float xEnd = std::floor(x0 + 0.5f);
+        float yEnd = y0 + gradient * (xEnd - x0);
+        float xGap = 1.0f - (x0 + 0.5f - std::floor(x0 + 0.5f));
+        const int xPixel1 = static_cast<int>(xEnd);
+        int yPixel = static_cast<int>(std::floor(yEnd));
+        float frac = yEnd - std::floor(yEnd);
+        plot(xPixel1, yPixel, (1.0f - frac) * xGap);
+        plot(xPixel1, yPixel + 1, frac * xGap);
+        float intery = yEnd + gradient;
+
+        // Second end point.
+        xEnd = std::floor(x1 + 0.5f);
+        yEnd = y1 + gradient * (xEnd - x1);
+        xGap = x1 + 0.5f - std::floor(x1 + 0.5f);
+        const int xPixel2 = static_cast<int>(xEnd);
+        yPixel = static_cast<int>(std::floor(yEnd));
+        frac = yEnd - std::floor(yEnd);
+        if (xPixel2 != xPixel1) {
+            plot(xPixel2, yPixel, (1.0f - frac) * xGap);
+            plot(xPixel2, yPixel + 1, frac * xGap);
+        }
+
+        // Main loop, processes one scanline (or column) at a time.
+        for (int x = xPixel1 + 1; x < xPixel2; ++x) {
+            const float fy = std::floor(intery);
+            const int y = static_cast<int>(fy);
+            frac = intery - fy;
+            plot(x, y, 1.0f - frac);
+            plot(x, y + 1, frac);
+            intery += gradient;
+        }
+    }
+
+} // end of namespace
@@ -14,6 +14,9 @@
 
 using namespace std;
 
+/** The minimum number of children updated by a single task. */
+#define MIN_CHILDREN_PER_TASK 64
+
 namespace astu::suite2d {
 
     /////////////////////////////////////////////////
@@ -35,21 +38,43 @@ namespace astu::suite2d {
     Spatial::Spatial()
         : parent(nullptr)
         , alpha(1.0f)
+        , parallelUpdate(true)
+        , childIndex(0)
     {
         // Intentionally left empty.
     }
 
     Spatial::Spatial(const Spatial &o)
-        : parent(nullptr)
+        : enable_shared_from_this<Spatial>()
+        , parent(nullptr)
         , name(o.name)
         , alpha(o.alpha)
+        , parallelUpdate(o.parallelUpdate)
         , localTransform(o.localTransform)
         , worldMatrix(o.worldMatrix)
         , localMatrix(o.localMatrix)
+        , childIndex(0)
     {
         // Intentionally left empty.
     }
 
+    void Spatial::SetName(const std::string & _name)
+    {
+        if (name == _name) {
+            return;
+        }
+
+        for (Node* node = parent; node; node = node->parent) {
+            if (node->nameIndexEnabled) {
+                node->RemoveNameIndexEntry(name, *this);
+                if (!_name.empty()) {
+                    node->AddNameIndexEntry(_name, *this);
+                }
+            }
+        }
+        name = _name;
+    }
+
     void Spatial::SetTransparance(float inAlpha)
     {
         assert(alpha >= 0.0f && alpha <= 1.0f);
@@ -61,6 +86,11 @@ namespace astu::suite2d {
         UpdateTransform(dt);
     }
 
+    bool Spatial::CanUpdateConcurrently() const
+    {
+        return parallelUpdate && HasOnlyThreadSafeControllers();
+    }
+
     void Spatial::UpdateTransform(double dt)
     {
         UpdateControllers(dt);
@@ -76,10 +106,45 @@ namespace astu::suite2d {
     /////// Node
     /////////////////////////////////////////////////
 
+    /** The positions of a spatial within the name indices of its ancestors. */
+    using NameIndexSlots = std::vector<std::pair<const Node*, size_t>>;
+
+    /**
+     * Returns the position of a spatial within the name index of a node.
+     */
+    static NameIndexSlots::iterator FindNameIndexSlot(NameIndexSlots & slots, const Node* node)
+    {
+        // A spatial is only indexed by its ancestors, hence there are
+        // hardly ever more than a few slots.
+        auto it = std::find_if(slots.begin(), slots.end(), 
+            [node](const auto & slot) { return slot.first == node; });
+        assert(it != slots.end());
+        return it;
+    }
+
+    Node::Node()
+        : numVacantSlots(0)
+        , nameIndexEnabled(false)
+    {
+        // Intentionally left empty.
+    }
+
+    Node::~Node()
+    {
+        // Descendants might outlive this node and must not keep their
+        // positions within its name index.
+        EnableNameIndex(false);
+    }
+
     std::shared_ptr<Spatial> Node::FindChildOrNull(const std::string & childName)
     {
+        if (nameIndexEnabled) {
+            auto it = nameIndex.find(childName);
+            return it != nameIndex.end() ? it->second.front()->weak_from_this().lock() : nullptr;
+        }
+
         for(auto & child : children) {
-            if (child->GetName() == childName) {
+            if (child && child->GetName() == childName) {
                 return child;
             }
         }
@@ -87,7 +152,7 @@ namespace astu::suite2d {
         for(auto & child : children) {
             auto node = std::dynamic_pointer_cast<Node>(child);
             if (node) {
-                auto result = node->FindChild(childName);
+                auto result = node->FindChildOrNull(childName);
                 if (result) {
                     return result;
                 }
@@ -111,7 +176,7 @@ namespace astu::suite2d {
 
     bool Node::HasChild(std::shared_ptr<Spatial> child)
     {
-        return find(children.begin(), children.end(), child) != children.end();
+        return child && child->parent == this;
     }
 
     void Node::AttachChild(std::shared_ptr<Spatial> child)
@@ -120,7 +185,14 @@ namespace astu::suite2d {
         assert(!HasChild(child));
 
         child->SetParent(this);
+        child->childIndex = children.size();
         children.push_back(child);
+
+        for (Node* node = this; node; node = node->parent) {
+            if (node->nameIndexEnabled) {
+                node->AddToNameIndex(*child);
+            }
+        }
     }
 
     void Node::DetachChild(std::shared_ptr<Spatial> child)
@@ -128,19 +200,143 @@ namespace astu::suite2d {
         assert(HasChild(child));
         assert(child->GetParent() == this);
 
-        children.erase(
-            std::remove(children.begin(), children.end(), child), 
-            children.end());
+        for (Node* node = this; node; node = node->parent) {
+            if (node->nameIndexEnabled) {
+                node->RemoveFromNameIndex(*child);
+            }
+        }
 
+        assert(children[child->childIndex] == child);
+        children[child->childIndex] = nullptr;
         child->SetParent(nullptr);
+
+        // Vacant slots are removed lazily to keep detaching in constant
+        // (amortized) time while preserving the order of the children.
+        if (++numVacantSlots > children.size() / 2) {
+            CompactChildren();
+        }
+    }
+
+    void Node::CompactChildren()
+    {
+        size_t cnt = 0;
+        for (size_t i = 0; i < children.size(); ++i) {
+            if (children[i]) {
+                children[i]->childIndex = cnt;
+                children[cnt++] = std::move(children[i]);
+            }
+        }
+        children.resize(cnt);
+        numVacantSlots = 0;
     }
 
     void Node::DetachAll()
     {
         for (auto & child : children) {
+            if (!child) {
+                continue;
+            }
+            for (Node* node = this; node; node = node->parent) {
+                if (node->nameIndexEnabled) {
+                    node->RemoveFromNameIndex(*child);
+                }
+            }
             child->SetParent(nullptr);
         }
         children.clear();
+        numVacantSlots = 0;
+    }
+
+    void Node::EnableNameIndex(bool b)
+    {
+        if (nameIndexEnabled == b) {
+            return;
+        }
+
+        for (auto & entry : nameIndex) {
+            for (auto spatial : entry.second) {
+                auto & slots = spatial->nameIndexSlots;
+                *FindNameIndexSlot(slots, this) = slots.back();
+                slots.pop_back();
+            }
+        }
+
+        nameIndexEnabled = b;
+        nameIndex.clear();
+        if (nameIndexEnabled) {
+            for (auto & child : children) {
+                if (child) {
+                    AddToNameIndex(*child);
+                }
+            }
+        }
+    }
+
+    void Node::AddToNameIndex(Spatial& spatial)
+    {
+        if (!spatial.name.empty()) {
+            AddNameIndexEntry(spatial.name, spatial);
+        }
+
+        auto node = dynamic_cast<Node*>(&spatial);
+        if (node) {
+            for (auto & child : node->children) {
+                if (child) {
+                    AddToNameIndex(*child);
+                }
+            }
+        }
+    }
+
+    void Node::RemoveFromNameIndex(Spatial& spatial)
+    {
+        RemoveNameIndexEntry(spatial.name, spatial);
+
+        auto node = dynamic_cast<Node*>(&spatial);
+        if (node) {
+            for (auto & child : node->children) {
+                if (child) {
+                    RemoveFromNameIndex(*child);
+                }
+            }
+        }
+    }
+
+    void Node::AddNameIndexEntry(const std::string& name, Spatial& spatial)
+    {
+        auto & entries = nameIndex[name];
+        spatial.nameIndexSlots.emplace_back(this, entries.size());
+        entries.push_back(&spatial);
+    }
+
+    void Node::RemoveNameIndexEntry(const std::string& name, Spatial& spatial)
+    {
+        if (name.empty()) {
+            return;
+        }
+
+        auto it = nameIndex.find(name);
+        assert(it != nameIndex.end());
+        auto & entries = it->second;
+
+        auto & slots = spatial.nameIndexSlots;
+        auto slot = FindNameIndexSlot(slots, this);
+        const size_t pos = slot->second;
+        assert(entries[pos] == &spatial);
+        *slot = slots.back();
+        slots.pop_back();
+
+        // The last entry takes the place of the removed one.
+        Spatial* last = entries.back();
+        entries.pop_back();
+        if (last != &spatial) {
+            entries[pos] = last;
+            FindNameIndexSlot(last->nameIndexSlots, this)->second = pos;
+        }
+
+        if (entries.empty()) {
+            nameIndex.erase(it);
+        }
     }
 
     void Node::UpdateTransform(double dt)
@@ -148,14 +344,57 @@ namespace astu::suite2d {
         Spatial::UpdateTransform(dt);
 
         for (auto & child : children) {
-            child->UpdateTransform(dt);
+            if (child) {
+                child->UpdateTransform(dt);
+            }
         }
     }
 
+    bool Node::CanUpdateConcurrently() const
+    {
+        if (!Spatial::CanUpdateConcurrently()) {
+            return false;
+        }
+
+        for (const auto & child : children) {
+            if (child && !child->CanUpdateConcurrently()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Node::UpdateParallel(double dt, ThreadPool& pool)
+    {
+        Spatial::UpdateTransform(dt);
+
+        concurrentChildren.clear();
+        for (auto & child : children) {
+            if (!child) {
+                continue;
+            }
+
+            if (child->CanUpdateConcurrently()) {
+                concurrentChildren.push_back(child.get());
+            } else {
+                child->UpdateTransform(dt);
+            }
+        }
+
+        pool.ParallelFor(0, concurrentChildren.size(), 
+            [this, dt](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    concurrentChildren[i]->UpdateTransform(dt);
+                }
+            }, MIN_CHILDREN_PER_TASK);
+    }
+
     void Node::Render(SceneRenderer2D& renderer, float alpha)
     {
-        for (auto child : children) {
-            child->Render(renderer, alpha * child->GetTransparency());
+        for (auto & child : children) {
+            if (child) {
+                child->Render(renderer, alpha * child->GetTransparency());
+            }
         }
     }
 
@@ -164,7 +403,9 @@ namespace astu::suite2d {
         auto result = make_shared<Node>();
 
         for (const auto & child : children) {
-            result->AttachChild( child->Clone() );
+            if (child) {
+                result->AttachChild( child->Clone() );
+            }
         }
         return result;
     }
@@ -0,0 +1,181 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+// Local includes
+#include "SuiteSDL/SdlImageLayer.h"
+
+// Simple Direct Layer (SDL) includes
+#include <SDL2/SDL.h>
+
+// C++ Standard Library includes
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace astu {
+
+    SdlImageLayer::SdlImageLayer(int renderPriority)
+        : Service("SDL Image Layer")
+        , SdlRenderLayer(renderPriority)
+        , texture(nullptr)
+        , textureWidth(0)
+        , textureHeight(0)
+        , hasImage(false)
+        , stretch(true)
+        , blending(false)
+    {
+        // Intentionally left empty.
+    }
+
+    SdlImageLayer::~SdlImageLayer()
+    {
+        DestroyTexture();
+    }
+
+    void SdlImageLayer::SetImage(const Image & image)
+    {
+        const int w = image.GetWidth();
+        Update(w, image.GetHeight(), [&image, w](int y, Rgba8* dst) {
+            ConvertPixels(image.GetPixels() + static_cast<size_t>(y) * w, dst, w);
+        });
+    }
+
+    void SdlImageLayer::SetImage(const ImageRgba8 & image)
+    {
+        SetPixels(image.GetPixels(), image.GetWidth(), image.GetHeight());
+    }
+
+    void SdlImageLayer::SetPixels(const Rgba8* pixels, int width, int height)
+    {
+        if (width <= 0 || height <= 0) {
+            throw std::domain_error("Invalid image dimensions, got "
+                + std::to_string(width) + "x" + std::to_string(height));
+        }
+
+        Update(width, height, [pixels, width](int y, Rgba8* dst) {
+            std::memcpy(dst, pixels + static_cast<size_t>(y) * width, width * sizeof(Rgba8));
+        });
+    }
+
+    void SdlImageLayer::Clear()
+    {
+        hasImage = false;
+        staging = nullptr;
+    }
+
+    void SdlImageLayer::SetBlending(bool b)
+    {
+        blending = b;
+        if (texture) {
+            SDL_SetTextureBlendMode(texture, blending ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+        }
+    }
+
+    void SdlImageLayer::Update(int width, int height, const RowConverter & convert)
+    {
+        hasImage = true;
+
+        // Once the texture exists, images are converted straight into the
+        // locked texture memory without any intermediate copy.
+        if (texture && width == textureWidth && height == textureHeight) {
+            void* pixels;
+            int pitch;
+            if (SDL_LockTexture(texture, nullptr, &pixels, &pitch) == 0) {
+                staging = nullptr;
+                for (int y = 0; y < height; ++y) {
+                    convert(y, reinterpret_cast<Rgba8*>(static_cast<uint8_t*>(pixels) + y * pitch));
+                }
+                SDL_UnlockTexture(texture);
+                return;
+            }
+
+            SDL_LogError(SDL_LOG_CATEGORY_RENDER,
+                "Couldn't lock SDL texture: %s", SDL_GetError());
+        }
+
+        if (!staging || staging->GetWidth() != width || staging->GetHeight() != height) {
+            staging = std::make_unique<ImageRgba8>(width, height);
+        }
+
+        for (int y = 0; y < height; ++y) {
+            convert(y, staging->GetRow(y));
+        }
+    }
+
+    void SdlImageLayer::UploadStaging(SDL_Renderer* renderer)
+    {
+        const int w = staging->GetWidth();
+        const int h = staging->GetHeight();
+
+        if (!texture || w != textureWidth || h != textureHeight) {
+            DestroyTexture();
+
+            // Rgba8 stores the components byte by byte in this order.
+            texture = SDL_CreateTexture(
+                renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, w, h);
+
+            if (!texture) {
+                SDL_LogError(SDL_LOG_CATEGORY_RENDER,
+                    "Couldn't create SDL texture: %s", SDL_GetError());
+                throw std::runtime_error(SDL_GetError());
+            }
+            textureWidth = w;
+            textureHeight = h;
+            SDL_SetTextureBlendMode(texture, blending ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+        }
+
+        if (SDL_UpdateTexture(texture, nullptr, staging->GetPixels(),
+            static_cast<int>(staging->GetRowSize())))
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_RENDER,
+                "Couldn't update SDL texture: %s", SDL_GetError());
+            return;
+        }
+        staging = nullptr;
+    }
+
+    void SdlImageLayer::DestroyTexture()
+    {
+        if (texture) {
+            SDL_DestroyTexture(texture);
+            texture = nullptr;
+            textureWidth = 0;
+            textureHeight = 0;
+        }
+    }
+
+    void SdlImageLayer::OnRender(SDL_Renderer* renderer)
+    {
+        if (!hasImage) {
+            return;
+        }
+
+        if (staging) {
+            UploadStaging(renderer);
+        }
+
+        if (stretch) {
+            SDL_RenderCopy(renderer, texture, nullptr, nullptr);
+        } else {
+            SDL_Rect dst = {0, 0, textureWidth, textureHeight};
+            SDL_RenderCopy(renderer, texture, nullptr, &dst);
+        }
+    }
+
+    void SdlImageLayer::OnStartup()
+    {
+        // Intentionally left empty.
+    }
+
+    void SdlImageLayer::OnShutdown()
+    {
+        DestroyTexture();
+        staging = nullptr;
+        hasImage = false;
+    }
+
+} // end of namespace
@@ -12,6 +12,9 @@
 #include "AstuServices.h"
 
 // C++ Standard Library includes
+#include <filesystem>
+#include <stdexcept>
+#include <iostream>
 #include <sstream>
 #include <iomanip>
 
@@ -29,15 +32,43 @@ namespace astu {
     /////// SdlRecordingSceneRenderer2D
     /////////////////////////////////////////////////
 
-    SdlRecordingSceneRenderer2D::SdlRecordingSceneRenderer2D()
-        : curFrame(nullptr)
+    SdlRecordingSceneRenderer2D::SdlRecordingSceneRenderer2D(
+        const std::string& outputDirectory,
+        double frameRate,
+        size_t numWorkers,
+        size_t maxPendingFrames)
+        : outputDirectory(outputDirectory)
+        , fileExtension("bmp")
+        , compressionLevel(6)
+        , frameDuration(1.0 / frameRate)
+        , nextFrameTime(-1)
+        , frameCnt(0)
+        , frames(std::make_shared<vector<Frame>>())
+        , curFrame(nullptr)
+        , workers(numWorkers)
+        , maxPendingFrames(maxPendingFrames)
     {
-        // Intentionally left empty.
+        if (frameRate <= 0) {
+            throw std::domain_error("Frame rate must be greater zero, got " 
+                + std::to_string(frameRate));
+        }
+
+        if (this->maxPendingFrames == 0) {
+            this->maxPendingFrames = workers.GetNumThreads() * 2;
+        }
     }
 
     SdlRecordingSceneRenderer2D::~SdlRecordingSceneRenderer2D()
     {
-        RenderFrames();
+        try {
+            SubmitFrames();
+            WaitForPendingFrames();
+            if (frameSink) {
+                frameSink->Close();
+            }
+        } catch (const std::exception& e) {
+            cerr << "Unable to store recorded frames: " << e.what() << endl;
+        }
     }
 
     void SdlRecordingSceneRenderer2D::Render(Polyline& polyline, float alpha)
@@ -46,9 +77,14 @@ namespace astu {
         SdlSceneRenderer2D::Render(polyline, alpha);            
 
         const auto & vertices = VBUF(polyline.GetVertexBuffer()).vertices;
+        if (vertices.size() < 2) {
+            return;
+        }
+
         const auto & tx = viewMatrix * polyline.GetWorldMatrix();
         auto it = vertices.cbegin();
-        auto p1 = tx.TransformPoint(*it);
+        const auto first = tx.TransformPoint(*it);
+        auto p1 = first;
 
         auto c = polyline.GetColor() * alpha;
         while (++it != vertices.cend()) {
@@ -56,12 +92,25 @@ namespace astu {
             curFrame->lines.push_back(Line(c, p1, p2));
             p1 = p2;
         }
+
+        if (polyline.IsClosed()) {
+            curFrame->lines.push_back(Line(c, p1, first));
+        }
     }
 
     void SdlRecordingSceneRenderer2D::BeginFrame(double time)
     {
-        frames.push_back(Frame(time));
-        curFrame = &frames.back();      
+        if (nextFrameTime < 0) {
+            nextFrameTime = time + frameDuration;
+        } else if (time >= nextFrameTime) {
+            SubmitFrames();
+            while (time >= nextFrameTime) {
+                nextFrameTime += frameDuration;
+            }
+        }
+
+        frames->push_back(Frame(time));
+        curFrame = &frames->back();      
     }
 
     void SdlRecordingSceneRenderer2D::EndFrame()
@@ -69,84 +118,135 @@ namespace astu {
         curFrame = nullptr;
     }
 
-    void SdlRecordingSceneRenderer2D::RenderFrames(double frameRate)
+    void SdlRecordingSceneRenderer2D::WaitForPendingFrames()
     {
-        string filepath = "/media/roman/Volume/Temp/breakout/frame";        
-        cout << "Rendering #" << frames.size() << " frames" << endl;
-
-        double duration = 1.0 / frameRate;
-        double time = 0.0;
-        int frameCnt = 0;
-       
-        vector<Frame*> oneFrame;
-        time += duration;
-        for (auto& frame : frames) {
-            if (frame.timeStamp < time) {
-                oneFrame.push_back(&frame);
-            } else if (!oneFrame.empty()){
-                std::stringstream ss;
-                ss << filepath << std::setw(4) << std::setfill('0') 
-                    << frameCnt << ".bmp";
-
-                RenderFrame(++frameCnt, oneFrame, ss.str());
-                oneFrame.clear();
-                time += duration;
-            }
+        while (!pendingFrames.empty()) {
+            FinishOldestFrame();
         }
-
-        // for (size_t i = 0; i < frames.size(); ++i) {
-        //     std::stringstream ss;
-        //     ss << filepath << std::setw(4) << std::setfill('0') << i << ".bmp";
-
-        //     RenderFrame(frames[i], i, ss.str());
-        // }
     }
 
-    void SdlRecordingSceneRenderer2D::RenderFrame(int cnt, std::vector<Frame*>& oneFrame, const std::string& filename)
+    void SdlRecordingSceneRenderer2D::FinishOldestFrame()
     {
-        ImageRenderer imgRndr;
+        auto f = std::move(pendingFrames.front());
+        pendingFrames.pop_front();
+        f.done.get();
+
+        // Frames are finished in submission order, which keeps the
+        // sequence passed to the sink in order.
+        if (f.image) {
+            frameSink->WriteFrame(*f.image);
+        }
+    }
 
-        auto bgCol = TO_COLOR4D(ASTU_SERVICE(RenderService).GetBackgroundColor());
-        imgRndr.SetBackgroundColor(bgCol);
+    void SdlRecordingSceneRenderer2D::SetFrameSink(std::unique_ptr<FrameSink> sink)
+    {
+        WaitForPendingFrames();
+        if (frameSink) {
+            auto oldSink = std::move(frameSink);
+            oldSink->Close();
+        }
 
-        for( auto pFrame : oneFrame) {
-            for (const auto& line : pFrame->lines) {
-                imgRndr.SetDrawColor(TO_COLOR4D(Color4f(line.color).SetAlpha(1.0f / oneFrame.size())));
-                imgRndr.DrawLine(TO_VEC2D(line.p0), TO_VEC2D(line.p1), 2);
-            }
+        if (sink) {
+            frameSink = std::make_unique<AsyncFrameSink>(std::move(sink), maxPendingFrames);
         }
+    }
 
-        auto& wndSrv = ASTU_SERVICE(WindowService);
-        Image image(wndSrv.GetWidth(), wndSrv.GetHeight());
-        imgRndr.SetRenderQuality(RenderQuality::Good);
-        cout << "Rendering frame #" << cnt << " (" << oneFrame.size() << ") :" << filename << endl;
-        imgRndr.Render(image);
+    void SdlRecordingSceneRenderer2D::SetFileExtension(const std::string& extension)
+    {
+        if (extension.empty()) {
+            throw std::domain_error("File extension must not be empty");
+        }
+        fileExtension = extension;
+    }
 
-        StoreImage(image, filename);
+    void SdlRecordingSceneRenderer2D::SetCompressionLevel(int level)
+    {
+        if (level < 0 || level > 9) {
+            throw std::domain_error("Compression level must be within [0, 9], got "
+                + std::to_string(level));
+        }
+        compressionLevel = level;
     }
 
-    // void SdlRecordingSceneRenderer2D::RenderFrame(const Frame& frame, size_t cnt, const std::string& filename)
-    // {
-    //     ImageRenderer imgRndr;
+    void SdlRecordingSceneRenderer2D::SubmitFrames()
+    {
+        if (frames->empty()) {
+            return;
+        }
+
+        // Pass finished frames on and apply backpressure in case the 
+        // workers cannot keep up.
+        while (!pendingFrames.empty() && (pendingFrames.size() >= maxPendingFrames
+            || pendingFrames.front().done.wait_for(std::chrono::seconds(0)) == std::future_status::ready)) 
+        {
+            FinishOldestFrame();
+        }
 
-    //     auto bgCol = TO_COLOR4D(ASTU_SERVICE(RenderService).GetBackgroundColor());
-    //     imgRndr.SetBackgroundColor(bgCol);
+        std::stringstream ss;
+        ss << "frame" << std::setw(4) << std::setfill('0') << frameCnt++ << "." << fileExtension;
+        const string filename = 
+            (std::filesystem::path(outputDirectory) / ss.str()).string();
 
+        // Services must not be accessed from worker threads.
+        auto bgColor = TO_COLOR4D(ASTU_SERVICE(RenderService).GetBackgroundColor());
+        auto& wndSrv = ASTU_SERVICE(WindowService);
+        const int width = wndSrv.GetWidth();
+        const int height = wndSrv.GetHeight();
+
+        auto oneFrame = frames;
+        const int level = compressionLevel;
+        auto target = frameSink ? std::make_shared<ImageRgba8>(width, height) : nullptr;
+        auto done = workers.Submit(
+            [oneFrame, bgColor, width, height, filename, level, target]() {
+                Image image(width, height);
+                RenderFrame(*oneFrame, bgColor, image);
+                if (target) {
+                    ConvertImage(image, *target);
+                } else {
+                    StoreImage(image, filename, level);
+                }
+            });
+        pendingFrames.push_back({std::move(done), target});
+
+        frames = std::make_shared<vector<Frame>>();
+        curFrame = nullptr;
+    }
 
-    //     for (const auto& line : frame) {
-    //         imgRndr.SetDrawColor(TO_COLOR4D(line.color));
-    //         imgRndr.DrawLine(TO_VEC2D(line.p0), TO_VEC2D(line.p1), 2);
-    //     }
-        
-    //     auto& wndSrv = ASTU_SERVICE(WindowService);
-    //     Image image(wndSrv.GetWidth(), wndSrv.GetHeight());
-    //     imgRndr.SetRenderQuality(RenderQuality::Good);
-    //     cout << "Rendering frame #" << cnt << " (" << filename << ")" << endl;
-    //     imgRndr.Render(image);
+    void SdlRecordingSceneRenderer2D::RenderFrame(
+        const std::vector<Frame>& oneFrame, 
+        const Color4d& bgColor, 
+        Image& image)
+    {
+        // Frames are already rendered concurrently by the workers.
+        ImageRenderer imgRndr;
+        imgRndr.SetNumThreads(1);
+        imgRndr.SetBackgroundColor(bgColor);
+        imgRndr.SetRenderQuality(RenderQuality::Good);
 
-    //     StoreImage(image, filename);
-    // }
+        auto drawLines = [&imgRndr](const Frame& frame) {
+            for (const auto& line : frame.lines) {
+                imgRndr.SetDrawColor(TO_COLOR4D(Color4f(line.color).SetAlpha(1.0f)));
+                imgRndr.DrawLine(TO_VEC2D(line.p0), TO_VEC2D(line.p1), 2);
+            }
+        };
 
+        if (oneFrame.size() == 1) {
+            drawLines(oneFrame.front());
+            imgRndr.Render(image);
+            return;
+        }
 
+        // Each recorded frame is rendered on its own and the results are
+        // averaged (motion blur). This keeps the quadtree of the renderer
+        // small and the cost proportional to pixels times frames.
+        AccumulationBuffer accu(image.GetWidth(), image.GetHeight());
+        for (const auto& frame : oneFrame) {
+            imgRndr.Clear();
+            drawLines(frame);
+            imgRndr.Render(image);
+            accu.Add(image);
+        }
+        accu.Resolve(image);
+    }
 
-} // end of namespace
+} // end of namespace
\ No newline at end of file
@@ -9,8 +9,15 @@
 
 // Local includes
 #include "SuiteSDL/SdlSceneRenderer2D.h"
+#include "Graphics/Color.h"
+#include "Graphics/FrameSink.h"
+#include "Util/ThreadPool.h"
 
 // C++ Standard libraries includes
+#include <deque>
+#include <future>
+#include <memory>
+#include <string>
 #include <vector>
 
 
@@ -19,19 +26,108 @@ struct SDL_Renderer;
 
 namespace astu {
 
+    /**
+     * A scene renderer which additionally records the rendered lines and
+     * writes high-quality images of the recorded frames to disk.
+     * 
+     * All frames rendered within the duration of one output frame are
+     * combined into a single image (motion blur). Finished output frames are
+     * rendered and stored by a pool of worker threads while recording
+     * continues. The number of pending output frames is bounded, if the
+     * workers cannot keep up, recording blocks until a worker has finished.
+     * 
+     * By default, each output frame is stored as an individual image file.
+     * Alternatively, the output frames can be passed to a frame sink, e.g.,
+     * a Y4M or AVI writer, which produces a single file that can be fed
+     * to a video encoder.
+     */
     class SdlRecordingSceneRenderer2D : public SdlSceneRenderer2D {
     public:
 
         /**
          * Constructor.
+         * 
+         * @param outputDirectory   the directory where to store the frames
+         * @param frameRate         the number of output frames per second
+         * @param numWorkers        the number of worker threads, zero selects
+         *                          the number of hardware threads
+         * @param maxPendingFrames  the maximum number of output frames
+         *                          waiting to be rendered, zero selects twice
+         *                          the number of worker threads
          */
-        SdlRecordingSceneRenderer2D();
+        SdlRecordingSceneRenderer2D(
+            const std::string& outputDirectory = ".",
+            double frameRate = 25,
+            size_t numWorkers = 0,
+            size_t maxPendingFrames = 0);
 
         /**
          * virtual Destructor.
+         * 
+         * Submits the last output frame and waits for all pending frames
+         * to be written.
          */
         virtual ~SdlRecordingSceneRenderer2D();
 
+        /**
+         * Waits until all pending output frames have been written.
+         * 
+         * @throws std::runtime_error in case a frame could not be stored
+         */
+        void WaitForPendingFrames();
+
+        /**
+         * Sets a sink which receives the output frames instead of storing 
+         * them as individual image files.
+         * 
+         * The frames are passed to the sink in order by a background 
+         * thread, hence writing overlaps with rendering and recording. The
+         * sink gets closed when this renderer is destroyed or another sink
+         * is set. Passing `nullptr` restores storing image files.
+         * 
+         * @param sink  the sink which receives the output frames
+         * @throws std::runtime_error in case pending frames of the previous
+         *      sink could not be written
+         */
+        void SetFrameSink(std::unique_ptr<FrameSink> sink);
+
+        /**
+         * Sets the file format of the output frames.
+         * 
+         * The format is selected by its file extension, e.g., "bmp", 
+         * "png" or "qoi". The default format is "bmp".
+         * 
+         * @param extension the file extension without leading dot
+         * @throws std::domain_error in case the extension is empty
+         */
+        void SetFileExtension(const std::string& extension);
+
+        /**
+         * Returns the file extension of the output frames.
+         * 
+         * @return the file extension without leading dot
+         */
+        const std::string& GetFileExtension() const {
+            return fileExtension;
+        }
+
+        /**
+         * Sets the compression level used for compressed output formats.
+         * 
+         * @param level the compression level within the range [0, 9]
+         * @throws std::domain_error in case the level is invalid
+         */
+        void SetCompressionLevel(int level);
+
+        /**
+         * Returns the compression level used for compressed output formats.
+         * 
+         * @return the compression level
+         */
+        int GetCompressionLevel() const {
+            return compressionLevel;
+        }
+
         // Inherited via Scene2Renderer
         virtual void Render(suite2d::Polyline& polyline, float alpha) override;
 
@@ -54,12 +150,56 @@ namespace astu {
             Frame(double t) : timeStamp(t) {}
         };
 
-        std::vector<Frame> frames;
+        /** The directory where to store the output frames. */
+        std::string outputDirectory;
+
+        /** The file extension, which selects the format of output frames. */
+        std::string fileExtension;
+
+        /** The compression level used for compressed output formats. */
+        int compressionLevel;
+
+        /** The duration of one output frame in seconds. */
+        double frameDuration;
+
+        /** The time at which the current output frame ends. */
+        double nextFrameTime;
+
+        /** The number of output frames submitted so far. */
+        int frameCnt;
+
+        /** The recorded frames which make up the current output frame. */
+        std::shared_ptr<std::vector<Frame>> frames;
+
+        /** The frame currently being recorded. */
         Frame *curFrame;
 
-        void RenderFrames(double frameRate = 25);
-        void RenderFrame(int cnt, std::vector<Frame*>&, const std::string& filename);
-        // void RenderFrame(const Frame& frame, size_t cnt, const std::string& filename);
+        /** The worker threads used to render and store output frames. */
+        ThreadPool workers;
+
+        /** The maximum number of pending output frames. */
+        size_t maxPendingFrames;
+
+        struct PendingFrame {
+            /** Becomes ready once the worker has finished the frame. */
+            std::future<void> done;
+
+            /** Receives the rendered frame if a frame sink is used. */
+            std::shared_ptr<ImageRgba8> image;
+        };
+
+        /** The output frames currently rendered by the workers. */
+        std::deque<PendingFrame> pendingFrames;
+
+        /** The optional sink which receives the output frames. */
+        std::unique_ptr<AsyncFrameSink> frameSink;
+
+        void SubmitFrames();
+        void FinishOldestFrame();
+        static void RenderFrame(
+            const std::vector<Frame>& oneFrame, 
+            const Color4d& bgColor, 
+            Image& image);
     };
 
 } // end of namespace
\ No newline at end of file
@@ -90,9 +90,22 @@ namespace astu {
         sceneRenderer->ClearSdlRenderer();
     }
 
+    void SdlSceneGraph2D::EnableParallelUpdate(bool b, size_t numThreads)
+    {
+        if (b) {
+            threadPool = std::make_unique<ThreadPool>(numThreads);
+        } else {
+            threadPool = nullptr;
+        }
+    }
+
     void SdlSceneGraph2D::OnUpdate()
     {
-        GetRoot()->Update( GetElapsedTime() );
+        if (threadPool) {
+            GetRoot()->UpdateParallel(GetElapsedTime(), *threadPool);
+        } else {
+            GetRoot()->Update( GetElapsedTime() );
+        }
     }
 
     void SdlSceneGraph2D::OnStartup()
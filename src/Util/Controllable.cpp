@@ -54,6 +54,16 @@ namespace astu {
         controllers.clear();
     }
 
+    bool Controllable::HasOnlyThreadSafeControllers() const
+    {
+        for (const auto & ctrl : controllers) {
+            if (!ctrl->IsThreadSafe()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     void Controllable::UpdateControllers(double dt)
     {
         for (const auto & ctrl : controllers) {
@@ -0,0 +1,122 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ * 
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+// Local includes
+#include "Util/ThreadPool.h"
+
+// C++ Standard Library includes
+#include <algorithm>
+
+using namespace std;
+
+namespace astu {
+
+    ThreadPool::ThreadPool(size_t numThreads)
+        : terminate(false)
+    {
+        if (numThreads == 0) {
+            numThreads = std::max(1u, thread::hardware_concurrency());
+        }
+
+        workers.reserve(numThreads);
+        for (size_t i = 0; i < numThreads; ++i) {
+            workers.emplace_back(&ThreadPool::RunWorker, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            lock_guard<std::mutex> lock(mutex);
+            terminate = true;
+        }
+        condition.notify_all();
+
+        for (auto & worker : workers) {
+            worker.join();
+        }
+    }
+
+    std::future<void> ThreadPool::Submit(std::function<void()> task)
+    {
+        packaged_task<void()> packagedTask(std::move(task));
+        auto result = packagedTask.get_future();
+        {
+            lock_guard<std::mutex> lock(mutex);
+            tasks.push(std::move(packagedTask));
+        }
+        condition.notify_one();
+
+        return result;
+    }
+
+    void ThreadPool::ParallelFor(
+        size_t begin, 
+        size_t end, 
+        const std::function<void(size_t, size_t)>& func, 
+        size_t minChunk)
+    {
+        if (begin >= end) {
+            return;
+        }
+
+        const size_t n = end - begin;
+        const size_t numChunks = std::min(
+            GetNumThreads() + 1, std::max<size_t>(1, n / std::max<size_t>(1, minChunk)));
+        const size_t chunkSize = (n + numChunks - 1) / numChunks;
+
+        vector<future<void>> futures;
+        futures.reserve(numChunks);
+        for (size_t b = begin + chunkSize; b < end; b += chunkSize) {
+            size_t e = std::min(end, b + chunkSize);
+            futures.push_back(Submit([&func, b, e]() { func(b, e); }));
+        }
+
+        // The calling thread processes the first chunk itself.
+        exception_ptr error;
+        try {
+            func(begin, std::min(end, begin + chunkSize));
+        } catch (...) {
+            error = current_exception();
+        }
+
+        for (auto & f : futures) {
+            try {
+                f.get();
+            } catch (...) {
+                if (!error) {
+                    error = current_exception();
+                }
+            }
+        }
+
+        if (error) {
+            rethrow_exception(error);
+        }
+    }
+
+    void ThreadPool::RunWorker()
+    {
+        while (true) {
+            packaged_task<void()> task;
+            {
+                unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this]() { 
+                    return terminate || !tasks.empty(); 
+                });
+
+                if (tasks.empty()) {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+} // end of namespace
@@ -0,0 +1,82 @@
+/*
+ * ASTU - AST Utilities
+ * A collection of Utilities for Applied Software Techniques (AST).
+ *
+ * Copyright (c) 2020, 2021 Roman Divotkey, Nora Loimayr. All rights reserved.
+ */
+
+// Converts all images of a directory concurrently and reports the
+// throughput, e.g., to convert frames recorded by a renderer.
+
+// Local includes
+#include "Graphics/BatchConverter.h"
+
+// C++ Standard Library includes
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace std;
+using namespace astu;
+
+static void PrintUsage(const char* program)
+{
+    cerr << "Usage: " << program << " [options] <input directory> <output directory>" << endl
+         << "Options:" << endl
+         << "  -f <extension>  output format: bmp, png or qoi (default bmp)" << endl
+         << "  -c <level>      PNG compression level within [0, 9] (default 6)" << endl
+         << "  -j <threads>    number of worker threads, 0 for all cores (default 0)" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+    BatchConverter converter;
+    string inputDirectory;
+    string outputDirectory;
+
+    try {
+        int i = 1;
+        for (; i + 1 < argc && argv[i][0] == '-'; i += 2) {
+            if (strcmp(argv[i], "-f") == 0) {
+                converter.SetOutputExtension(argv[i + 1]);
+            } else if (strcmp(argv[i], "-c") == 0) {
+                converter.SetCompressionLevel(stoi(argv[i + 1]));
+            } else if (strcmp(argv[i], "-j") == 0) {
+                converter.SetNumThreads(stoul(argv[i + 1]));
+            } else {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+        }
+
+        if (argc - i != 2) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        inputDirectory = argv[i];
+        outputDirectory = argv[i + 1];
+
+        const auto stats = converter.ConvertDirectory(inputDirectory, outputDirectory);
+        for (const auto & error : stats.errors) {
+            cerr << error << endl;
+        }
+
+        cout << fixed << setprecision(2)
+             << "Converted " << stats.numFrames << " frames";
+        if (stats.numFailed > 0) {
+            cout << ", " << stats.numFailed << " failed";
+        }
+        cout << " in " << stats.seconds << " s" << endl
+             << stats.FramesPerSecond() << " frames/s, "
+             << stats.MegabytesPerSecond() << " MB/s read, "
+             << (stats.seconds > 0 ? stats.bytesWritten / stats.seconds * 1e-6 : 0.0)
+             << " MB/s written" << endl;
+
+        return stats.numFailed > 0 ? 2 : 0;
+    } catch (const std::exception & e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+}